@@ -72,6 +72,7 @@ mac {
         $$PWD/server/tools/MCPToolInputSchema.h \
         $$PWD/server/tools/MCPToolOutputSchema.h \
         $$PWD/server/tools/IMCPToolService.h \
+        $$PWD/server/tools/MCPTypedInvoker.h \
         $$PWD/server/MCPServer_global.h \
         $$PWD/server/IMCPServer.h
     #FRAMEWORK_HEADERS.path = Headers
@@ -382,6 +383,7 @@ linux {
         $$PWD/server/tools/MCPToolInputSchema.h \
         $$PWD/server/tools/MCPToolOutputSchema.h \
         $$PWD/server/tools/IMCPToolService.h \
+        $$PWD/server/tools/MCPTypedInvoker.h \
         $$PWD/server/MCPServer_global.h \
         $$PWD/server/IMCPServer.h
     LIB_INCLUDE_FILES.path = /usr/local/include
@@ -399,6 +401,8 @@ include($$PWD/server/config/config.pri)
 include($$PWD/server/messages/messages.pri)
 include($$PWD/server/transport/transport.pri)
 include($$PWD/server/transport/http/transporthttp.pri)
+linux: include($$PWD/server/transport/epoll/transportepoll.pri)
+include($$PWD/server/transport/stdio/transportstdio.pri)
 include($$PWD/server/session/session.pri)
 include($$PWD/server/routing/routing.pri)
 include($$PWD/server/middleware/middleware.pri)
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: GPLv3
 // ********************************************************************
 #include "mysourcecodehandler.h"
+#include <MCPHelper.h>
 #include <MCPLog.h>
 #include <algorithm>
 #include <QDateTime>
@@ -82,7 +83,11 @@ QJsonObject SourceCodeHandler::displayProjectFiles(const QVariant &project_path,
 
         return QStringLiteral("%1|%2|%3|%4|%5").arg(filePath, size, lastModified, directory, relativePath);
     };
+    const double dTotalFiles = fileList.size();
+    double dDoneFiles = 0;
     foreach (const QFileInfo &fileInfo, fileList) {
+        // No-op unless the client asked for progress; the server throttles the notifications
+        MCPHelper::reportProgress(++dDoneFiles, dTotalFiles);
         jsonFiles.append(fileInfoToJson(fileInfo, strProjectPath));
         textLines.append(toTextLine(fileInfo, strProjectPath));
         directories.insert(fileInfo.path());
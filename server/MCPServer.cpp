@@ -10,15 +10,22 @@
 #include <IMCPResourceService.h>
 #include <IMCPToolService.h>
 #include <IMCPTransport.h>
+#include <MCPAdmissionMiddleware.h>
 #include <MCPContext.h>
+#ifdef Q_OS_LINUX
+#include <MCPEpollTransport.h>
+#endif
 #include <MCPHandlerResolver.h>
 #include <MCPHttpReplyMessage.h>
+#include <MCPHttpRequestParser.h>
 #include <MCPHttpTransportAdapter.h>
 #include <MCPInvokeHelper.h>
 #include <MCPLog.h>
+#include <MCPNotificationScheduler.h>
 #include <MCPPrompt.h>
 #include <MCPPromptService.h>
 #include <MCPPromptsConfig.h>
+#include <MCPRequestDispatcher.h>
 #include <MCPResource.h>
 #include <MCPResourceService.h>
 #include <MCPResourceWrapper.h>
@@ -28,9 +35,12 @@
 #include <MCPServerHandler.h>
 #include <MCPServerMessage.h>
 #include <MCPSessionService.h>
+#include <MCPStdioTransport.h>
 #include <MCPTool.h>
+#include <MCPToolExecutor.h>
 #include <MCPToolService.h>
 #include <MCPToolsConfig.h>
+#include <MCPTrace.h>
 #include <QDir>
 #include <QEventLoop>
 #include <QJsonDocument>
@@ -43,6 +53,8 @@ MCPServer::MCPServer(QObject *pParent)
     : IMCPServer(pParent)
     , m_pTransport(new MCPHttpTransportAdapter(this))
     , m_pSessionService(new MCPSessionService(this))
+    , m_pNotificationScheduler(new MCPNotificationScheduler(this))
+    , m_pToolExecutor(new MCPToolExecutor(this))
     , m_pToolService(new MCPToolService(this))
     , m_pResourceService(new MCPResourceService(this))
     , m_pPromptService(new MCPPromptService(this))
@@ -73,17 +85,26 @@ MCPServer::MCPServer(QObject *pParent)
 
     // Connect transport layer's message received signal to business handler
     QObject::connect(m_pTransport, &IMCPTransport::messageReceived, m_pHandler, &MCPServerHandler::onClientMessageReceived);
-
-    // Connect resource service's signal to business handler (MCPServerHandler internally forwards to corresponding sub-Handler)
-    QObject::connect(m_pResourceService, &MCPResourceService::resourceContentChanged, m_pHandler, &MCPServerHandler::onResourceContentChanged);
-    QObject::connect(m_pResourceService, &MCPResourceService::resourcesListChanged, m_pHandler, &MCPServerHandler::onResourcesListChanged);
-    QObject::connect(m_pResourceService, &MCPResourceService::resourceDeleted, m_pHandler, &MCPServerHandler::onResourceDeleted);
-
-    // Connect tool service's signal to business handler (MCPServerHandler internally forwards to corresponding sub-Handler)
-    QObject::connect(m_pToolService, &MCPToolService::toolsListChanged, m_pHandler, &MCPServerHandler::onToolsListChanged);
-
-    // Connect prompt service's signal to business handler (MCPServerHandler internally forwards to corresponding sub-Handler)
-    QObject::connect(m_pPromptService, &MCPPromptService::promptsListChanged, m_pHandler, &MCPServerHandler::onPromptsListChanged);
+    QObject::connect(m_pTransport, &IMCPTransport::connectionDisconnected, m_pHandler, &MCPServerHandler::onConnectionClosed);
+
+    // Session removed (connection closed, idle timeout or LRU eviction): drop its resource subscriptions
+    QObject::connect(m_pSessionService, &MCPSessionService::sessionRemoved, m_pResourceService, [this](const QString &strSessionId) { m_pResourceService->unsubscribeAll(strSessionId); });
+    QObject::connect(m_pSessionService, &MCPSessionService::sessionRemoved, m_pNotificationScheduler, &MCPNotificationScheduler::onSessionRemoved);
+
+    // Service change signals go through the notification scheduler (coalescing window, per-session rate limit)
+    QObject::connect(m_pResourceService, &MCPResourceService::resourceContentChanged, m_pNotificationScheduler, &MCPNotificationScheduler::onResourceContentChanged);
+    QObject::connect(m_pResourceService, &MCPResourceService::resourcesListChanged, m_pNotificationScheduler, &MCPNotificationScheduler::onResourcesListChanged);
+    QObject::connect(m_pResourceService, &MCPResourceService::resourceDeleted, m_pNotificationScheduler, &MCPNotificationScheduler::onResourceDeleted);
+    QObject::connect(m_pToolService, &MCPToolService::toolsListChanged, m_pNotificationScheduler, &MCPNotificationScheduler::onToolsListChanged);
+    QObject::connect(m_pPromptService, &MCPPromptService::promptsListChanged, m_pNotificationScheduler, &MCPNotificationScheduler::onPromptsListChanged);
+
+    // Connect the scheduler's coalesced signals to business handler (MCPServerHandler internally forwards to corresponding sub-Handler)
+    QObject::connect(m_pNotificationScheduler, &MCPNotificationScheduler::resourceContentChanged, m_pHandler, &MCPServerHandler::onResourceContentChanged);
+    QObject::connect(m_pNotificationScheduler, &MCPNotificationScheduler::resourcesListChanged, m_pHandler, &MCPServerHandler::onResourcesListChanged);
+    QObject::connect(m_pNotificationScheduler, &MCPNotificationScheduler::resourceDeleted, m_pHandler, &MCPServerHandler::onResourceDeleted);
+    QObject::connect(m_pNotificationScheduler, &MCPNotificationScheduler::toolsListChanged, m_pHandler, &MCPServerHandler::onToolsListChanged);
+    QObject::connect(m_pNotificationScheduler, &MCPNotificationScheduler::promptsListChanged, m_pHandler, &MCPServerHandler::onPromptsListChanged);
+    QObject::connect(m_pNotificationScheduler, &MCPNotificationScheduler::deferredNotificationsReady, m_pHandler, &MCPServerHandler::onDeferredNotificationsReady);
 
     // Connect configuration loaded signal to config application slot
     QObject::connect(m_pConfig, &MCPServerConfig::configLoaded, this, &MCPServer::onConfigLoaded);
@@ -159,8 +180,60 @@ MCPSessionService *MCPServer::getSessionService() const
     return m_pSessionService;
 }
 
+MCPNotificationScheduler *MCPServer::getNotificationScheduler() const
+{
+    return m_pNotificationScheduler;
+}
+
+MCPToolExecutor *MCPServer::getToolExecutor() const
+{
+    return m_pToolExecutor;
+}
+
 bool MCPServer::doStart()
 {
+    // Apply HTTP request limits to all parsers created from now on
+    MCPHttpRequestParser::setDefaultLimits(m_pConfig->getMaxHeaderSize(), m_pConfig->getMaxBodySize());
+
+    // Session idle timeout and capacity
+    m_pSessionService->setLimits(m_pConfig->getSessionTimeout(), m_pConfig->getMaxSessions());
+    m_pSessionService->setSseReplay(m_pConfig->getSseReplayBufferSize(), m_pConfig->getSseReplayRetention());
+
+    // Notification coalescing window and per-session push rate
+    m_pNotificationScheduler->setLimits(m_pConfig->getNotificationCoalesceMs(), m_pConfig->getNotificationRateLimit());
+    m_pNotificationScheduler->setProgressInterval(m_pConfig->getProgressIntervalMs());
+
+    // Tool call pool size and queue bound
+    m_pToolExecutor->setLimits(m_pConfig->getToolThreads(), m_pConfig->getToolQueueSize());
+    m_pToolExecutor->setDefaultTimeout(m_pConfig->getToolTimeoutMs());
+    m_pToolService->getResultCache()->setMaxBytes(m_pConfig->getToolCacheSize());
+    m_pToolExecutor->setShedding(m_pConfig->getShedTargetMs(), m_pConfig->getShedIntervalMs());
+
+    // Per-session rate limits and tools/call admission
+    auto pAdmission = m_pHandler->getRequestDispatcher()->getAdmissionMiddleware();
+    pAdmission->setRateLimit(m_pConfig->getRateLimitPerSecond(), m_pConfig->getRateLimitBurst());
+    const auto jsonMethodRateLimits = m_pConfig->getMethodRateLimits();
+    for (auto it = jsonMethodRateLimits.constBegin(); it != jsonMethodRateLimits.constEnd(); ++it) {
+        auto jsonRate = it.value().toObject();
+        pAdmission->setMethodRateLimit(it.key(), jsonRate.value("perSecond").toDouble(0), jsonRate.value("burst").toInt(0));
+    }
+    pAdmission->setMaxInFlightToolCalls(m_pConfig->getMaxInFlightToolCalls());
+
+    // Request tracing, the buffer size first: rings are created by the first span of each thread
+    MCPTrace::setBufferSize(m_pConfig->getTraceBufferSize());
+    MCPTrace::setEnabled(m_pConfig->getTracing());
+
+    // Select transport backend from configuration
+    if (auto pTransport = createTransport()) {
+        setTransport(pTransport);
+    }
+
+    // Optional Unix domain socket next to the TCP port
+    auto strLocalSocket = m_pConfig->getLocalSocket();
+    if (!m_pTransport->setLocalSocketName(strLocalSocket)) {
+        MCP_CORE_LOG_WARNING() << "MCPServer: transport has no local socket support:" << strLocalSocket;
+    }
+
     // Start transport layer
     auto nPort = m_pConfig->getPort();
     if (!m_pTransport->start(nPort)) {
@@ -179,6 +252,49 @@ bool MCPServer::doStop()
     return true;
 }
 
+IMCPTransport *MCPServer::createTransport()
+{
+    const QString strType = m_pConfig->getTransportType();
+#ifdef Q_OS_LINUX
+    if (strType == "epoll") {
+        if (qobject_cast<MCPEpollTransport *>(m_pTransport) != nullptr) {
+            return nullptr;
+        }
+        return new MCPEpollTransport(m_pConfig->getIoThreads(), this);
+    }
+#endif
+    if (strType == "stdio") {
+        if (qobject_cast<MCPStdioTransport *>(m_pTransport) != nullptr) {
+            return nullptr;
+        }
+        return new MCPStdioTransport(m_pConfig->getMaxBodySize(), this);
+    }
+    if (strType != "http") {
+        MCP_CORE_LOG_WARNING() << "MCPServer: unsupported transport:" << strType << ", using http";
+    }
+    // Keep the default HTTP transport created in the constructor
+    return nullptr;
+}
+
+void MCPServer::setTransport(IMCPTransport *pTransport)
+{
+    if (pTransport == m_pTransport) {
+        return;
+    }
+
+    if (m_pTransport != nullptr) {
+        m_pTransport->stop();
+        m_pTransport->disconnect(this);
+        m_pTransport->disconnect(m_pHandler);
+        m_pTransport->deleteLater();
+    }
+
+    m_pTransport = pTransport;
+    QObject::connect(m_pTransport, &IMCPTransport::messageReceived, m_pHandler, &MCPServerHandler::onClientMessageReceived);
+    QObject::connect(m_pTransport, &IMCPTransport::connectionDisconnected, m_pHandler, &MCPServerHandler::onConnectionClosed);
+    m_pHandler->setTransport(m_pTransport);
+}
+
 bool MCPServer::initServer(QSharedPointer<MCPToolsConfig> pToolsConfig, QSharedPointer<MCPResourcesConfig> pResourcesConfig, QSharedPointer<MCPPromptsConfig> pPromptsConfig)
 {
     Q_UNUSED(pResourcesConfig);
@@ -11,6 +11,8 @@
 class MCPAbstractServerTransport;
 class MCPMessage;
 class MCPSessionService;
+class MCPNotificationScheduler;
+class MCPToolExecutor;
 class IMCPTransport;
 class MCPThreadPool;
 class MCPServerMessage;
@@ -94,6 +96,8 @@ public:
 public:
     IMCPTransport *getTransport() const;
     MCPSessionService *getSessionService() const;
+    MCPNotificationScheduler *getNotificationScheduler() const;
+    MCPToolExecutor *getToolExecutor() const;
 
 private slots:
     void onThreadReady();
@@ -103,10 +107,14 @@ private:
     bool initServer(QSharedPointer<MCPToolsConfig> pToolsConfig, QSharedPointer<MCPResourcesConfig> pResourcesConfig, QSharedPointer<MCPPromptsConfig> pPromptsConfig);
     bool doStart();
     bool doStop();
+    IMCPTransport *createTransport();
+    void setTransport(IMCPTransport *pTransport);
 
 private:
     IMCPTransport *m_pTransport;
     MCPSessionService *m_pSessionService;
+    MCPNotificationScheduler *m_pNotificationScheduler;
+    MCPToolExecutor *m_pToolExecutor;
     MCPToolService *m_pToolService;
     MCPResourceService *m_pResourceService;
     MCPPromptService *m_pPromptService;
@@ -6,6 +6,7 @@
  * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
  */
 #include <IMCPTransport.h>
+#include <MCPAdmissionMiddleware.h>
 #include <MCPClientMessage.h>
 #include <MCPContext.h>
 #include <MCPHttpReplyMessage.h>
@@ -13,6 +14,7 @@
 #include <MCPMessage.h>
 #include <MCPMessageSender.h>
 #include <MCPMessageType.h>
+#include <MCPMetrics.h>
 #include <MCPPendingNotification.h>
 #include <MCPPromptNotificationHandler.h>
 #include <MCPPromptService.h>
@@ -25,9 +27,13 @@
 #include <MCPServerMessage.h>
 #include <MCPSession.h>
 #include <MCPSessionService.h>
+#include <MCPToolExecutor.h>
 #include <MCPToolNotificationHandler.h>
+#include <MCPToolResultCache.h>
 #include <MCPToolService.h>
+#include <MCPTrace.h>
 #include <QJsonArray>
+#include <QJsonDocument>
 
 MCPServerHandler::MCPServerHandler(MCPServer *pServer, QObject *pParent)
     : QObject(pParent)
@@ -46,6 +52,7 @@ MCPServerHandler::MCPServerHandler(MCPServer *pServer, QObject *pParent)
 
     // Connect request dispatcher's server message signal to this Handler
     QObject::connect(m_pRequestDispatcher, &MCPRequestDispatcher::serverMessageReceived, this, &MCPServerHandler::onServerMessageReceived);
+    QObject::connect(m_pRequestDispatcher, &MCPRequestDispatcher::progressNotification, this, &MCPServerHandler::onProgressNotification);
 
     // Create various notification handlers
     m_pResourceNotificationHandler = new MCPResourceNotificationHandler(pServer, this);
@@ -56,6 +63,9 @@ MCPServerHandler::MCPServerHandler(MCPServer *pServer, QObject *pParent)
     QObject::connect(m_pResourceNotificationHandler, &MCPNotificationHandlerBase::notificationRequested, this, &MCPServerHandler::onNotificationRequested);
     QObject::connect(m_pToolNotificationHandler, &MCPNotificationHandlerBase::notificationRequested, this, &MCPServerHandler::onNotificationRequested);
     QObject::connect(m_pPromptNotificationHandler, &MCPNotificationHandlerBase::notificationRequested, this, &MCPServerHandler::onNotificationRequested);
+    QObject::connect(m_pResourceNotificationHandler, &MCPNotificationHandlerBase::notificationFanOutRequested, this, &MCPServerHandler::onNotificationFanOutRequested);
+    QObject::connect(m_pToolNotificationHandler, &MCPNotificationHandlerBase::notificationFanOutRequested, this, &MCPServerHandler::onNotificationFanOutRequested);
+    QObject::connect(m_pPromptNotificationHandler, &MCPNotificationHandlerBase::notificationFanOutRequested, this, &MCPServerHandler::onNotificationFanOutRequested);
 }
 
 MCPServerHandler::~MCPServerHandler() {}
@@ -63,10 +73,31 @@ MCPServerHandler::~MCPServerHandler() {}
 void MCPServerHandler::onClientMessageReceived(quint64 nConnectionId, const QSharedPointer<MCPMessage> &pMessage)
 {
     if (auto pClientMessage = pMessage.dynamicCast<MCPClientMessage>()) {
-        if (auto pSession = m_pServer->getSessionService()->getSession(nConnectionId, pClientMessage)) {
-            auto strMethodName = pClientMessage->getMethodName();
+        // Prometheus scrape: no session, no routing
+        if (pClientMessage->getType() & MCPMessageType::Metrics) {
+            m_pMessageSender->sendMetrics(nConnectionId, renderMetrics());
+            return;
+        }
+        if (pClientMessage->getType() & MCPMessageType::Trace) {
+            m_pMessageSender->sendTrace(nConnectionId, MCPTrace::toChromeTraceJson());
+            return;
+        }
+
+        // Spans recorded on this thread until the message is answered or handed to a worker belong to it
+        MCPTrace::Scope traceScope(pClientMessage->getTraceId());
+        QSharedPointer<MCPSession> pSession;
+        {
+            MCPTraceSpan span("session.get");
+            pSession = m_pServer->getSessionService()->getSession(nConnectionId, pClientMessage);
+        }
+        if (pSession != nullptr) {
             auto pContext = QSharedPointer<MCPContext>::create(nConnectionId, pSession, pClientMessage);
-            if (auto pResponse = m_pRequestDispatcher->handleClientMessage(pContext)) {
+            QSharedPointer<MCPServerMessage> pResponse;
+            {
+                MCPTraceSpan span("dispatch");
+                pResponse = m_pRequestDispatcher->handleClientMessage(pContext);
+            }
+            if (pResponse != nullptr) {
                 onServerMessageReceived(pResponse);
             }
         }
@@ -78,6 +109,12 @@ void MCPServerHandler::onServerMessageReceived(const QSharedPointer<MCPMessage>
     if (auto pServerMessage = pMessage.dynamicCast<MCPServerMessage>()) {
         // For Streamable transport responses, pending notifications need to be sent first
         auto enMessageType = pServerMessage->getType();
+        if ((enMessageType & MCPMessageType::StreamableTransport) && (enMessageType & MCPMessageType::Connect)) {
+            // GET SSE stream opened: notifications queued before it existed are pushed on it right away
+            m_pMessageSender->sendMessage(pServerMessage);
+            sendStreamableTransportPendingNotifications(pServerMessage);
+            return;
+        }
         if ((enMessageType & MCPMessageType::StreamableTransport) && (enMessageType & MCPMessageType::Response)) {
             sendStreamableTransportPendingNotifications(pServerMessage);
         }
@@ -89,16 +126,10 @@ void MCPServerHandler::onServerMessageReceived(const QSharedPointer<MCPMessage>
 
 void MCPServerHandler::onConnectionClosed(quint64 nConnectionId)
 {
-    // First get session to unsubscribe
-    auto pSession = m_pServer->getSessionService()->getSessionByConnectionId(nConnectionId);
-    if (pSession) {
-        QString strSessionId = pSession->getSessionId();
-        // Unsubscribe all subscriptions for this session (using sessionId)
-        m_pServer->getResourceService()->unsubscribeAll(strSessionId);
-    }
-
-    // Remove session
+    // Subscriptions are released through MCPSessionService::sessionRemoved
     m_pServer->getSessionService()->removeSessionBySSEConnectId(nConnectionId);
+    // A Streamable HTTP POST waiting for a tool result: nobody will read the answer
+    m_pRequestDispatcher->cancelConnectionCalls(nConnectionId);
 }
 
 // Note: onSseTransportServerMessageReceived and onStreamableTransportServerMessageReceived
@@ -121,34 +152,21 @@ void MCPServerHandler::sendStreamableTransportPendingNotifications(const QShared
         return;
     }
 
+    // On the GET stream they become SSE events (kept for Last-Event-ID replay), otherwise they precede the POST response
+    MCPMessageType::Flags enTransportType = (pServerMessage->getType() & MCPMessageType::Connect) ? MCPMessageType::SseTransport : MCPMessageType::StreamableTransport;
+
     // Generate and send notifications based on notification objects
     auto lstPendingNotifications = pSession->takePendingNotifications();
     for (const MCPPendingNotification &notification : lstPendingNotifications) {
-        QJsonObject notificationObj;
-        if (notification.isResourceChanged()) {
-            notificationObj = generateResourceChangedNotification(notification);
-        } else if (notification.isResourcesListChanged()) {
-            // Resource list change notification: generated by method name
-            notificationObj = generateNotificationByMethod(notification.getMethod());
-        } else if (notification.isToolsListChanged()) {
-            // Tool list change notification: generated by method name
-            notificationObj = generateNotificationByMethod(notification.getMethod());
-        } else if (notification.isPromptsListChanged()) {
-            // Prompt list change notification: generated by method name
-            notificationObj = generateNotificationByMethod(notification.getMethod());
-        } else {
-            // Unknown notification type
-            MCP_CORE_LOG_WARNING() << "MCPServerHandler: sendStreamableTransportPendingNotifications invalid type:" << static_cast<int>(notification.getType());
-            continue;
-        }
-
-        if (notificationObj.isEmpty()) {
+        // The payload (e.g. the full tool list) is built once and shared by every session flushed before the next change
+        auto byteRpcData = getPendingNotificationData(notification);
+        if (byteRpcData.isEmpty()) {
             MCP_CORE_LOG_WARNING() << "MCPServerHandler: sendStreamableTransportPendingNotifications no object for:" << notification.getMethod();
             continue;
         }
 
         // Create notification message
-        auto pNotificationMessage = QSharedPointer<MCPServerMessage>::create(pContext, notificationObj, MCPMessageType::StreamableTransport | MCPMessageType::RequestNotification);
+        auto pNotificationMessage = MCPServerMessage::CreateSerialized(pContext, byteRpcData, enTransportType | MCPMessageType::RequestNotification);
 
         // Use message sender to send notification
         m_pMessageSender->sendMessage(pNotificationMessage);
@@ -169,8 +187,8 @@ void MCPServerHandler::onSubscriptionNotification(const QString &strSessionId, c
 
     // Determine handling method based on transport type
     QString strMethod = objNotification.value("method").toString();
-    if (pSession->isStreamableTransport()) {
-        // StreamableTransport: cache notification flags
+    if (pSession->isStreamableTransport() && pSession->getSseConnectionId() == 0) {
+        // StreamableTransport without a GET stream: cache notification flags
         if (!strMethod.isEmpty()) {
             // Determine notification type by method name
             if (strMethod == "notifications/resources/updated") {
@@ -194,24 +212,74 @@ void MCPServerHandler::onSubscriptionNotification(const QString &strSessionId, c
         }
     } else {
         // SSE transport: send notification immediately
-        // Get SSE connection ID
-        quint64 nSseConnectionId = pSession->getSseConnectionId();
-        if (nSseConnectionId == 0) {
-            MCP_CORE_LOG_WARNING() << "MCPServerHandler: invalid sessionId" << strSessionId;
-            return;
-        }
+        pushNotification(pSession, objNotification);
+    }
+}
 
-        auto pClientMessage = QSharedPointer<MCPClientMessage>::create(MCPMessageType::SseTransport | MCPMessageType::Notification);
+void MCPServerHandler::onProgressNotification(const QString &strSessionId, const QJsonObject &objNotification)
+{
+    auto pSession = m_pServer->getSessionService()->getSessionBySessionId(strSessionId);
+    if (pSession == nullptr) {
+        return;
+    }
 
-        // Create Context
-        auto pContext = QSharedPointer<MCPContext>::create(nSseConnectionId, pSession, pClientMessage);
+    // Progress is only useful while the call runs: a streamable session without a GET stream
+    // would receive it together with the response, so it is dropped instead of cached
+    if (pSession->isStreamableTransport() && pSession->getSseConnectionId() == 0) {
+        MCP_CORE_LOG_DEBUG() << "MCPServerHandler: progress dropped, no SSE stream:" << strSessionId;
+        return;
+    }
+    pushNotification(pSession, objNotification);
+}
 
-        // Create notification message (notification messages don't need id field)
-        auto pNotificationMessage = QSharedPointer<MCPServerMessage>::create(pContext, objNotification, MCPMessageType::SseTransport | MCPMessageType::RequestNotification);
+QByteArray MCPServerHandler::renderMetrics()
+{
+    // Counters recorded on the request path, then the state owned by the services, sampled now
+    QByteArray byteText = MCPMetrics::instance()->toPrometheusText();
+
+    MCPMetrics::appendMetric(byteText, "mcp_sessions", "gauge", "Live sessions", m_pServer->getSessionService()->getSessionCount());
+
+    auto pToolExecutor = m_pServer->getToolExecutor();
+    MCPMetrics::appendMetric(byteText, "mcp_tool_executor_threads", "gauge", "Tool executor worker threads", pToolExecutor->getThreadCount());
+    MCPMetrics::appendMetric(byteText, "mcp_tool_executor_queue_depth", "gauge", "Tool calls waiting for a worker", pToolExecutor->getQueueDepth());
+    MCPMetrics::appendMetric(byteText, "mcp_tool_executor_peak_queue_depth", "gauge", "Highest tool executor queue depth seen", pToolExecutor->getPeakQueueDepth());
+    MCPMetrics::appendMetric(byteText, "mcp_tool_executor_active", "gauge", "Tool calls running", pToolExecutor->getActiveCount());
+    MCPMetrics::appendMetric(byteText, "mcp_tool_executor_completed_total", "counter", "Tool calls run to completion by the executor", pToolExecutor->getCompletedCount());
+    MCPMetrics::appendMetric(byteText, "mcp_tool_executor_rejected_total", "counter", "Tool calls rejected because the executor queue was full", pToolExecutor->getRejectedCount());
+    MCPMetrics::appendMetric(byteText, "mcp_tool_executor_queue_delay_seconds", "gauge", "Time the most recently started tool call waited for a worker", pToolExecutor->getLastQueueDelay() / 1000.0);
+    MCPMetrics::appendMetric(byteText, "mcp_tool_calls_in_flight", "gauge", "Tool calls accepted and not answered yet", m_pRequestDispatcher->getToolCallRegistry()->getInFlightCount());
+
+    auto pResultCache = m_pServer->getToolService()->getResultCache();
+    MCPMetrics::appendMetric(byteText, "mcp_tool_cache_bytes", "gauge", "Bytes held by the tool result cache", pResultCache->getTotalBytes());
+    MCPMetrics::appendMetric(byteText, "mcp_tool_cache_hits_total", "counter", "Tool result cache hits", pResultCache->getHitCount());
+    MCPMetrics::appendMetric(byteText, "mcp_tool_cache_misses_total", "counter", "Tool result cache misses", pResultCache->getMissCount());
+
+    MCPMetrics::appendMetric(byteText, "mcp_admission_rejected_total", "counter", "Requests rejected by rate limits or load shedding", m_pRequestDispatcher->getAdmissionMiddleware()->getRejectedCount());
+    return byteText;
+}
 
-        // Use message sender to send notification
-        m_pMessageSender->sendMessage(pNotificationMessage);
+void MCPServerHandler::pushNotification(const QSharedPointer<MCPSession> &pSession, const QJsonObject &objNotification)
+{
+    // Get SSE connection ID (0 = SSE stream dropped, the event is buffered for Last-Event-ID replay)
+    quint64 nSseConnectionId = pSession->getSseConnectionId();
+    if (nSseConnectionId == 0 && pSession->isStdioTransport()) {
+        MCP_CORE_LOG_WARNING() << "MCPServerHandler: invalid sessionId" << pSession->getSessionId();
+        return;
     }
+
+    // Stdio sessions push immediately as well, only the framing differs
+    // (a streamable session's GET stream carries the same SSE frames as a legacy SSE stream)
+    MCPMessageType::Flags enTransportType = pSession->isStdioTransport() ? MCPMessageType::StdioTransport : MCPMessageType::SseTransport;
+    auto pClientMessage = QSharedPointer<MCPClientMessage>::create(enTransportType | MCPMessageType::Notification);
+
+    // Create Context
+    auto pContext = QSharedPointer<MCPContext>::create(nSseConnectionId, pSession, pClientMessage);
+
+    // Create notification message (notification messages don't need id field)
+    auto pNotificationMessage = QSharedPointer<MCPServerMessage>::create(pContext, objNotification, enTransportType | MCPMessageType::RequestNotification);
+
+    // Use message sender to send notification
+    m_pMessageSender->sendMessage(pNotificationMessage);
 }
 
 void MCPServerHandler::onNotificationRequested(const QString &strSessionId, const QJsonObject &objNotification)
@@ -220,32 +288,82 @@ void MCPServerHandler::onNotificationRequested(const QString &strSessionId, cons
     onSubscriptionNotification(strSessionId, objNotification);
 }
 
+void MCPServerHandler::onNotificationFanOutRequested(const QStringList &lstSessionIds, const QJsonObject &objNotification)
+{
+    QList<QSharedPointer<MCPSession>> lstSessions;
+    lstSessions.reserve(lstSessionIds.size());
+    for (const auto &strSessionId : lstSessionIds) {
+        auto pSession = m_pServer->getSessionService()->getSessionBySessionId(strSessionId);
+        if (pSession == nullptr || (pSession->isStreamableTransport() && pSession->getSseConnectionId() == 0)) {
+            continue;
+        }
+        lstSessions.append(pSession);
+    }
+    if (lstSessions.isEmpty()) {
+        return;
+    }
+
+    // Serialize the JSON-RPC notification once, every subscriber's frame references the same bytes
+    QJsonObject objRpc{{"jsonrpc", "2.0"}, {"method", objNotification.value("method")}, {"params", objNotification.value("params")}};
+    auto byteRpcData = QJsonDocument(objRpc).toJson(QJsonDocument::Compact);
+    m_pMessageSender->sendNotificationFanOut(lstSessions, byteRpcData);
+}
+
+void MCPServerHandler::onDeferredNotificationsReady(const QString &strSessionId, const QList<MCPPendingNotification> &lstNotifications)
+{
+    // Generated now, so the session receives the latest state instead of every intermediate change
+    for (const MCPPendingNotification &notification : lstNotifications) {
+        QJsonObject notificationObj = generatePendingNotification(notification);
+        if (!notificationObj.isEmpty()) {
+            onSubscriptionNotification(strSessionId, notificationObj);
+        }
+    }
+}
+
+static QString pendingNotificationKey(const MCPPendingNotification &notification)
+{
+    return notification.hasUri() ? notification.getMethod() + '\n' + notification.getUri() : notification.getMethod();
+}
+
 void MCPServerHandler::onResourceContentChanged(const QString &strUri)
 {
+    // Metadata is part of the resource list as well
+    invalidatePendingNotificationData(pendingNotificationKey(MCPPendingNotification(MCPPendingNotificationType::ResourceChanged, strUri)));
+    invalidatePendingNotificationData(pendingNotificationKey(MCPPendingNotification(MCPPendingNotificationType::ResourcesListChanged)));
+
     // Forward to resource notification handler
     m_pResourceNotificationHandler->onResourceContentChanged(strUri);
 }
 
 void MCPServerHandler::onResourceDeleted(const QString &strUri)
 {
+    invalidatePendingNotificationData(pendingNotificationKey(MCPPendingNotification(MCPPendingNotificationType::ResourceChanged, strUri)));
+    invalidatePendingNotificationData(pendingNotificationKey(MCPPendingNotification(MCPPendingNotificationType::ResourcesListChanged)));
+
     // Forward to resource notification handler
     m_pResourceNotificationHandler->onResourceDeleted(strUri);
 }
 
 void MCPServerHandler::onResourcesListChanged()
 {
+    invalidatePendingNotificationData(pendingNotificationKey(MCPPendingNotification(MCPPendingNotificationType::ResourcesListChanged)));
+
     // Forward to resource notification handler
     m_pResourceNotificationHandler->onResourcesListChanged();
 }
 
 void MCPServerHandler::onToolsListChanged()
 {
+    invalidatePendingNotificationData(pendingNotificationKey(MCPPendingNotification(MCPPendingNotificationType::ToolsListChanged)));
+
     // Forward to tool notification handler
     m_pToolNotificationHandler->onToolsListChanged();
 }
 
 void MCPServerHandler::onPromptsListChanged()
 {
+    invalidatePendingNotificationData(pendingNotificationKey(MCPPendingNotification(MCPPendingNotificationType::PromptsListChanged)));
+
     // Forward to prompt notification handler
     m_pPromptNotificationHandler->onPromptsListChanged();
 }
@@ -265,6 +383,16 @@ MCPPromptNotificationHandler *MCPServerHandler::getPromptNotificationHandler() c
     return m_pPromptNotificationHandler;
 }
 
+MCPRequestDispatcher *MCPServerHandler::getRequestDispatcher() const
+{
+    return m_pRequestDispatcher;
+}
+
+void MCPServerHandler::setTransport(IMCPTransport *pTransport)
+{
+    m_pMessageSender->setTransport(pTransport);
+}
+
 QJsonObject MCPServerHandler::generateNotificationByMethod(const QString &strMethod)
 {
     QJsonObject notification;
@@ -332,4 +460,42 @@ QJsonObject MCPServerHandler::generateResourceChangedNotification(const MCPPendi
     params["data"] = QJsonValue(resourceData);
     notificationObj["params"] = QJsonValue(params);
     return notificationObj;
-}
\ No newline at end of file
+}
+
+QJsonObject MCPServerHandler::generatePendingNotification(const MCPPendingNotification &notification)
+{
+    if (notification.isResourceChanged()) {
+        return generateResourceChangedNotification(notification);
+    } else if (notification.isResourcesListChanged() || notification.isToolsListChanged() || notification.isPromptsListChanged()) {
+        // List change notification: generated by method name
+        return generateNotificationByMethod(notification.getMethod());
+    }
+
+    // Unknown notification type
+    MCP_CORE_LOG_WARNING() << "MCPServerHandler: generatePendingNotification invalid type:" << static_cast<int>(notification.getType());
+    return QJsonObject();
+}
+
+QByteArray MCPServerHandler::getPendingNotificationData(const MCPPendingNotification &notification)
+{
+    const QString strKey = pendingNotificationKey(notification);
+    auto it = m_dictPendingNotificationData.constFind(strKey);
+    if (it != m_dictPendingNotificationData.constEnd()) {
+        return it.value();
+    }
+
+    QJsonObject notificationObj = generatePendingNotification(notification);
+    if (notificationObj.isEmpty()) {
+        return QByteArray();
+    }
+
+    QJsonObject objRpc{{"jsonrpc", "2.0"}, {"method", notificationObj.value("method")}, {"params", notificationObj.value("params")}};
+    auto byteRpcData = QJsonDocument(objRpc).toJson(QJsonDocument::Compact);
+    m_dictPendingNotificationData.insert(strKey, byteRpcData);
+    return byteRpcData;
+}
+
+void MCPServerHandler::invalidatePendingNotificationData(const QString &strKey)
+{
+    m_dictPendingNotificationData.remove(strKey);
+}
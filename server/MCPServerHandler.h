@@ -12,6 +12,8 @@
 #include <QJsonObject>
 #include <QSharedPointer>
 #include <QSet>
+#include <QHash>
+#include <QByteArray>
 
 class MCPMessage;
 class MCPServerMessage;
@@ -120,6 +122,20 @@ public slots:
      * @brief Handle prompt list change event (forward to prompt notification handler)
      */
     void onPromptsListChanged();
+
+    /**
+     * @brief Send notifications the scheduler held back for a rate-limited push session
+     * @param strSessionId Session ID
+     * @param lstNotifications Deduplicated notifications, generated from the current state
+     */
+    void onDeferredNotificationsReady(const QString& strSessionId, const QList<MCPPendingNotification>& lstNotifications);
+
+    /**
+     * @brief Push a notifications/progress of a running tool call to its session
+     * @param strSessionId Session ID
+     * @param objNotification Notification message (already rate-limited by the call's progress reporter)
+     */
+    void onProgressNotification(const QString& strSessionId, const QJsonObject& objNotification);
     
     /**
      * @brief Get resource notification handler
@@ -139,6 +155,18 @@ public slots:
      */
     MCPPromptNotificationHandler* getPromptNotificationHandler() const;
 
+    /**
+     * @brief Get request dispatcher
+     * @return Pointer to request dispatcher
+     */
+    MCPRequestDispatcher* getRequestDispatcher() const;
+
+    /**
+     * @brief Switch the transport used for outgoing messages
+     * @param pTransport Transport layer interface
+     */
+    void setTransport(IMCPTransport* pTransport);
+
 private slots:
     /**
      * @brief Handle notification requests (emitted by various notification handlers)
@@ -146,6 +174,13 @@ private slots:
      * @param objNotification Notification message
      */
     void onNotificationRequested(const QString& strSessionId, const QJsonObject& objNotification);
+
+    /**
+     * @brief Handle a notification for many push sessions (SSE/Stdio), serialized once for all of them
+     * @param lstSessionIds Session IDs
+     * @param objNotification Notification message
+     */
+    void onNotificationFanOutRequested(const QStringList& lstSessionIds, const QJsonObject& objNotification);
     
 private:
     /**
@@ -155,6 +190,19 @@ private:
      * Note: This method is called before sending response messages, used to send pending notifications
      */
     void sendStreamableTransportPendingNotifications(const QSharedPointer<MCPServerMessage>& pServerMessage);
+
+    /**
+     * @brief Send a notification right away over the session's push channel (SSE stream or stdio)
+     * @param pSession Session
+     * @param objNotification Notification message
+     */
+    void pushNotification(const QSharedPointer<MCPSession>& pSession, const QJsonObject& objNotification);
+
+    /**
+     * @brief Render the GET /metrics page
+     * @return Prometheus text exposition: MCPMetrics plus the current state of the services
+     */
+    QByteArray renderMetrics();
 private:
     /**
      * @brief Generate notification message by notification method name
@@ -170,6 +218,28 @@ private:
      */
     QJsonObject generateResourceChangedNotification(const MCPPendingNotification& notification);
 
+    /**
+     * @brief Generate notification message for a pending notification of any type
+     * @param notification Pending notification object
+     * @return Notification message JSON object, returns empty object for unknown types
+     */
+    QJsonObject generatePendingNotification(const MCPPendingNotification& notification);
+
+    /**
+     * @brief Serialized JSON-RPC notification for a pending notification, built once and shared by all sessions
+     * @param notification Pending notification object
+     * @return Serialized notification, empty if it cannot be generated
+     *
+     * Cached until the scheduler reports a change of the resource or list it was built from
+     */
+    QByteArray getPendingNotificationData(const MCPPendingNotification& notification);
+
+    /**
+     * @brief Drop cached notification payloads after a change
+     * @param strKey Cache key (method name, or method name + URI for resource changes)
+     */
+    void invalidatePendingNotificationData(const QString& strKey);
+
 private:
     MCPServer* m_pServer;  // Server object, through which various services are accessed
     
@@ -183,4 +253,7 @@ private:
     MCPResourceNotificationHandler* m_pResourceNotificationHandler;
     MCPToolNotificationHandler* m_pToolNotificationHandler;
     MCPPromptNotificationHandler* m_pPromptNotificationHandler;
+
+    // Serialized pending notification payloads shared by all streamable sessions (key -> JSON-RPC bytes)
+    QHash<QString, QByteArray> m_dictPendingNotificationData;
 };
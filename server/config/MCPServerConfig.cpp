@@ -27,6 +27,28 @@ MCPServerConfig::MCPServerConfig(QObject *pParent)
     , m_strServerTitle("MCP Server for C++, Java, Qt Instructions")
     , m_strServerVersion("1.0.0")
     , m_strInstructions("C++ Qt MCP Instructions")
+    , m_strTransportType("http")
+    , m_nIoThreads(0)
+    , m_nMaxHeaderSize(0)
+    , m_nMaxBodySize(0)
+    , m_nSessionTimeout(1800)
+    , m_nMaxSessions(10000)
+    , m_nSseReplayBufferSize(256)
+    , m_nSseReplayRetention(60)
+    , m_nNotificationCoalesceMs(100)
+    , m_nNotificationRateLimit(20)
+    , m_nProgressIntervalMs(100)
+    , m_nToolThreads(0)
+    , m_nToolQueueSize(256)
+    , m_nToolTimeoutMs(0)
+    , m_nToolCacheSize(16777216)
+    , m_dRateLimitPerSecond(0)
+    , m_nRateLimitBurst(0)
+    , m_nMaxInFlightToolCalls(0)
+    , m_nShedTargetMs(0)
+    , m_nShedIntervalMs(100)
+    , m_bTracing(false)
+    , m_nTraceBufferSize(16384)
 {}
 
 MCPServerConfig::~MCPServerConfig() {}
@@ -130,6 +152,47 @@ bool MCPServerConfig::loadFromJson(const QJsonObject &jsonConfig)
         m_strInstructions = jsonConfig["instructions"].toString();
     }
 
+    // Read transport backend
+    m_strTransportType = jsonConfig.value("transport").toString("http").toLower();
+    applyConsoleLogTarget();
+    m_nIoThreads = jsonConfig.value("ioThreads").toInt(0);
+    m_strLocalSocket = jsonConfig.value("localSocket").toString();
+
+    // Read HTTP request limits
+    m_nMaxHeaderSize = jsonConfig.value("maxHeaderSize").toInteger(0);
+    m_nMaxBodySize = jsonConfig.value("maxBodySize").toInteger(0);
+
+    // Read session limits
+    m_nSessionTimeout = jsonConfig.value("sessionTimeout").toInt(1800);
+    m_nMaxSessions = jsonConfig.value("maxSessions").toInt(10000);
+
+    // Read SSE resumption settings
+    m_nSseReplayBufferSize = jsonConfig.value("sseReplayBufferSize").toInt(256);
+    m_nSseReplayRetention = jsonConfig.value("sseReplayRetention").toInt(60);
+
+    // Read notification scheduler settings
+    m_nNotificationCoalesceMs = jsonConfig.value("notificationCoalesceMs").toInt(100);
+    m_nNotificationRateLimit = jsonConfig.value("notificationRateLimit").toInt(20);
+    m_nProgressIntervalMs = jsonConfig.value("progressIntervalMs").toInt(100);
+
+    // Read tool executor settings
+    m_nToolThreads = jsonConfig.value("toolThreads").toInt(0);
+    m_nToolQueueSize = jsonConfig.value("toolQueueSize").toInt(256);
+    m_nToolTimeoutMs = jsonConfig.value("toolTimeoutMs").toInt(0);
+    m_nToolCacheSize = jsonConfig.value("toolCacheSize").toInteger(16777216);
+
+    // Read admission control settings (all disabled unless configured)
+    m_dRateLimitPerSecond = jsonConfig.value("rateLimitPerSecond").toDouble(0);
+    m_nRateLimitBurst = jsonConfig.value("rateLimitBurst").toInt(0);
+    m_jsonMethodRateLimits = jsonConfig.value("methodRateLimits").toObject();
+    m_nMaxInFlightToolCalls = jsonConfig.value("maxInFlightToolCalls").toInt(0);
+    m_nShedTargetMs = jsonConfig.value("shedTargetMs").toInt(0);
+    m_nShedIntervalMs = jsonConfig.value("shedIntervalMs").toInt(100);
+
+    // Read request tracing settings
+    m_bTracing = jsonConfig.value("tracing").toBool(false);
+    m_nTraceBufferSize = jsonConfig.value("traceBufferSize").toInt(16384);
+
     MCP_CORE_LOG_INFO() << "MCPServerConfig: port:" << m_nPort << ", name:" << m_strServerName;
     return true;
 }
@@ -170,6 +233,30 @@ QJsonObject MCPServerConfig::toJson() const
     json["serverInfo"] = serverInfo;
 
     json["instructions"] = m_strInstructions;
+    json["transport"] = m_strTransportType;
+    json["localSocket"] = m_strLocalSocket;
+    json["ioThreads"] = m_nIoThreads;
+    json["maxHeaderSize"] = m_nMaxHeaderSize;
+    json["maxBodySize"] = m_nMaxBodySize;
+    json["sessionTimeout"] = m_nSessionTimeout;
+    json["maxSessions"] = m_nMaxSessions;
+    json["sseReplayBufferSize"] = m_nSseReplayBufferSize;
+    json["sseReplayRetention"] = m_nSseReplayRetention;
+    json["notificationCoalesceMs"] = m_nNotificationCoalesceMs;
+    json["notificationRateLimit"] = m_nNotificationRateLimit;
+    json["progressIntervalMs"] = m_nProgressIntervalMs;
+    json["toolThreads"] = m_nToolThreads;
+    json["toolQueueSize"] = m_nToolQueueSize;
+    json["toolTimeoutMs"] = m_nToolTimeoutMs;
+    json["toolCacheSize"] = m_nToolCacheSize;
+    json["rateLimitPerSecond"] = m_dRateLimitPerSecond;
+    json["rateLimitBurst"] = m_nRateLimitBurst;
+    json["methodRateLimits"] = m_jsonMethodRateLimits;
+    json["maxInFlightToolCalls"] = m_nMaxInFlightToolCalls;
+    json["shedTargetMs"] = m_nShedTargetMs;
+    json["shedIntervalMs"] = m_nShedIntervalMs;
+    json["tracing"] = m_bTracing;
+    json["traceBufferSize"] = m_nTraceBufferSize;
 
     return json;
 }
@@ -223,3 +310,253 @@ QString MCPServerConfig::getInstructions() const
 {
     return m_strInstructions;
 }
+
+void MCPServerConfig::setTransportType(const QString &strTransportType)
+{
+    m_strTransportType = strTransportType.toLower();
+    applyConsoleLogTarget();
+}
+
+void MCPServerConfig::applyConsoleLogTarget()
+{
+    // stdout carries the stdio transport's JSON-RPC stream, so move console logs off it before
+    // anything else (config summary, service limits in MCPServer::doStart) gets logged
+    if (m_strTransportType == "stdio") {
+        MCPLog::instance()->setConsoleToStderr(true);
+    }
+}
+
+QString MCPServerConfig::getTransportType() const
+{
+    return m_strTransportType;
+}
+
+void MCPServerConfig::setLocalSocket(const QString &strLocalSocket)
+{
+    m_strLocalSocket = strLocalSocket;
+}
+
+QString MCPServerConfig::getLocalSocket() const
+{
+    return m_strLocalSocket;
+}
+
+void MCPServerConfig::setIoThreads(int nIoThreads)
+{
+    m_nIoThreads = nIoThreads;
+}
+
+int MCPServerConfig::getIoThreads() const
+{
+    return m_nIoThreads;
+}
+
+void MCPServerConfig::setMaxHeaderSize(qint64 nMaxHeaderSize)
+{
+    m_nMaxHeaderSize = nMaxHeaderSize;
+}
+
+qint64 MCPServerConfig::getMaxHeaderSize() const
+{
+    return m_nMaxHeaderSize;
+}
+
+void MCPServerConfig::setMaxBodySize(qint64 nMaxBodySize)
+{
+    m_nMaxBodySize = nMaxBodySize;
+}
+
+qint64 MCPServerConfig::getMaxBodySize() const
+{
+    return m_nMaxBodySize;
+}
+
+void MCPServerConfig::setSessionTimeout(int nSessionTimeout)
+{
+    m_nSessionTimeout = nSessionTimeout;
+}
+
+int MCPServerConfig::getSessionTimeout() const
+{
+    return m_nSessionTimeout;
+}
+
+void MCPServerConfig::setMaxSessions(int nMaxSessions)
+{
+    m_nMaxSessions = nMaxSessions;
+}
+
+int MCPServerConfig::getMaxSessions() const
+{
+    return m_nMaxSessions;
+}
+
+void MCPServerConfig::setSseReplayBufferSize(int nSseReplayBufferSize)
+{
+    m_nSseReplayBufferSize = nSseReplayBufferSize;
+}
+
+int MCPServerConfig::getSseReplayBufferSize() const
+{
+    return m_nSseReplayBufferSize;
+}
+
+void MCPServerConfig::setSseReplayRetention(int nSseReplayRetention)
+{
+    m_nSseReplayRetention = nSseReplayRetention;
+}
+
+int MCPServerConfig::getSseReplayRetention() const
+{
+    return m_nSseReplayRetention;
+}
+
+void MCPServerConfig::setNotificationCoalesceMs(int nNotificationCoalesceMs)
+{
+    m_nNotificationCoalesceMs = nNotificationCoalesceMs;
+}
+
+int MCPServerConfig::getNotificationCoalesceMs() const
+{
+    return m_nNotificationCoalesceMs;
+}
+
+void MCPServerConfig::setNotificationRateLimit(int nNotificationRateLimit)
+{
+    m_nNotificationRateLimit = nNotificationRateLimit;
+}
+
+int MCPServerConfig::getNotificationRateLimit() const
+{
+    return m_nNotificationRateLimit;
+}
+
+void MCPServerConfig::setToolThreads(int nToolThreads)
+{
+    m_nToolThreads = nToolThreads;
+}
+
+int MCPServerConfig::getToolThreads() const
+{
+    return m_nToolThreads;
+}
+
+void MCPServerConfig::setToolQueueSize(int nToolQueueSize)
+{
+    m_nToolQueueSize = nToolQueueSize;
+}
+
+int MCPServerConfig::getToolQueueSize() const
+{
+    return m_nToolQueueSize;
+}
+
+void MCPServerConfig::setToolCacheSize(qint64 nToolCacheSize)
+{
+    m_nToolCacheSize = nToolCacheSize;
+}
+
+qint64 MCPServerConfig::getToolCacheSize() const
+{
+    return m_nToolCacheSize;
+}
+
+void MCPServerConfig::setToolTimeoutMs(int nToolTimeoutMs)
+{
+    m_nToolTimeoutMs = nToolTimeoutMs;
+}
+
+int MCPServerConfig::getToolTimeoutMs() const
+{
+    return m_nToolTimeoutMs;
+}
+
+void MCPServerConfig::setProgressIntervalMs(int nProgressIntervalMs)
+{
+    m_nProgressIntervalMs = nProgressIntervalMs;
+}
+
+int MCPServerConfig::getProgressIntervalMs() const
+{
+    return m_nProgressIntervalMs;
+}
+
+void MCPServerConfig::setRateLimitPerSecond(double dRateLimitPerSecond)
+{
+    m_dRateLimitPerSecond = dRateLimitPerSecond;
+}
+
+double MCPServerConfig::getRateLimitPerSecond() const
+{
+    return m_dRateLimitPerSecond;
+}
+
+void MCPServerConfig::setRateLimitBurst(int nRateLimitBurst)
+{
+    m_nRateLimitBurst = nRateLimitBurst;
+}
+
+int MCPServerConfig::getRateLimitBurst() const
+{
+    return m_nRateLimitBurst;
+}
+
+void MCPServerConfig::setMethodRateLimits(const QJsonObject &jsonMethodRateLimits)
+{
+    m_jsonMethodRateLimits = jsonMethodRateLimits;
+}
+
+QJsonObject MCPServerConfig::getMethodRateLimits() const
+{
+    return m_jsonMethodRateLimits;
+}
+
+void MCPServerConfig::setMaxInFlightToolCalls(int nMaxInFlightToolCalls)
+{
+    m_nMaxInFlightToolCalls = nMaxInFlightToolCalls;
+}
+
+int MCPServerConfig::getMaxInFlightToolCalls() const
+{
+    return m_nMaxInFlightToolCalls;
+}
+
+void MCPServerConfig::setShedTargetMs(int nShedTargetMs)
+{
+    m_nShedTargetMs = nShedTargetMs;
+}
+
+int MCPServerConfig::getShedTargetMs() const
+{
+    return m_nShedTargetMs;
+}
+
+void MCPServerConfig::setShedIntervalMs(int nShedIntervalMs)
+{
+    m_nShedIntervalMs = nShedIntervalMs;
+}
+
+int MCPServerConfig::getShedIntervalMs() const
+{
+    return m_nShedIntervalMs;
+}
+
+void MCPServerConfig::setTracing(bool bTracing)
+{
+    m_bTracing = bTracing;
+}
+
+bool MCPServerConfig::getTracing() const
+{
+    return m_bTracing;
+}
+
+void MCPServerConfig::setTraceBufferSize(int nTraceBufferSize)
+{
+    m_nTraceBufferSize = nTraceBufferSize;
+}
+
+int MCPServerConfig::getTraceBufferSize() const
+{
+    return m_nTraceBufferSize;
+}
@@ -59,12 +59,87 @@ public:
     void setInstructions(const QString &strInstructions) override;
     QString getInstructions() const override;
 
+    // Transport backend: "http" (QTcpServer, default), "epoll" (Linux only) or "stdio" (NDJSON over stdin/stdout)
+    void setTransportType(const QString &strTransportType);
+    QString getTransportType() const;
+
+    // Unix domain socket served next to port ("" = disabled, "@name" = Linux abstract namespace)
+    void setLocalSocket(const QString &strLocalSocket);
+    QString getLocalSocket() const;
+
+    // Number of I/O threads for the epoll transport (0 = QThread::idealThreadCount())
+    void setIoThreads(int nIoThreads);
+    int getIoThreads() const;
+
+    // HTTP request limits in bytes (0 = parser default)
+    void setMaxHeaderSize(qint64 nMaxHeaderSize);
+    qint64 getMaxHeaderSize() const;
+    void setMaxBodySize(qint64 nMaxBodySize);
+    qint64 getMaxBodySize() const;
+
+    // Session idle timeout in seconds (0 = never expire) and maximum number of sessions (0 = unlimited, LRU eviction otherwise)
+    void setSessionTimeout(int nSessionTimeout);
+    int getSessionTimeout() const;
+    void setMaxSessions(int nMaxSessions);
+    int getMaxSessions() const;
+
+    // SSE resumption: frames kept per session (0 = none) and how long a dropped SSE session waits for a Last-Event-ID reconnect in seconds (0 = remove at once)
+    void setSseReplayBufferSize(int nSseReplayBufferSize);
+    int getSseReplayBufferSize() const;
+    void setSseReplayRetention(int nSseReplayRetention);
+    int getSseReplayRetention() const;
+
+    // Notification scheduler: coalescing window in ms (0 = deliver every change at once) and pushes per session per second (0 = unlimited)
+    void setNotificationCoalesceMs(int nNotificationCoalesceMs);
+    int getNotificationCoalesceMs() const;
+    void setNotificationRateLimit(int nNotificationRateLimit);
+    int getNotificationRateLimit() const;
+    // Minimum interval in ms between two notifications/progress of one tool call (0 = unlimited)
+    void setProgressIntervalMs(int nProgressIntervalMs);
+    int getProgressIntervalMs() const;
+
+    // Tool executor: worker threads (0 = ideal thread count) and tool calls waiting for a worker (0 = unbounded)
+    void setToolThreads(int nToolThreads);
+    int getToolThreads() const;
+    void setToolQueueSize(int nToolQueueSize);
+    int getToolQueueSize() const;
+    // Default tool call deadline in ms (0 = none), a tool's "timeoutMs" overrides it
+    void setToolTimeoutMs(int nToolTimeoutMs);
+    int getToolTimeoutMs() const;
+
+    // Tool result cache: memory budget in bytes for read-only/idempotent tool results (0 = disabled)
+    void setToolCacheSize(qint64 nToolCacheSize);
+    qint64 getToolCacheSize() const;
+
+    // Admission control, all disabled by default: token bucket per session and method (requests per second,
+    // 0 = unlimited, and burst), per-method overrides {"tools/call": {"perSecond": 10, "burst": 20}}
+    // and in-flight tools/call over all sessions (0 = unlimited)
+    void setRateLimitPerSecond(double dRateLimitPerSecond);
+    double getRateLimitPerSecond() const;
+    void setRateLimitBurst(int nRateLimitBurst);
+    int getRateLimitBurst() const;
+    void setMethodRateLimits(const QJsonObject &jsonMethodRateLimits);
+    QJsonObject getMethodRateLimits() const;
+    void setMaxInFlightToolCalls(int nMaxInFlightToolCalls);
+    int getMaxInFlightToolCalls() const;
+    // Load shedding: reject tool calls while their queueing delay stays above the target for an interval (0 = disabled)
+    void setShedTargetMs(int nShedTargetMs);
+    int getShedTargetMs() const;
+    void setShedIntervalMs(int nShedIntervalMs);
+    int getShedIntervalMs() const;
+    // Request tracing (GET /trace) and the spans kept per thread
+    void setTracing(bool bTracing);
+    bool getTracing() const;
+    void setTraceBufferSize(int nTraceBufferSize);
+    int getTraceBufferSize() const;
+
 private:
     // Internal methods
     bool loadFromFile(const QString &strFilePath);
     bool saveToFile(const QString &strFilePath) const;
     bool loadFromJson(const QJsonObject &jsonConfig);
     QJsonObject toJson() const;
+    void applyConsoleLogTarget();
 
 private:
     quint16 m_nPort;
@@ -72,6 +147,30 @@ private:
     QString m_strServerTitle;
     QString m_strServerVersion;
     QString m_strInstructions;
+    QString m_strTransportType;
+    QString m_strLocalSocket;
+    int m_nIoThreads;
+    qint64 m_nMaxHeaderSize;
+    qint64 m_nMaxBodySize;
+    int m_nSessionTimeout;
+    int m_nMaxSessions;
+    int m_nSseReplayBufferSize;
+    int m_nSseReplayRetention;
+    int m_nNotificationCoalesceMs;
+    int m_nNotificationRateLimit;
+    int m_nProgressIntervalMs;
+    int m_nToolThreads;
+    int m_nToolQueueSize;
+    int m_nToolTimeoutMs;
+    qint64 m_nToolCacheSize;
+    double m_dRateLimitPerSecond;
+    int m_nRateLimitBurst;
+    QJsonObject m_jsonMethodRateLimits;
+    int m_nMaxInFlightToolCalls;
+    int m_nShedTargetMs;
+    int m_nShedIntervalMs;
+    bool m_bTracing;
+    int m_nTraceBufferSize;
 
 private:
     friend class MCPServer;
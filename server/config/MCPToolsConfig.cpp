@@ -34,6 +34,23 @@ QJsonObject MCPToolConfig::toJson() const
         json["annotations"] = annotations;
     }
 
+    if (!strValidation.isEmpty()) {
+        json["validation"] = strValidation;
+        json["validationSampleInterval"] = nValidationSampleInterval;
+    }
+
+    if (!strConcurrency.isEmpty()) {
+        json["concurrency"] = strConcurrency;
+    }
+
+    json["cacheTtl"] = nCacheTtl;
+    if (nTimeoutMs > 0) {
+        json["timeoutMs"] = nTimeoutMs;
+    }
+    if (!lstCacheInvalidates.isEmpty()) {
+        json["cacheInvalidates"] = QJsonArray::fromStringList(lstCacheInvalidates);
+    }
+
     return json;
 }
 
@@ -53,6 +70,15 @@ MCPToolConfig MCPToolConfig::fromJson(const QJsonObject &json)
         config.annotations = json["annotations"].toObject();
     }
 
+    config.strValidation = json["validation"].toString();
+    config.nValidationSampleInterval = json["validationSampleInterval"].toInt(1);
+    config.strConcurrency = json["concurrency"].toString();
+    config.nCacheTtl = json["cacheTtl"].toInt(60);
+    config.nTimeoutMs = json["timeoutMs"].toInt(0);
+    for (const auto &jsonName : json["cacheInvalidates"].toArray()) {
+        config.lstCacheInvalidates.append(jsonName.toString());
+    }
+
     return config;
 }
 
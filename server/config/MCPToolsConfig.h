@@ -11,6 +11,7 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QString>
+#include <QStringList>
 #include <QList>
 
 /**
@@ -28,8 +29,26 @@ struct MCPToolConfig
     
     // Tool annotations (Annotations), optional according to MCP protocol specification
     QJsonObject annotations;   // Contains audience, priority, lastModified and other fields
+
+    // Schema validation policy: "always" (default), "sampled" or "off"
+    QString strValidation;
+    int nValidationSampleInterval; // "sampled": validate one call out of every N
+
+    // Concurrency policy: "affinity" (default), "serialized" or "thread-safe"
+    QString strConcurrency;
+
+    // Result cache (tools annotated readOnlyHint/idempotentHint): TTL in seconds and tools to invalidate after a call
+    int nCacheTtl;
+    QStringList lstCacheInvalidates;
+
+    // Call deadline in milliseconds (0 = server default "toolTimeoutMs")
+    int nTimeoutMs;
     
-    MCPToolConfig() {}
+    MCPToolConfig()
+        : nValidationSampleInterval(1)
+        , nCacheTtl(60)
+        , nTimeoutMs(0)
+    {}
     
     QJsonObject toJson() const;
     static MCPToolConfig fromJson(const QJsonObject& json);
@@ -0,0 +1,66 @@
+/**
+ * @file MCPCancellationToken.cpp
+ * @brief Cooperative cancellation token of an in-flight request (internal implementation)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include "MCPCancellationToken.h"
+
+namespace {
+thread_local MCPCancellationToken *s_pCurrentToken = nullptr;
+}
+
+MCPCancellationToken::MCPCancellationToken()
+    : m_nState(static_cast<int>(EnumRequestState::enRunning))
+{}
+
+bool MCPCancellationToken::finish(EnumRequestState enState)
+{
+    if (!m_nState.testAndSetOrdered(static_cast<int>(EnumRequestState::enRunning), static_cast<int>(enState))) {
+        return false;
+    }
+    // Progress must not follow the response (or a cancellation)
+    if (m_pProgressReporter != nullptr) {
+        m_pProgressReporter->close();
+    }
+    return true;
+}
+
+EnumRequestState MCPCancellationToken::getState() const
+{
+    return static_cast<EnumRequestState>(m_nState.loadAcquire());
+}
+
+bool MCPCancellationToken::isCancelled() const
+{
+    const auto enState = getState();
+    return enState == EnumRequestState::enCancelled || enState == EnumRequestState::enTimedOut;
+}
+
+void MCPCancellationToken::setProgressReporter(const QSharedPointer<MCPProgressReporter> &pProgressReporter)
+{
+    m_pProgressReporter = pProgressReporter;
+}
+
+QSharedPointer<MCPProgressReporter> MCPCancellationToken::getProgressReporter() const
+{
+    return m_pProgressReporter;
+}
+
+MCPCancellationToken *MCPCancellationToken::current()
+{
+    return s_pCurrentToken;
+}
+
+MCPCancellationToken::Scope::Scope(MCPCancellationToken *pToken)
+    : m_pPrevious(s_pCurrentToken)
+{
+    s_pCurrentToken = pToken;
+}
+
+MCPCancellationToken::Scope::~Scope()
+{
+    s_pCurrentToken = m_pPrevious;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file MCPCancellationToken.h
+ * @brief Cooperative cancellation token of an in-flight request (internal implementation)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <MCPProgressReporter.h>
+#include <QAtomicInteger>
+#include <QSharedPointer>
+
+/**
+ * @brief Final state of a request
+ */
+enum class EnumRequestState {
+    enRunning,   // still running
+    enCompleted, // finished and answered normally
+    enCancelled, // notifications/cancelled or session/connection closed, no response is sent
+    enTimedOut   // deadline exceeded, a timeout error has been sent
+};
+
+/**
+ * @brief Cooperative cancellation token
+ *
+ * Responsibilities:
+ * - Record whether a request was cancelled, timed out or completed (first transition wins)
+ * - Let handlers poll for cancellation: MCPCancellationToken::current() is the token of the
+ *   tool call running on the calling thread (see MCPHelper::isToolCallCancelled)
+ * - Carry the call's progress reporter when the request has a _meta.progressToken (see MCPHelper::reportProgress)
+ *
+ * Thread safety:
+ * - State changes are atomic, the token is shared by the server thread and the worker
+ *
+ * Coding conventions:
+ * - Class members add m_ prefix
+ * - { and } should be on separate lines
+ */
+class MCPCancellationToken
+{
+public:
+    MCPCancellationToken();
+
+public:
+    /**
+     * @brief Leave the running state
+     * @param enState enCompleted, enCancelled or enTimedOut
+     * @return true if this call made the transition (the request was still running)
+     */
+    bool finish(EnumRequestState enState);
+
+    EnumRequestState getState() const;
+    bool isCancelled() const; // cancelled or timed out
+
+    // Set before the call is submitted, null if the client did not ask for progress
+    void setProgressReporter(const QSharedPointer<MCPProgressReporter> &pProgressReporter);
+    QSharedPointer<MCPProgressReporter> getProgressReporter() const;
+
+public:
+    /**
+     * @brief Token of the tool call running on the current thread, nullptr outside tool calls
+     */
+    static MCPCancellationToken *current();
+
+    /**
+     * @brief Makes a token current() for the lifetime of the scope
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(MCPCancellationToken *pToken);
+        ~Scope();
+
+    private:
+        MCPCancellationToken *m_pPrevious;
+    };
+
+private:
+    QAtomicInteger<int> m_nState;
+    QSharedPointer<MCPProgressReporter> m_pProgressReporter;
+};
@@ -7,6 +7,7 @@
  */
 
 #include "MCPHelper.h"
+#include "MCPCancellationToken.h"
 #include "MCPInvokeHelper.h"
 #include "MCPMethodHelper.h"
 
@@ -39,3 +40,19 @@ void MCPHelper::setCurrentThreadName(const QString& strThreadName)
 {
     MCPInvokeHelper::setCurrentThreadName(strThreadName);
 }
+
+bool MCPHelper::isToolCallCancelled()
+{
+    auto pToken = MCPCancellationToken::current();
+    return pToken != nullptr && pToken->isCancelled();
+}
+
+bool MCPHelper::reportProgress(double dProgress, double dTotal, const QString& strMessage)
+{
+    auto pToken = MCPCancellationToken::current();
+    if (pToken == nullptr || pToken->isCancelled()) {
+        return false;
+    }
+    auto pProgressReporter = pToken->getProgressReporter();
+    return pProgressReporter != nullptr && pProgressReporter->report(dProgress, dTotal, strMessage);
+}
@@ -79,4 +79,24 @@ public:
      * @return true on success, false on failure
      */
     static void setCurrentThreadName(const QString &strThreadName);
+
+    /**
+     * @brief Whether the tool call running on the current thread was cancelled or timed out
+     * @return true if the handler should stop, false otherwise (also outside tool calls)
+     *
+     * Long running tool handlers should poll this and return early, the client no longer waits for the result.
+     */
+    static bool isToolCallCancelled();
+
+    /**
+     * @brief Report progress of the tool call running on the current thread
+     * @param dProgress Progress so far, must increase between reports
+     * @param dTotal Total, <= 0 if unknown
+     * @param strMessage Optional status message
+     * @return true if a notifications/progress was sent
+     *
+     * Does nothing unless the client passed _meta.progressToken. Reports are rate-limited by the
+     * server ("progressIntervalMs"), handlers may call this as often as they like.
+     */
+    static bool reportProgress(double dProgress, double dTotal = 0, const QString &strMessage = QString());
 };
@@ -0,0 +1,216 @@
+/**
+ * @file MCPInvocationPlan.cpp
+ * @brief Precomputed invocation plan of a QObject tool handler method (internal implementation)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include "MCPInvocationPlan.h"
+#include <MCPLog.h>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QMetaObject>
+#include <QObject>
+
+QSharedPointer<const MCPInvocationPlan> MCPInvocationPlan::create(QObject *pHandler, const QString &strMethodName)
+{
+    if (pHandler == nullptr) {
+        return QSharedPointer<const MCPInvocationPlan>();
+    }
+
+    // Same lookup as MCPMethodHelper::findMethod: methods declared below QObject
+    auto pMetaObject = pHandler->metaObject();
+    QMetaMethod metaMethod;
+    for (int i = QObject::staticMetaObject.methodCount(); i < pMetaObject->methodCount(); ++i) {
+        const QMetaMethod method = pMetaObject->method(i);
+        if (method.name() == strMethodName) {
+            metaMethod = method;
+            break;
+        }
+    }
+    if (!metaMethod.isValid()) {
+        MCP_CORE_LOG_DEBUG() << "MCPInvocationPlan: method not found:" << strMethodName;
+        return QSharedPointer<const MCPInvocationPlan>();
+    }
+    if (metaMethod.parameterCount() > MAX_ARGUMENTS) {
+        MCP_CORE_LOG_WARNING() << "MCPInvocationPlan: too many parameters:" << strMethodName << metaMethod.parameterCount();
+        return QSharedPointer<const MCPInvocationPlan>();
+    }
+
+    QSharedPointer<MCPInvocationPlan> pPlan(new MCPInvocationPlan());
+    pPlan->m_metaMethod = metaMethod;
+    pPlan->m_strMethodName = strMethodName;
+    pPlan->m_byteReturnTypeName = metaMethod.typeName();
+    pPlan->m_returnMetaType = QMetaType::fromName(pPlan->m_byteReturnTypeName);
+
+    const auto lstParameterTypes = metaMethod.parameterTypes();
+    const auto lstParameterNames = metaMethod.parameterNames();
+    for (int i = 0; i < lstParameterTypes.size(); ++i) {
+        Parameter parameter;
+        parameter.byteTypeName = lstParameterTypes[i];
+        parameter.metaType = QMetaType::fromName(parameter.byteTypeName);
+        switch (parameter.metaType.id()) {
+            case QMetaType::QVariant:
+                parameter.enConverter = EnumConverter::enVariant;
+                break;
+            case QMetaType::QJsonValue:
+                parameter.enConverter = EnumConverter::enJsonValue;
+                break;
+            case QMetaType::QJsonObject:
+                parameter.enConverter = EnumConverter::enJsonObject;
+                break;
+            case QMetaType::QJsonArray:
+                parameter.enConverter = EnumConverter::enJsonArray;
+                break;
+            case QMetaType::QString:
+                parameter.enConverter = EnumConverter::enString;
+                break;
+            case QMetaType::Bool:
+                parameter.enConverter = EnumConverter::enBool;
+                break;
+            case QMetaType::Double:
+                parameter.enConverter = EnumConverter::enDouble;
+                break;
+            default:
+                parameter.enConverter = EnumConverter::enGeneric;
+                break;
+        }
+        pPlan->m_arrParameters.append(parameter);
+
+        // The MCP client must use the parameter names declared in C++
+        if (i < lstParameterNames.size()) {
+            pPlan->m_dictPositions.insert(QString::fromLatin1(lstParameterNames[i]), i);
+        }
+    }
+
+    MCP_CORE_LOG_DEBUG().noquote() << "MCPInvocationPlan:" << pHandler->objectName() << strMethodName //
+                                   << "parameters:" << lstParameterNames << lstParameterTypes;
+    return pPlan;
+}
+
+QString MCPInvocationPlan::getMethodName() const
+{
+    return m_strMethodName;
+}
+
+QVariant MCPInvocationPlan::invoke(QObject *pHandler, const QJsonObject &jsonArguments) const
+{
+    if (pHandler == nullptr) {
+        return QVariant();
+    }
+
+    // Missing arguments stay invalid QVariants, like MCPMethodHelper they only pass for QVariant parameters
+    QJsonValue arrJsonValues[MAX_ARGUMENTS];
+    for (auto it = jsonArguments.constBegin(); it != jsonArguments.constEnd(); ++it) {
+        auto itPosition = m_dictPositions.constFind(it.key());
+        if (itPosition == m_dictPositions.constEnd()) {
+            MCP_CORE_LOG_WARNING() << "MCPInvocationPlan::invoke(unknown argument):" << m_strMethodName << it.key();
+            continue;
+        }
+        arrJsonValues[itPosition.value()] = it.value();
+    }
+
+    // Storage must stay alive until after invoke()
+    QVariant storage[MAX_ARGUMENTS];
+    QGenericArgument args[MAX_ARGUMENTS];
+    for (int i = 0; i < m_arrParameters.size(); ++i) {
+        const auto &parameter = m_arrParameters[i];
+        if (!convert(parameter, arrJsonValues[i], storage[i])) {
+            MCP_CORE_LOG_DEBUG().noquote() << "MCPInvocationPlan::invoke(arguments type error):" << m_strMethodName << parameter.byteTypeName;
+            return QVariant();
+        }
+        // A QVariant parameter receives the variant itself, not its payload
+        const void *pData = parameter.enConverter == EnumConverter::enVariant ? static_cast<const void *>(&storage[i]) : storage[i].constData();
+        args[i] = QGenericArgument(parameter.byteTypeName.constData(), pData);
+    }
+
+    QVariant returnValue;
+    if (m_returnMetaType.isValid()) {
+        returnValue = QVariant(m_returnMetaType, nullptr);
+    }
+    QGenericReturnArgument retArg(m_byteReturnTypeName.constData(), const_cast<void *>(returnValue.constData()));
+
+    m_metaMethod.invoke(pHandler,
+                        Qt::DirectConnection, //
+                        retArg,
+                        args[0],
+                        args[1],
+                        args[2],
+                        args[3],
+                        args[4],
+                        args[5],
+                        args[6],
+                        args[7],
+                        args[8],
+                        args[9]);
+    if (!returnValue.isValid()) {
+        MCP_CORE_LOG_WARNING().noquote() << "TOOL-CALL:" << m_strMethodName << "failed.";
+    }
+    return returnValue;
+}
+
+bool MCPInvocationPlan::convert(const Parameter &parameter, const QJsonValue &jsonValue, QVariant &value) const
+{
+    switch (parameter.enConverter) {
+        case EnumConverter::enVariant:
+            value = jsonValue.isUndefined() ? QVariant() : jsonValue.toVariant();
+            return true;
+        case EnumConverter::enJsonValue:
+            if (!jsonValue.isUndefined()) {
+                value = QVariant::fromValue(jsonValue);
+                return true;
+            }
+            break;
+        case EnumConverter::enJsonObject:
+            if (jsonValue.isObject()) {
+                value = QVariant::fromValue(jsonValue.toObject());
+                return true;
+            }
+            break;
+        case EnumConverter::enJsonArray:
+            if (jsonValue.isArray()) {
+                value = QVariant::fromValue(jsonValue.toArray());
+                return true;
+            }
+            break;
+        case EnumConverter::enString:
+            if (jsonValue.isString()) {
+                value = jsonValue.toString();
+                return true;
+            }
+            break;
+        case EnumConverter::enBool:
+            if (jsonValue.isBool()) {
+                value = jsonValue.toBool();
+                return true;
+            }
+            break;
+        case EnumConverter::enDouble:
+            if (jsonValue.isDouble()) {
+                value = jsonValue.toDouble();
+                return true;
+            }
+            break;
+        default:
+            break;
+    }
+
+    // Generic path: same rules as MCPMethodHelper::call
+    value = jsonValue.isUndefined() ? QVariant() : jsonValue.toVariant();
+    if (value.metaType() == parameter.metaType) {
+        return true;
+    }
+    if (value.canConvert(parameter.metaType)) {
+        return value.convert(parameter.metaType);
+    }
+    if (value.userType() == QMetaType::QVariantMap && parameter.metaType.id() == QMetaType::QJsonObject) {
+        value = QVariant::fromValue(QJsonObject::fromVariantMap(value.toMap()));
+        return true;
+    }
+    if (value.userType() == QMetaType::QVariantList && parameter.metaType.id() == QMetaType::QJsonArray) {
+        value = QVariant::fromValue(QJsonArray::fromVariantList(value.toList()));
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file MCPInvocationPlan.h
+ * @brief Precomputed invocation plan of a QObject tool handler method (internal implementation)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMetaMethod>
+#include <QMetaType>
+#include <QSharedPointer>
+#include <QString>
+#include <QVariant>
+
+class QObject;
+
+/**
+ * @brief Invocation plan of one handler method
+ *
+ * Responsibilities:
+ * - Resolve the method, its return and parameter metatypes once, when the handler is bound
+ * - Map JSON argument names to parameter positions
+ * - Pick a converter per parameter so a call only fills the argument array and invokes
+ *
+ * Arguments are read from the call's QJsonObject directly, without going through a QVariantMap.
+ * Conversions that have no fast path fall back to the same QVariant conversion as MCPMethodHelper.
+ *
+ * Thread safety:
+ * - A plan is immutable after create(), invoke() may run on several threads at once
+ *
+ * Coding conventions:
+ * - Class members add m_ prefix
+ * - Pointer types add p prefix
+ * - { and } should be on separate lines
+ */
+class MCPInvocationPlan
+{
+public:
+    // QMetaMethod::invoke takes at most 10 arguments
+    static constexpr int MAX_ARGUMENTS = 10;
+
+public:
+    /**
+     * @brief Build the plan of a handler method
+     * @param pHandler Handler object
+     * @param strMethodName Method name (first matching method declared below QObject)
+     * @return Plan, or null if the method does not exist or has too many parameters
+     */
+    static QSharedPointer<const MCPInvocationPlan> create(QObject *pHandler, const QString &strMethodName);
+
+public:
+    /**
+     * @brief Call the method on the current thread
+     * @param pHandler Handler object (same class the plan was built for)
+     * @param jsonArguments Call arguments, keys are the C++ parameter names
+     * @return Return value, invalid QVariant if an argument cannot be converted
+     */
+    QVariant invoke(QObject *pHandler, const QJsonObject &jsonArguments) const;
+
+    QString getMethodName() const;
+
+private:
+    enum class EnumConverter {
+        enVariant,    // QVariant parameter: pass the JSON value as variant
+        enJsonValue,  // QJsonValue parameter: pass as-is
+        enJsonObject, // QJsonObject parameter: JSON object as-is
+        enJsonArray,  // QJsonArray parameter: JSON array as-is
+        enString,     // QString parameter: JSON string as-is
+        enBool,       // bool parameter: JSON bool as-is
+        enDouble,     // double parameter: JSON number as-is
+        enGeneric     // QVariant conversion (also the fallback of the converters above)
+    };
+
+    struct Parameter
+    {
+        QByteArray byteTypeName;
+        QMetaType metaType;
+        EnumConverter enConverter = EnumConverter::enGeneric;
+    };
+
+private:
+    MCPInvocationPlan() = default;
+    bool convert(const Parameter &parameter, const QJsonValue &jsonValue, QVariant &value) const;
+
+private:
+    QMetaMethod m_metaMethod;
+    QString m_strMethodName;
+    QByteArray m_byteReturnTypeName;
+    QMetaType m_returnMetaType;
+    QList<Parameter> m_arrParameters;
+    QHash<QString, int> m_dictPositions; // argument name -> parameter position
+};
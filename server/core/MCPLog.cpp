@@ -16,6 +16,7 @@ MCPLog::MCPLog(QObject *parent)
     : QObject(parent)
     , m_minLogLevel(LogLevel::Debug)
     , m_bFileLoggingEnabled(false)
+    , m_bConsoleToStderr(false)
 {
     QLoggingCategory::setFilterRules(QStringLiteral("qt*=false"));
     QLoggingCategory::setFilterRules(QStringLiteral("qt.gui*=false"));
@@ -87,10 +88,11 @@ void MCPLog::messageHandler(QtMsgType type, const QMessageLogContext &context, c
     {
         instance()->writeToFile(instance()->formatMessage(type, context, strMsg));
 
+        FILE *pOut = instance()->m_bConsoleToStderr.loadRelaxed() ? stderr : stdout;
         if (type == QtDebugMsg) {
-            fprintf(stdout, "[D] %s\n", qPrintable(strMsg));
+            fprintf(pOut, "[D] %s\n", qPrintable(strMsg));
         } else if (type == QtInfoMsg) {
-            fprintf(stdout, "[I] %s\n", qPrintable(strMsg));
+            fprintf(pOut, "[I] %s\n", qPrintable(strMsg));
         } else if (type == QtWarningMsg) {
             fprintf(stderr, "[W] %s\n", qPrintable(strMsg));
         } else {
@@ -100,7 +102,7 @@ void MCPLog::messageHandler(QtMsgType type, const QMessageLogContext &context, c
     }
 
     // others
-    fprintf(stdout, "[Q] %s\n", qPrintable(strMsg));
+    fprintf(instance()->m_bConsoleToStderr.loadRelaxed() ? stderr : stdout, "[Q] %s\n", qPrintable(strMsg));
 }
 
 void MCPLog::shutdown()
@@ -184,6 +186,11 @@ void MCPLog::setFileLoggingEnabled(bool bEnabled)
     m_bFileLoggingEnabled = bEnabled;
 }
 
+void MCPLog::setConsoleToStderr(bool bEnabled)
+{
+    m_bConsoleToStderr.storeRelaxed(bEnabled);
+}
+
 QString MCPLog::formatMessage(QtMsgType type, const QMessageLogContext &context, const QString &strMsg)
 {
     QString strFormattedMsg = QString("[%1] [%2] [Thread:0x%3] %4")
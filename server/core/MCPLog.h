@@ -2,6 +2,7 @@
 #define MCPLOG_H
 
 #include <MCPServer_global.h>
+#include <QAtomicInteger>
 #include <QDateTime>
 #include <QFile>
 #include <QLoggingCategory>
@@ -48,6 +49,9 @@ public:
     // Enable/disable file logging
     void setFileLoggingEnabled(bool bEnabled);
 
+    // Send all console output to stderr (stdio transport owns stdout)
+    void setConsoleToStderr(bool bEnabled);
+
 private:
     explicit MCPLog(QObject *parent = nullptr);
     // Disable copy constructor and assignment
@@ -73,6 +77,7 @@ private:
     // Data members
     LogLevel m_minLogLevel;
     bool m_bFileLoggingEnabled;
+    QAtomicInteger<bool> m_bConsoleToStderr;
     QSharedPointer<QFile> m_pLogFile;
     QSharedPointer<QTextStream> m_pLogStream;
     QMutex m_fileMutex;
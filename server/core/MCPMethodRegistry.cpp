@@ -0,0 +1,47 @@
+/**
+ * @file MCPMethodRegistry.cpp
+ * @brief Process-wide interning of JSON-RPC method names
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include "MCPMethodRegistry.h"
+#include <QHash>
+#include <QReadLocker>
+#include <QReadWriteLock>
+#include <QWriteLocker>
+
+namespace {
+
+struct MethodTable
+{
+    QReadWriteLock lock;
+    QHash<QString, int> dictMethodIds;
+};
+
+MethodTable &methodTable()
+{
+    static MethodTable table;
+    return table;
+}
+
+} // namespace
+
+int MCPMethodRegistry::intern(const QString &strMethod)
+{
+    auto &table = methodTable();
+    QWriteLocker locker(&table.lock);
+    auto it = table.dictMethodIds.constFind(strMethod);
+    if (it == table.dictMethodIds.constEnd()) {
+        it = table.dictMethodIds.insert(strMethod, static_cast<int>(table.dictMethodIds.size()));
+    }
+    return it.value();
+}
+
+int MCPMethodRegistry::find(const QString &strMethod)
+{
+    auto &table = methodTable();
+    QReadLocker locker(&table.lock);
+    return table.dictMethodIds.value(strMethod, -1);
+}
@@ -0,0 +1,47 @@
+/**
+ * @file MCPMethodRegistry.h
+ * @brief Process-wide interning of JSON-RPC method names
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <QString>
+
+/**
+ * @brief JSON-RPC method name registry
+ *
+ * Responsibilities:
+ * - Give every method name a small, stable integer ID (MCPRouter registers its routes here)
+ * - Resolve the method of an incoming message once, when it is parsed, so the router
+ *   dispatches by array index instead of looking the name up again
+ *
+ * IDs are never reused or removed. Only registered names get an ID: looking up a name sent by
+ * a client never grows the table.
+ *
+ * Thread safety:
+ * - Routes register on the dispatcher's thread, messages are parsed on transport threads,
+ *   all methods are thread-safe
+ *
+ * Coding conventions:
+ * - Class members add m_ prefix
+ * - { and } should be on separate lines
+ */
+class MCPMethodRegistry
+{
+public:
+    /**
+     * @brief ID of a method name, registering it if needed
+     * @param strMethod Method name (e.g. "tools/list")
+     * @return Method ID (>= 0)
+     */
+    static int intern(const QString &strMethod);
+
+    /**
+     * @brief ID of a registered method name
+     * @param strMethod Method name
+     * @return Method ID, -1 for names that were never registered
+     */
+    static int find(const QString &strMethod);
+};
@@ -0,0 +1,273 @@
+/**
+ * @file MCPMetrics.cpp
+ * @brief Process-wide metrics registry
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include "MCPMetrics.h"
+#include <QStringList>
+#include <QtAlgorithms>
+#include <QtMath>
+#include <utility>
+
+// ============================================================================
+// MCPLatencyHistogram
+// ============================================================================
+
+void MCPLatencyHistogram::record(qint64 nMicros)
+{
+    const quint64 nValue = nMicros > 0 ? static_cast<quint64>(nMicros) : 0;
+    m_arrCounts[bucketIndex(nValue)].fetchAndAddRelaxed(1);
+    m_nCount.fetchAndAddRelaxed(1);
+    m_nSumMicros.fetchAndAddRelaxed(nValue);
+}
+
+quint64 MCPLatencyHistogram::getCount() const
+{
+    return m_nCount.loadRelaxed();
+}
+
+quint64 MCPLatencyHistogram::getSumMicros() const
+{
+    return m_nSumMicros.loadRelaxed();
+}
+
+quint64 MCPLatencyHistogram::getQuantileMicros(double dQuantile) const
+{
+    // Snapshot first: the total and the walk must agree while other threads keep recording
+    quint64 arrCounts[BUCKET_COUNT];
+    quint64 nTotal = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        arrCounts[i] = m_arrCounts[i].loadRelaxed();
+        nTotal += arrCounts[i];
+    }
+    if (nTotal == 0) {
+        return 0;
+    }
+
+    const quint64 nRank = qMax<quint64>(1, static_cast<quint64>(qCeil(qBound(0.0, dQuantile, 1.0) * nTotal)));
+    quint64 nSeen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        nSeen += arrCounts[i];
+        if (nSeen >= nRank) {
+            return bucketUpperBound(i);
+        }
+    }
+    return bucketUpperBound(BUCKET_COUNT - 1);
+}
+
+int MCPLatencyHistogram::bucketIndex(quint64 nMicros)
+{
+    // First octave is linear: values below SUB_BUCKETS get a bucket each
+    if (nMicros < static_cast<quint64>(SUB_BUCKETS)) {
+        return static_cast<int>(nMicros);
+    }
+    const int nMsb = 63 - qCountLeadingZeroBits(nMicros);
+    const int nShift = nMsb - SUB_BUCKET_BITS;
+    const int nIndex = (nShift + 1) * SUB_BUCKETS + static_cast<int>((nMicros >> nShift) & (SUB_BUCKETS - 1));
+    return qMin(nIndex, BUCKET_COUNT - 1);
+}
+
+quint64 MCPLatencyHistogram::bucketUpperBound(int nIndex)
+{
+    if (nIndex < SUB_BUCKETS) {
+        return static_cast<quint64>(nIndex) + 1;
+    }
+    const int nShift = nIndex / SUB_BUCKETS - 1;
+    const quint64 nSubBucket = static_cast<quint64>(nIndex % SUB_BUCKETS);
+    return ((SUB_BUCKETS + nSubBucket) << nShift) + (quint64(1) << nShift);
+}
+
+// ============================================================================
+// MCPMetrics
+// ============================================================================
+
+namespace
+{
+    const double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+    QByteArray formatValue(double dValue)
+    {
+        return QByteArray::number(dValue, 'g', 15);
+    }
+
+    // Label values are escaped as the exposition format requires (backslash, quote, newline)
+    QByteArray escapeLabel(const QString &strValue)
+    {
+        QByteArray byteValue = strValue.toUtf8();
+        byteValue.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+        return byteValue;
+    }
+}
+
+MCPMetrics::MCPMetrics()
+    : m_nCancelledToolCalls(0)
+    , m_nConnections(0)
+    , m_nBytesIn(0)
+    , m_nBytesOut(0)
+    , m_nOutboundQueued(0)
+{}
+
+MCPMetrics::~MCPMetrics()
+{
+    qDeleteAll(m_dictMethods);
+    qDeleteAll(m_dictTools);
+}
+
+MCPMetrics *MCPMetrics::instance()
+{
+    static MCPMetrics instance;
+    return &instance;
+}
+
+MCPMetrics::Series *MCPMetrics::getSeries(QHash<QString, Series *> &dictSeries, const QString &strName)
+{
+    {
+        QReadLocker locker(&m_lock);
+        if (auto pSeries = dictSeries.value(strName, nullptr)) {
+            return pSeries;
+        }
+    }
+
+    QWriteLocker locker(&m_lock);
+    auto &pSeries = dictSeries[strName];
+    if (pSeries == nullptr) {
+        pSeries = new Series();
+    }
+    return pSeries;
+}
+
+void MCPMetrics::recordRequest(const QString &strMethod, qint64 nMicros, bool bError)
+{
+    auto pSeries = getSeries(m_dictMethods, strMethod);
+    pSeries->nTotal.fetchAndAddRelaxed(1);
+    if (bError) {
+        pSeries->nErrors.fetchAndAddRelaxed(1);
+    }
+    pSeries->latency.record(nMicros);
+}
+
+void MCPMetrics::recordToolCall(const QString &strToolName, qint64 nMicros, bool bError)
+{
+    auto pSeries = getSeries(m_dictTools, strToolName);
+    pSeries->nTotal.fetchAndAddRelaxed(1);
+    if (bError) {
+        pSeries->nErrors.fetchAndAddRelaxed(1);
+    }
+    pSeries->latency.record(nMicros);
+}
+
+void MCPMetrics::addCancelledToolCall()
+{
+    m_nCancelledToolCalls.fetchAndAddRelaxed(1);
+}
+
+void MCPMetrics::addConnections(int nDelta)
+{
+    m_nConnections.fetchAndAddRelaxed(nDelta);
+}
+
+void MCPMetrics::addBytesIn(qint64 nBytes)
+{
+    m_nBytesIn.fetchAndAddRelaxed(static_cast<quint64>(nBytes));
+}
+
+void MCPMetrics::addBytesOut(qint64 nBytes)
+{
+    m_nBytesOut.fetchAndAddRelaxed(static_cast<quint64>(nBytes));
+}
+
+void MCPMetrics::addOutboundQueued(qint64 nDelta)
+{
+    m_nOutboundQueued.fetchAndAddRelaxed(nDelta);
+}
+
+qint64 MCPMetrics::getConnectionCount() const
+{
+    return m_nConnections.loadRelaxed();
+}
+
+quint64 MCPMetrics::getBytesIn() const
+{
+    return m_nBytesIn.loadRelaxed();
+}
+
+quint64 MCPMetrics::getBytesOut() const
+{
+    return m_nBytesOut.loadRelaxed();
+}
+
+qint64 MCPMetrics::getOutboundQueued() const
+{
+    return m_nOutboundQueued.loadRelaxed();
+}
+
+void MCPMetrics::appendMetric(QByteArray &byteText, const char *pName, const char *pType, const char *pHelp, double dValue)
+{
+    byteText.append("# HELP ").append(pName).append(' ').append(pHelp).append('\n');
+    byteText.append("# TYPE ").append(pName).append(' ').append(pType).append('\n');
+    byteText.append(pName).append(' ').append(formatValue(dValue)).append('\n');
+}
+
+void MCPMetrics::appendSeries(QByteArray &byteText, const char *pPrefix, const char *pLabel, const QString &strSubject, const QHash<QString, Series *> &dictSeries)
+{
+    if (dictSeries.isEmpty()) {
+        return;
+    }
+    const QByteArray bytePrefix(pPrefix);
+    const QByteArray byteSubject = strSubject.toUtf8();
+
+    // Stable output order, scrapes diff cleanly
+    QStringList lstNames = dictSeries.keys();
+    lstNames.sort();
+    QList<QByteArray> lstLabels;
+    for (const auto &strName : std::as_const(lstNames)) {
+        lstLabels.append(QByteArray(pLabel) + "=\"" + escapeLabel(strName) + '"');
+    }
+
+    const QByteArray byteTotal = bytePrefix + "s_total";
+    byteText.append("# HELP ").append(byteTotal).append(' ').append(byteSubject).append(" handled\n");
+    byteText.append("# TYPE ").append(byteTotal).append(" counter\n");
+    for (int i = 0; i < lstNames.size(); ++i) {
+        byteText.append(byteTotal).append('{').append(lstLabels[i]).append("} ").append(formatValue(dictSeries[lstNames[i]]->nTotal.loadRelaxed())).append('\n');
+    }
+
+    const QByteArray byteErrors = bytePrefix + "_errors_total";
+    byteText.append("# HELP ").append(byteErrors).append(' ').append(byteSubject).append(" answered with an error\n");
+    byteText.append("# TYPE ").append(byteErrors).append(" counter\n");
+    for (int i = 0; i < lstNames.size(); ++i) {
+        byteText.append(byteErrors).append('{').append(lstLabels[i]).append("} ").append(formatValue(dictSeries[lstNames[i]]->nErrors.loadRelaxed())).append('\n');
+    }
+
+    const QByteArray byteDuration = bytePrefix + "_duration_seconds";
+    byteText.append("# HELP ").append(byteDuration).append(' ').append(byteSubject).append(" latency\n");
+    byteText.append("# TYPE ").append(byteDuration).append(" summary\n");
+    for (int i = 0; i < lstNames.size(); ++i) {
+        const auto &latency = dictSeries[lstNames[i]]->latency;
+        for (double dQuantile : QUANTILES) {
+            byteText.append(byteDuration).append('{').append(lstLabels[i]).append(",quantile=\"").append(formatValue(dQuantile)).append("\"} ");
+            byteText.append(formatValue(latency.getQuantileMicros(dQuantile) / 1e6)).append('\n');
+        }
+        byteText.append(byteDuration).append("_sum{").append(lstLabels[i]).append("} ").append(formatValue(latency.getSumMicros() / 1e6)).append('\n');
+        byteText.append(byteDuration).append("_count{").append(lstLabels[i]).append("} ").append(formatValue(latency.getCount())).append('\n');
+    }
+}
+
+QByteArray MCPMetrics::toPrometheusText() const
+{
+    QByteArray byteText;
+    byteText.reserve(4096);
+    {
+        QReadLocker locker(&m_lock);
+        appendSeries(byteText, "mcp_request", "method", "JSON-RPC requests", m_dictMethods);
+        appendSeries(byteText, "mcp_tool_call", "tool", "Tool calls", m_dictTools);
+    }
+    appendMetric(byteText, "mcp_tool_calls_cancelled_total", "counter", "Tool calls cancelled by the client or its disconnect", m_nCancelledToolCalls.loadRelaxed());
+    appendMetric(byteText, "mcp_connections", "gauge", "Open transport connections", m_nConnections.loadRelaxed());
+    appendMetric(byteText, "mcp_received_bytes_total", "counter", "Bytes read from connections", m_nBytesIn.loadRelaxed());
+    appendMetric(byteText, "mcp_sent_bytes_total", "counter", "Bytes written to connections", m_nBytesOut.loadRelaxed());
+    appendMetric(byteText, "mcp_outbound_queued_bytes", "gauge", "Bytes waiting in connection write queues", m_nOutboundQueued.loadRelaxed());
+    return byteText;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file MCPMetrics.h
+ * @brief Process-wide metrics registry, rendered in the Prometheus text format on GET /metrics
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+
+/**
+ * @brief HDR-style latency histogram
+ *
+ * Log-linear buckets: every power of two is split into SUB_BUCKETS equal buckets, so any recorded
+ * value is known within 1/SUB_BUCKETS (12.5%) from 1 us up to days, in a fixed array of counters.
+ * record() is a few atomic increments, no lock and no allocation.
+ *
+ * Coding conventions:
+ * - Class members add m_ prefix
+ * - { and } should be on separate lines
+ */
+class MCPLatencyHistogram
+{
+public:
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int OCTAVES = 36; // up to 2^39 us
+    static constexpr int BUCKET_COUNT = (OCTAVES + 1) * SUB_BUCKETS;
+
+public:
+    void record(qint64 nMicros);
+
+    quint64 getCount() const;
+    quint64 getSumMicros() const;
+
+    /**
+     * @brief Value at a quantile
+     * @param dQuantile 0..1
+     * @return Upper bound of the bucket holding the quantile (us), 0 if nothing was recorded
+     */
+    quint64 getQuantileMicros(double dQuantile) const;
+
+private:
+    static int bucketIndex(quint64 nMicros);
+    static quint64 bucketUpperBound(int nIndex);
+
+private:
+    QAtomicInteger<quint64> m_arrCounts[BUCKET_COUNT];
+    QAtomicInteger<quint64> m_nCount;
+    QAtomicInteger<quint64> m_nSumMicros;
+};
+
+/**
+ * @brief Metrics registry
+ *
+ * Responsibilities:
+ * - Request count, error count and latency per JSON-RPC method and per tool
+ * - Transport counters: open connections, bytes in/out, bytes waiting in outbound write queues
+ * - Render everything in the Prometheus text exposition format (latencies as summaries with
+ *   quantiles taken from the HDR histograms)
+ *
+ * Server state that already has an owner (sessions, tool executor, result cache...) is not copied
+ * here, MCPServerHandler samples it when the page is rendered (see appendMetric)
+ *
+ * Thread safety:
+ * - Counters and histograms are atomics, recorded from any thread without a lock
+ * - The name -> series maps are only write-locked the first time a method or tool is seen
+ * - Series are never removed: method names are the routed ones and tool names the registered
+ *   ones, so the label sets stay bounded
+ *
+ * Coding conventions:
+ * - Class members add m_ prefix
+ * - Pointer types add p prefix
+ * - { and } should be on separate lines
+ */
+class MCPMetrics
+{
+public:
+    static MCPMetrics *instance();
+
+public:
+    // JSON-RPC method handled (synchronously answered methods by MCPPerformanceMiddleware, tools/call on completion)
+    void recordRequest(const QString &strMethod, qint64 nMicros, bool bError);
+    // Tool call answered (result, error or timeout)
+    void recordToolCall(const QString &strToolName, qint64 nMicros, bool bError);
+    void addCancelledToolCall();
+
+    // Transport
+    void addConnections(int nDelta);
+    void addBytesIn(qint64 nBytes);
+    void addBytesOut(qint64 nBytes);
+    void addOutboundQueued(qint64 nDelta);
+
+    qint64 getConnectionCount() const;
+    quint64 getBytesIn() const;
+    quint64 getBytesOut() const;
+    qint64 getOutboundQueued() const;
+
+public:
+    /**
+     * @brief Render the registry
+     * @return Prometheus text exposition (version 0.0.4)
+     */
+    QByteArray toPrometheusText() const;
+
+    /**
+     * @brief Append one unlabelled sample with its HELP/TYPE lines
+     * @param byteText Page being rendered
+     * @param pName Metric name
+     * @param pType "counter" or "gauge"
+     * @param pHelp Help text
+     * @param dValue Value
+     */
+    static void appendMetric(QByteArray &byteText, const char *pName, const char *pType, const char *pHelp, double dValue);
+
+private:
+    struct Series
+    {
+        QAtomicInteger<quint64> nTotal;
+        QAtomicInteger<quint64> nErrors;
+        MCPLatencyHistogram latency;
+    };
+
+private:
+    MCPMetrics();
+    ~MCPMetrics();
+    Q_DISABLE_COPY(MCPMetrics)
+
+    Series *getSeries(QHash<QString, Series *> &dictSeries, const QString &strName);
+    static void appendSeries(QByteArray &byteText, const char *pPrefix, const char *pLabel, const QString &strSubject, const QHash<QString, Series *> &dictSeries);
+
+private:
+    mutable QReadWriteLock m_lock;
+    QHash<QString, Series *> m_dictMethods;
+    QHash<QString, Series *> m_dictTools;
+
+    QAtomicInteger<quint64> m_nCancelledToolCalls;
+    QAtomicInteger<qint64> m_nConnections;
+    QAtomicInteger<quint64> m_nBytesIn;
+    QAtomicInteger<quint64> m_nBytesOut;
+    QAtomicInteger<qint64> m_nOutboundQueued;
+};
@@ -7,6 +7,7 @@
  */
 
 #include <MCPLog.h>
+#include <MCPNotificationScheduler.h>
 #include <MCPNotificationHandlerBase.h>
 #include <MCPPendingNotification.h>
 #include <MCPServer.h>
@@ -32,6 +33,12 @@ void MCPNotificationHandlerBase::broadcastNotification(const QString &strMethod,
     notification["method"] = strMethod;
     notification["params"] = objParams;
 
+    // 即时推送的会话（SSE/Stdio）汇总后一次发出
+    QStringList lstPushSessionIds;
+    auto pScheduler = m_pServer->getNotificationScheduler();
+    MCPPendingNotification pendingNotification;
+    bool bKnownMethod = toPendingNotification(strMethod, objParams, pendingNotification);
+
     // 遍历所有会话，根据传输类型决定处理方式
     foreach (const auto &pSession, allSessions) {
         if (pSession == nullptr) {
@@ -40,29 +47,26 @@ void MCPNotificationHandlerBase::broadcastNotification(const QString &strMethod,
 
         QString strSessionId = pSession->getSessionId();
 
-        if (pSession->isStreamableTransport()) {
-            // StreamableTransport：缓存通知标记，等待下次请求时发送
-            // 根据方法名判断通知类型
-            if (strMethod == "notifications/resources/updated") {
-                QString strUri = objParams.value("uri").toString();
-                pSession->addResourceChangedNotification(strUri);
-            } else if (strMethod == "notifications/resources/list_changed") {
-                pSession->addResourcesListChangedNotification();
-            } else if (strMethod == "notifications/tools/list_changed") {
-                pSession->addToolsListChangedNotification();
-            } else if (strMethod == "notifications/prompts/list_changed") {
-                pSession->addPromptsListChangedNotification();
+        if (pSession->isStreamableTransport() && pSession->getSseConnectionId() == 0) {
+            // StreamableTransport且没有打开GET流：缓存通知标记，等待下次请求时发送
+            if (bKnownMethod) {
+                pSession->addPendingNotification(pendingNotification);
             } else {
-                // 未知的通知类型，使用通用方法（向后兼容）
-                MCP_CORE_LOG_WARNING() << "MCPNotificationHandlerBase: method:" << strMethod;
+                MCP_CORE_LOG_WARNING() << "MCPNotificationHandlerBase: unknown:" << strMethod;
             }
             //MCP_CORE_LOG_DEBUG() << "MCPNotificationHandlerBase: StreamableTransport id:" << strSessionId << "method:" << strMethod;
         } else {
-            // SSE传输：通过信号发送通知
-            emit notificationRequested(strSessionId, notification);
-            MCP_CORE_LOG_DEBUG() << "MCPNotificationHandlerBase id:" << strSessionId << "method:" << strMethod << "notification:" << notification;
+            // SSE传输（以及打开了GET流的Streamable会话）：汇总后扇出（超出每会话频率上限的由调度器延迟发送）
+            if (!bKnownMethod || pScheduler->admit(strSessionId, pendingNotification)) {
+                lstPushSessionIds.append(strSessionId);
+            }
         }
     }
+
+    if (!lstPushSessionIds.isEmpty()) {
+        MCP_CORE_LOG_DEBUG() << "MCPNotificationHandlerBase: broadcast method:" << strMethod << "sessions:" << lstPushSessionIds.size();
+        emit notificationFanOutRequested(lstPushSessionIds, notification);
+    }
 }
 
 void MCPNotificationHandlerBase::sendNotificationToSubscribers(const QString &strMethod, const QJsonObject &objParams, const QSet<QString> &setSubscribedSessionIds)
@@ -79,33 +83,53 @@ void MCPNotificationHandlerBase::sendNotificationToSubscribers(const QString &st
 
     auto pSessionService = m_pServer->getSessionService();
 
+    // 即时推送的会话（SSE/Stdio）汇总后一次发出
+    QStringList lstPushSessionIds;
+    auto pScheduler = m_pServer->getNotificationScheduler();
+    MCPPendingNotification pendingNotification;
+    bool bKnownMethod = toPendingNotification(strMethod, objParams, pendingNotification);
+
     // 遍历每个订阅者，根据传输类型决定处理方式
     for (const QString &strSessionId : setSubscribedSessionIds) {
         auto pSession = pSessionService->getSessionBySessionId(strSessionId);
         if (pSession == nullptr) {
             continue;
         }
-        if (pSession->isStreamableTransport()) {
-            // StreamableTransport：缓存通知标记，等待下次请求时发送
-            // 对于资源变化通知，需要包含URI信息
-            if (strMethod == "notifications/resources/updated") {
-                QString strUri = objParams.value("uri").toString();
-                pSession->addResourceChangedNotification(strUri);
-            } else if (strMethod == "notifications/resources/list_changed") {
-                pSession->addResourcesListChangedNotification();
-            } else if (strMethod == "notifications/tools/list_changed") {
-                pSession->addToolsListChangedNotification();
-            } else if (strMethod == "notifications/prompts/list_changed") {
-                pSession->addPromptsListChangedNotification();
+        if (pSession->isStreamableTransport() && pSession->getSseConnectionId() == 0) {
+            // StreamableTransport且没有打开GET流：缓存通知标记，等待下次请求时发送
+            if (bKnownMethod) {
+                pSession->addPendingNotification(pendingNotification);
             } else {
-                // 未知的通知类型，使用通用方法（向后兼容）
                 MCP_CORE_LOG_WARNING() << "MCPNotificationHandlerBase: unknown:" << strMethod;
             }
             //MCP_CORE_LOG_DEBUG() << "MCPNotificationHandlerBase: StreamableTransport id:" << strSessionId << "method:" << strMethod;
         } else {
-            // SSE传输：通过信号发送通知
-            emit notificationRequested(strSessionId, notification);
-            MCP_CORE_LOG_DEBUG() << "MCPNotificationHandlerBase: id:" << strSessionId << "method:" << strMethod;
+            // SSE传输（以及打开了GET流的Streamable会话）：汇总后扇出（超出每会话频率上限的由调度器延迟发送）
+            if (!bKnownMethod || pScheduler->admit(strSessionId, pendingNotification)) {
+                lstPushSessionIds.append(strSessionId);
+            }
         }
     }
+
+    if (!lstPushSessionIds.isEmpty()) {
+        MCP_CORE_LOG_DEBUG() << "MCPNotificationHandlerBase: method:" << strMethod << "subscribers:" << lstPushSessionIds.size();
+        emit notificationFanOutRequested(lstPushSessionIds, notification);
+    }
+}
+
+bool MCPNotificationHandlerBase::toPendingNotification(const QString &strMethod, const QJsonObject &objParams, MCPPendingNotification &notification)
+{
+    if (strMethod == "notifications/resources/updated") {
+        // 资源变化通知需要包含URI信息
+        notification = MCPPendingNotification(MCPPendingNotificationType::ResourceChanged, objParams.value("uri").toString());
+    } else if (strMethod == "notifications/resources/list_changed") {
+        notification = MCPPendingNotification(MCPPendingNotificationType::ResourcesListChanged);
+    } else if (strMethod == "notifications/tools/list_changed") {
+        notification = MCPPendingNotification(MCPPendingNotificationType::ToolsListChanged);
+    } else if (strMethod == "notifications/prompts/list_changed") {
+        notification = MCPPendingNotification(MCPPendingNotificationType::PromptsListChanged);
+    } else {
+        return false;
+    }
+    return true;
 }
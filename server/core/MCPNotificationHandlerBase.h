@@ -14,9 +14,11 @@
 #include <QSet>
 #include <QSharedPointer>
 #include <QString>
+#include <QStringList>
 
 class MCPServer;
 class MCPSession;
+class MCPPendingNotification;
 
 /**
  * @brief MCP通知处理器基类
@@ -52,6 +54,13 @@ signals:
      */
     void notificationRequested(const QString &strSessionId, const QJsonObject &objNotification);
 
+    /**
+     * @brief 同一通知发送到多个即时推送会话（SSE/Stdio），接收方只序列化一次
+     * @param lstSessionIds 会话ID列表
+     * @param objNotification 通知消息
+     */
+    void notificationFanOutRequested(const QStringList &lstSessionIds, const QJsonObject &objNotification);
+
 protected:
     /**
      * @brief 发送通知到所有会话（广播通知）
@@ -68,6 +77,16 @@ protected:
      */
     void sendNotificationToSubscribers(const QString &strMethod, const QJsonObject &objParams, const QSet<QString> &setSubscribedSessionIds);
 
+private:
+    /**
+     * @brief 通知方法名转换为通知类型（StreamableTransport缓存和推送配额都按类型去重）
+     * @param strMethod 通知方法名
+     * @param objParams 通知参数
+     * @param notification 输出通知类型
+     * @return 已知的通知方法返回true
+     */
+    static bool toPendingNotification(const QString &strMethod, const QJsonObject &objParams, MCPPendingNotification &notification);
+
 protected:
     MCPServer *m_pServer; // 服务器对象，通过它获取各个服务
 };
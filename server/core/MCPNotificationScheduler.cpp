@@ -0,0 +1,201 @@
+/**
+ * @file MCPNotificationScheduler.cpp
+ * @brief MCP通知调度器实现
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include <MCPLog.h>
+#include <MCPNotificationScheduler.h>
+#include <QTimer>
+#include <utility>
+
+MCPNotificationScheduler::MCPNotificationScheduler(QObject *pParent)
+    : QObject(pParent)
+    , m_bResourcesListDirty(false)
+    , m_bToolsListDirty(false)
+    , m_bPromptsListDirty(false)
+    , m_pFlushTimer(new QTimer(this))
+    , m_nCoalesceWindowMs(DEFAULT_COALESCE_WINDOW_MS)
+    , m_nMaxPerSessionPerSecond(DEFAULT_MAX_PER_SESSION_PER_SECOND)
+    , m_nProgressIntervalMs(DEFAULT_PROGRESS_INTERVAL_MS)
+{
+    m_clock.start();
+    m_pFlushTimer->setSingleShot(true);
+    QObject::connect(m_pFlushTimer, &QTimer::timeout, this, &MCPNotificationScheduler::onFlushTimer);
+}
+
+MCPNotificationScheduler::~MCPNotificationScheduler() {}
+
+void MCPNotificationScheduler::setLimits(int nCoalesceWindowMs, int nMaxPerSessionPerSecond)
+{
+    m_nCoalesceWindowMs = nCoalesceWindowMs > 0 ? nCoalesceWindowMs : 0;
+    m_nMaxPerSessionPerSecond = nMaxPerSessionPerSecond > 0 ? nMaxPerSessionPerSecond : 0;
+    MCP_CORE_LOG_INFO() << "MCPNotificationScheduler: coalesce(ms):" << m_nCoalesceWindowMs << "maxPerSessionPerSecond:" << m_nMaxPerSessionPerSecond;
+}
+
+void MCPNotificationScheduler::setProgressInterval(int nProgressIntervalMs)
+{
+    m_nProgressIntervalMs = nProgressIntervalMs > 0 ? nProgressIntervalMs : 0;
+    MCP_CORE_LOG_INFO() << "MCPNotificationScheduler: progressInterval(ms):" << m_nProgressIntervalMs;
+}
+
+int MCPNotificationScheduler::getProgressInterval() const
+{
+    return m_nProgressIntervalMs;
+}
+
+bool MCPNotificationScheduler::admit(const QString &strSessionId, const MCPPendingNotification &notification)
+{
+    if (m_nMaxPerSessionPerSecond <= 0) {
+        return true;
+    }
+
+    auto &budget = m_dictBudgets[strSessionId];
+    const qint64 nNow = m_clock.elapsed();
+    if (nNow - budget.nWindowStart >= RATE_WINDOW_MS) {
+        budget.nWindowStart = nNow;
+        budget.nSent = 0;
+    }
+
+    // 已有延迟的通知时新通知也排在后面，保证顺序
+    if (budget.nSent < m_nMaxPerSessionPerSecond && budget.lstDeferred.isEmpty()) {
+        ++budget.nSent;
+        return true;
+    }
+
+    // 超出配额：同一通知只保留一份，发送时按最新状态生成
+    if (!budget.lstDeferred.contains(notification)) {
+        budget.lstDeferred.append(notification);
+    }
+    m_setDeferredSessions.insert(strSessionId);
+    scheduleFlush();
+    return false;
+}
+
+void MCPNotificationScheduler::onResourceContentChanged(const QString &strUri)
+{
+    if (m_nCoalesceWindowMs <= 0) {
+        emit resourceContentChanged(strUri);
+        return;
+    }
+    m_dictDirtyUris.insert(strUri, false);
+    scheduleFlush();
+}
+
+void MCPNotificationScheduler::onResourceDeleted(const QString &strUri)
+{
+    if (m_nCoalesceWindowMs <= 0) {
+        emit resourceDeleted(strUri);
+        return;
+    }
+    m_dictDirtyUris.insert(strUri, true);
+    scheduleFlush();
+}
+
+void MCPNotificationScheduler::onResourcesListChanged()
+{
+    if (m_nCoalesceWindowMs <= 0) {
+        emit resourcesListChanged();
+        return;
+    }
+    m_bResourcesListDirty = true;
+    scheduleFlush();
+}
+
+void MCPNotificationScheduler::onToolsListChanged()
+{
+    if (m_nCoalesceWindowMs <= 0) {
+        emit toolsListChanged();
+        return;
+    }
+    m_bToolsListDirty = true;
+    scheduleFlush();
+}
+
+void MCPNotificationScheduler::onPromptsListChanged()
+{
+    if (m_nCoalesceWindowMs <= 0) {
+        emit promptsListChanged();
+        return;
+    }
+    m_bPromptsListDirty = true;
+    scheduleFlush();
+}
+
+void MCPNotificationScheduler::onSessionRemoved(const QString &strSessionId)
+{
+    m_dictBudgets.remove(strSessionId);
+    m_setDeferredSessions.remove(strSessionId);
+}
+
+void MCPNotificationScheduler::scheduleFlush()
+{
+    // 定时器可能正在等待配额窗口（最长1秒），新的变化不应等那么久
+    if (!m_pFlushTimer->isActive() || m_pFlushTimer->remainingTime() > m_nCoalesceWindowMs) {
+        m_pFlushTimer->start(m_nCoalesceWindowMs);
+    }
+}
+
+void MCPNotificationScheduler::onFlushTimer()
+{
+    // 1. 合并后的变化：每个URI/列表只发一次
+    auto dictDirtyUris = std::exchange(m_dictDirtyUris, QHash<QString, bool>());
+    for (auto it = dictDirtyUris.cbegin(); it != dictDirtyUris.cend(); ++it) {
+        if (it.value()) {
+            emit resourceDeleted(it.key());
+        } else {
+            emit resourceContentChanged(it.key());
+        }
+    }
+    if (std::exchange(m_bResourcesListDirty, false)) {
+        emit resourcesListChanged();
+    }
+    if (std::exchange(m_bToolsListDirty, false)) {
+        emit toolsListChanged();
+    }
+    if (std::exchange(m_bPromptsListDirty, false)) {
+        emit promptsListChanged();
+    }
+
+    // 2. 配额已恢复的会话：发送延迟的通知（先收集，发送过程中不修改容器）
+    const qint64 nNow = m_clock.elapsed();
+    qint64 nNextResetMs = RATE_WINDOW_MS;
+    QList<QPair<QString, QList<MCPPendingNotification>>> lstReady;
+    for (auto it = m_setDeferredSessions.begin(); it != m_setDeferredSessions.end();) {
+        auto itBudget = m_dictBudgets.find(*it);
+        if (itBudget == m_dictBudgets.end() || itBudget->lstDeferred.isEmpty()) {
+            it = m_setDeferredSessions.erase(it);
+            continue;
+        }
+
+        auto &budget = itBudget.value();
+        if (nNow - budget.nWindowStart >= RATE_WINDOW_MS) {
+            budget.nWindowStart = nNow;
+            budget.nSent = 0;
+        }
+        const int nQuota = m_nMaxPerSessionPerSecond > 0 ? m_nMaxPerSessionPerSecond - budget.nSent : static_cast<int>(budget.lstDeferred.size());
+        if (nQuota > 0) {
+            auto lstNotifications = budget.lstDeferred.mid(0, nQuota);
+            budget.lstDeferred.remove(0, lstNotifications.size());
+            budget.nSent += static_cast<int>(lstNotifications.size());
+            lstReady.append(qMakePair(*it, lstNotifications));
+        }
+
+        if (budget.lstDeferred.isEmpty()) {
+            it = m_setDeferredSessions.erase(it);
+        } else {
+            nNextResetMs = qMin(nNextResetMs, budget.nWindowStart + RATE_WINDOW_MS - nNow);
+            ++it;
+        }
+    }
+    for (const auto &ready : std::as_const(lstReady)) {
+        emit deferredNotificationsReady(ready.first, ready.second);
+    }
+
+    // 3. 还有延迟的通知：在最早的配额窗口恢复时再检查
+    if (!m_pFlushTimer->isActive() && !m_setDeferredSessions.isEmpty()) {
+        m_pFlushTimer->start(static_cast<int>(qMax<qint64>(1, nNextResetMs)));
+    }
+}
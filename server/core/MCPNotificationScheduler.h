@@ -0,0 +1,131 @@
+/**
+ * @file MCPNotificationScheduler.h
+ * @brief MCP通知调度器（合并高频变化、限制每个会话的推送频率）
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <MCPPendingNotification.h>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+class QTimer;
+
+/**
+ * @brief MCP通知调度器
+ *
+ * 职责：
+ * - 位于各服务（资源/工具/提示词）和MCPServerHandler之间
+ * - 合并窗口内同一URI（或同一列表）的重复变化，窗口到期时只发一次，发送时读取的是最新状态
+ * - 限制每个即时推送会话（SSE/Stdio）每秒的通知数，超出部分去重后延迟到下一个配额窗口
+ *
+ * 设计说明：
+ * - 只在MCPServer线程中访问，不加锁
+ * - 合并窗口为 0 时直接转发，不经过定时器
+ * - 没有打开GET流的StreamableTransport会话，通知本来就缓存到下次请求，不受频率限制
+ *
+ * 编码规范：
+ * - 类成员添加 m_ 前缀
+ * - 指针类型添加 p 前缀
+ * - { 和 } 要单独一行
+ */
+class MCPNotificationScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_COALESCE_WINDOW_MS = 100;
+    static constexpr int DEFAULT_MAX_PER_SESSION_PER_SECOND = 20;
+    static constexpr int RATE_WINDOW_MS = 1000;
+    static constexpr int DEFAULT_PROGRESS_INTERVAL_MS = 100;
+
+public:
+    explicit MCPNotificationScheduler(QObject *pParent = nullptr);
+    virtual ~MCPNotificationScheduler();
+
+public:
+    /**
+     * @brief 设置合并窗口和每会话频率上限
+     * @param nCoalesceWindowMs 合并窗口（毫秒），<= 0 表示不合并
+     * @param nMaxPerSessionPerSecond 每个会话每秒最多推送的通知数，<= 0 表示不限制
+     */
+    void setLimits(int nCoalesceWindowMs, int nMaxPerSessionPerSecond);
+
+    /**
+     * @brief 设置同一工具调用两次进度通知（notifications/progress）的最小间隔
+     * @param nProgressIntervalMs 最小间隔（毫秒），<= 0 表示不限制
+     */
+    void setProgressInterval(int nProgressIntervalMs);
+    int getProgressInterval() const;
+
+    /**
+     * @brief 即时推送前检查会话配额
+     * @param strSessionId 会话ID
+     * @param notification 通知
+     * @return true表示立即发送；false表示已延迟，稍后通过 deferredNotificationsReady 发送
+     */
+    bool admit(const QString &strSessionId, const MCPPendingNotification &notification);
+
+public slots:
+    void onResourceContentChanged(const QString &strUri);
+    void onResourceDeleted(const QString &strUri);
+    void onResourcesListChanged();
+    void onToolsListChanged();
+    void onPromptsListChanged();
+
+    /**
+     * @brief 会话删除时丢弃其配额和延迟的通知
+     * @param strSessionId 会话ID
+     */
+    void onSessionRemoved(const QString &strSessionId);
+
+signals:
+    // 合并后的变化（与服务的信号同名同参数，MCPServerHandler的槽不变）
+    void resourceContentChanged(const QString &strUri);
+    void resourceDeleted(const QString &strUri);
+    void resourcesListChanged();
+    void toolsListChanged();
+    void promptsListChanged();
+
+    /**
+     * @brief 配额恢复，发送之前延迟的通知（已去重，只需按最新状态生成）
+     * @param strSessionId 会话ID
+     * @param lstNotifications 通知列表
+     */
+    void deferredNotificationsReady(const QString &strSessionId, const QList<MCPPendingNotification> &lstNotifications);
+
+private slots:
+    void onFlushTimer();
+
+private:
+    void scheduleFlush();
+
+private:
+    struct SessionBudget
+    {
+        qint64 nWindowStart = 0;
+        int nSent = 0;
+        QList<MCPPendingNotification> lstDeferred;
+    };
+
+private:
+    QHash<QString, bool> m_dictDirtyUris; // URI -> 最后一次变化是否为删除
+    bool m_bResourcesListDirty;
+    bool m_bToolsListDirty;
+    bool m_bPromptsListDirty;
+    QHash<QString, SessionBudget> m_dictBudgets;
+    QSet<QString> m_setDeferredSessions; // 有延迟通知的会话
+
+private:
+    QTimer *m_pFlushTimer;
+    QElapsedTimer m_clock;
+    int m_nCoalesceWindowMs;
+    int m_nMaxPerSessionPerSecond;
+    int m_nProgressIntervalMs;
+};
@@ -0,0 +1,62 @@
+/**
+ * @file MCPProgressReporter.cpp
+ * @brief Rate-limited progress notifications of a tool call (internal implementation)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include "MCPProgressReporter.h"
+
+MCPProgressReporter::MCPProgressReporter(const QJsonValue &jsonProgressToken, int nMinIntervalMs, Sink sink)
+    : m_jsonProgressToken(jsonProgressToken)
+    , m_nMinIntervalMs(qMax(0, nMinIntervalMs))
+    , m_sink(std::move(sink))
+    , m_nLastSentAt(0)
+    , m_dLastProgress(0)
+    , m_bSent(false)
+    , m_bClosed(false)
+{
+    m_clock.start();
+}
+
+bool MCPProgressReporter::report(double dProgress, double dTotal, const QString &strMessage)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_bClosed || (m_bSent && dProgress <= m_dLastProgress)) {
+        return false;
+    }
+
+    const qint64 nNow = m_clock.elapsed();
+    const bool bFinal = dTotal > 0 && dProgress >= dTotal;
+    if (m_bSent && !bFinal && nNow - m_nLastSentAt < m_nMinIntervalMs) {
+        return false;
+    }
+    m_nLastSentAt = nNow;
+    m_dLastProgress = dProgress;
+    m_bSent = true;
+
+    QJsonObject objParams;
+    objParams["progressToken"] = m_jsonProgressToken;
+    objParams["progress"] = dProgress;
+    if (dTotal > 0) {
+        objParams["total"] = dTotal;
+    }
+    if (!strMessage.isEmpty()) {
+        objParams["message"] = strMessage;
+    }
+    QJsonObject objNotification;
+    objNotification["method"] = "notifications/progress";
+    objNotification["params"] = objParams;
+
+    // Under the lock: close() waits for it, so nothing is queued after the response.
+    // The sink only queues the notification to the server thread.
+    m_sink(objNotification);
+    return true;
+}
+
+void MCPProgressReporter::close()
+{
+    QMutexLocker locker(&m_mutex);
+    m_bClosed = true;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file MCPProgressReporter.h
+ * @brief Rate-limited progress notifications of a tool call (internal implementation)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <functional>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QMutex>
+#include <QString>
+
+/**
+ * @brief Progress reporter of one request carrying _meta.progressToken
+ *
+ * Responsibilities:
+ * - Build notifications/progress for the request's progress token
+ * - Drop reports that do not increase the progress (the MCP specification requires it to increase)
+ * - Limit the rate: at most one notification per interval, a report within the interval is dropped
+ *   (the next one carries newer progress anyway); the final report (progress == total) always passes
+ * - Stop reporting once the request is answered
+ *
+ * Thread safety:
+ * - report() is called from the handler's thread, close() from whichever thread answers the request
+ * - The sink runs under the lock, so a notification is queued before close() returns or not at all;
+ *   it must not call back into the reporter
+ *
+ * Coding conventions:
+ * - Class members add m_ prefix
+ * - { and } should be on separate lines
+ */
+class MCPProgressReporter
+{
+public:
+    // Receives {"method": "notifications/progress", "params": {...}}
+    using Sink = std::function<void(const QJsonObject &objNotification)>;
+
+public:
+    /**
+     * @brief Constructor
+     * @param jsonProgressToken _meta.progressToken of the request
+     * @param nMinIntervalMs Minimum interval between two notifications, <= 0 means unlimited
+     * @param sink Delivers a notification to the session
+     */
+    MCPProgressReporter(const QJsonValue &jsonProgressToken, int nMinIntervalMs, Sink sink);
+
+public:
+    /**
+     * @brief Report progress
+     * @param dProgress Progress so far
+     * @param dTotal Total, <= 0 if unknown
+     * @param strMessage Optional human readable status
+     * @return true if a notification was sent
+     */
+    bool report(double dProgress, double dTotal, const QString &strMessage);
+
+    /**
+     * @brief No notification may follow the response
+     */
+    void close();
+
+private:
+    QMutex m_mutex;
+    QJsonValue m_jsonProgressToken;
+    int m_nMinIntervalMs;
+    Sink m_sink;
+    QElapsedTimer m_clock;
+    qint64 m_nLastSentAt;
+    double m_dLastProgress;
+    bool m_bSent;
+    bool m_bClosed;
+};
@@ -0,0 +1,280 @@
+/**
+ * @file MCPTrace.cpp
+ * @brief Per-request tracing
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include "MCPTrace.h"
+#include <MCPLog.h>
+#include <QAtomicPointer>
+#include <QCoreApplication>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <utility>
+
+namespace {
+
+// One span; every field is an atomic so a slot read while it is overwritten is a detected race, not UB
+struct TraceSlot
+{
+    QAtomicInteger<quint64> nSeq; // 0 = empty, odd = being written, 2 * (n + 1) = n-th span of the ring
+    QAtomicPointer<const char> pName;
+    QAtomicInteger<quint64> nTraceId;
+    QAtomicInteger<qint64> nStartNs;
+    QAtomicInteger<qint64> nEndNs;
+    QAtomicInteger<int> bAsync;
+};
+
+// Written by its owner thread only, read by the exporter
+struct TraceRing
+{
+    explicit TraceRing(int nCapacity)
+        : arrSlots(new TraceSlot[nCapacity])
+        , nCapacity(nCapacity)
+        , nNext(0)
+        , nTid(0)
+    {}
+
+    void clear()
+    {
+        for (int i = 0; i < nCapacity; ++i) {
+            arrSlots[i].nSeq.storeRelaxed(0);
+        }
+        nNext = 0;
+    }
+
+    void push(const char *pName, quint64 nTraceId, qint64 nStartNs, qint64 nEndNs, bool bAsync)
+    {
+        const quint64 n = nNext++;
+        TraceSlot &slot = arrSlots[n & static_cast<quint64>(nCapacity - 1)];
+        slot.nSeq.storeRelaxed(2 * n + 1);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.pName.storeRelaxed(pName);
+        slot.nTraceId.storeRelaxed(nTraceId);
+        slot.nStartNs.storeRelaxed(nStartNs);
+        slot.nEndNs.storeRelaxed(nEndNs);
+        slot.bAsync.storeRelaxed(bAsync ? 1 : 0);
+        slot.nSeq.storeRelease(2 * n + 2);
+    }
+
+    std::unique_ptr<TraceSlot[]> arrSlots;
+    const int nCapacity;
+    quint64 nNext;
+    // Guarded by the registry mutex
+    int nTid;
+    QByteArray byteThreadName;
+};
+
+struct TraceRegistry
+{
+    QMutex mutex;
+    QList<TraceRing *> lstRings; // every ring, also those of finished threads
+    QList<TraceRing *> lstFree;  // rings of finished threads, reused by new ones
+    int nNextTid = 1;
+};
+
+// Never destroyed: thread-local holders may release their ring after static destruction
+TraceRegistry *registry()
+{
+    static TraceRegistry *pRegistry = new TraceRegistry();
+    return pRegistry;
+}
+
+QAtomicInteger<int> g_nBufferSize(MCPTrace::DEFAULT_BUFFER_SIZE);
+QAtomicInteger<quint64> g_nNextTraceId(1);
+
+TraceRing *acquireRing()
+{
+    auto pRegistry = registry();
+    const int nCapacity = g_nBufferSize.loadRelaxed();
+
+    QMutexLocker locker(&pRegistry->mutex);
+    TraceRing *pRing = nullptr;
+    while (pRing == nullptr && !pRegistry->lstFree.isEmpty()) {
+        pRing = pRegistry->lstFree.takeLast();
+        if (pRing->nCapacity != nCapacity) {
+            // Buffer size changed since the ring was made
+            pRegistry->lstRings.removeOne(pRing);
+            delete pRing;
+            pRing = nullptr;
+        }
+    }
+    if (pRing == nullptr) {
+        pRing = new TraceRing(nCapacity);
+        pRegistry->lstRings.append(pRing);
+    } else {
+        // Spans of the finished thread would be attributed to this one
+        pRing->clear();
+    }
+
+    pRing->nTid = pRegistry->nNextTid++;
+    QString strThreadName = QThread::currentThread() != nullptr ? QThread::currentThread()->objectName() : QString();
+    if (strThreadName.isEmpty()) {
+        strThreadName = QString("thread-%1").arg(pRing->nTid);
+    }
+    pRing->byteThreadName = strThreadName.toUtf8().replace('\\', '/').replace('"', '\'');
+    return pRing;
+}
+
+void releaseRing(TraceRing *pRing)
+{
+    auto pRegistry = registry();
+    QMutexLocker locker(&pRegistry->mutex);
+    pRegistry->lstFree.append(pRing);
+}
+
+struct TraceRingHolder
+{
+    ~TraceRingHolder()
+    {
+        if (pRing != nullptr) {
+            releaseRing(pRing);
+        }
+    }
+
+    TraceRing *pRing = nullptr;
+};
+
+thread_local TraceRingHolder t_ringHolder;
+thread_local quint64 t_nCurrentTraceId = 0;
+
+void appendMicros(QByteArray &byteJson, qint64 nNanos)
+{
+    byteJson.append(QByteArray::number(nNanos / 1000));
+    byteJson.append('.');
+    const int nFraction = static_cast<int>(nNanos % 1000);
+    byteJson.append(QByteArray::number(nFraction).rightJustified(3, '0'));
+}
+
+void appendEvent(QByteArray &byteJson, const char *pName, const char *pPhase, qint64 nTsNs, qint64 nDurNs, const QByteArray &bytePid, const QByteArray &byteTid, const QByteArray &byteTraceId)
+{
+    byteJson.append(",{\"name\":\"");
+    byteJson.append(pName);
+    byteJson.append("\",\"cat\":\"mcp\",\"ph\":\"");
+    byteJson.append(pPhase);
+    byteJson.append("\",\"ts\":");
+    appendMicros(byteJson, nTsNs);
+    if (nDurNs >= 0) {
+        byteJson.append(",\"dur\":");
+        appendMicros(byteJson, nDurNs);
+    } else {
+        byteJson.append(",\"id\":" + byteTraceId);
+    }
+    byteJson.append(",\"pid\":" + bytePid + ",\"tid\":" + byteTid + ",\"args\":{\"traceId\":" + byteTraceId + "}}");
+}
+
+} // namespace
+
+QAtomicInteger<int> MCPTrace::s_bEnabled(0);
+
+void MCPTrace::setEnabled(bool bEnabled)
+{
+    s_bEnabled.storeRelaxed(bEnabled ? 1 : 0);
+    MCP_CORE_LOG_INFO() << "MCPTrace: enabled:" << bEnabled << "bufferSize:" << getBufferSize();
+}
+
+void MCPTrace::setBufferSize(int nBufferSize)
+{
+    int nCapacity = 1;
+    while (nCapacity < nBufferSize && nCapacity < (1 << 24)) {
+        nCapacity <<= 1;
+    }
+    g_nBufferSize.storeRelaxed(nCapacity);
+}
+
+int MCPTrace::getBufferSize()
+{
+    return g_nBufferSize.loadRelaxed();
+}
+
+quint64 MCPTrace::newTraceId()
+{
+    return isEnabled() ? g_nNextTraceId.fetchAndAddRelaxed(1) : 0;
+}
+
+quint64 MCPTrace::currentTraceId()
+{
+    return t_nCurrentTraceId;
+}
+
+qint64 MCPTrace::nowNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void MCPTrace::record(const char *pName, quint64 nTraceId, qint64 nStartNs, qint64 nEndNs, bool bAsync)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    auto &holder = t_ringHolder;
+    if (holder.pRing == nullptr) {
+        holder.pRing = acquireRing();
+    }
+    holder.pRing->push(pName, nTraceId, nStartNs, nEndNs, bAsync);
+}
+
+QByteArray MCPTrace::toChromeTraceJson()
+{
+    const QByteArray bytePid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray byteJson;
+    byteJson.reserve(64 * 1024);
+    byteJson.append("{\"traceEvents\":[");
+    bool bFirst = true;
+
+    auto pRegistry = registry();
+    QMutexLocker locker(&pRegistry->mutex);
+    for (const auto pRing : std::as_const(pRegistry->lstRings)) {
+        const QByteArray byteTid = QByteArray::number(pRing->nTid);
+        byteJson.append(bFirst ? "" : ",");
+        bFirst = false;
+        byteJson.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + bytePid + ",\"tid\":" + byteTid + ",\"args\":{\"name\":\"" + pRing->byteThreadName + "\"}}");
+
+        for (int i = 0; i < pRing->nCapacity; ++i) {
+            const TraceSlot &slot = pRing->arrSlots[i];
+            const quint64 nSeq = slot.nSeq.loadAcquire();
+            if (nSeq == 0 || (nSeq & 1) != 0) {
+                continue;
+            }
+            const char *pName = slot.pName.loadRelaxed();
+            const quint64 nTraceId = slot.nTraceId.loadRelaxed();
+            const qint64 nStartNs = slot.nStartNs.loadRelaxed();
+            const qint64 nEndNs = slot.nEndNs.loadRelaxed();
+            const bool bAsync = slot.bAsync.loadRelaxed() != 0;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.nSeq.loadRelaxed() != nSeq) {
+                // Overwritten while being read
+                continue;
+            }
+
+            const QByteArray byteTraceId = QByteArray::number(nTraceId);
+            if (bAsync) {
+                // Begin/end pair keyed by the trace ID, drawn on a track of its own
+                appendEvent(byteJson, pName, "b", nStartNs, -1, bytePid, byteTid, byteTraceId);
+                appendEvent(byteJson, pName, "e", nEndNs, -1, bytePid, byteTid, byteTraceId);
+            } else {
+                appendEvent(byteJson, pName, "X", nStartNs, qMax<qint64>(0, nEndNs - nStartNs), bytePid, byteTid, byteTraceId);
+            }
+        }
+    }
+    byteJson.append("],\"displayTimeUnit\":\"ms\"}");
+    return byteJson;
+}
+
+MCPTrace::Scope::Scope(quint64 nTraceId)
+    : m_nPrevious(t_nCurrentTraceId)
+{
+    t_nCurrentTraceId = nTraceId;
+}
+
+MCPTrace::Scope::~Scope()
+{
+    t_nCurrentTraceId = m_nPrevious;
+}
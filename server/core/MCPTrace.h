@@ -0,0 +1,148 @@
+/**
+ * @file MCPTrace.h
+ * @brief Per-request tracing into per-thread ring buffers, exported as Chrome trace-event JSON
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QtGlobal>
+
+/**
+ * @brief Request tracing
+ *
+ * Responsibilities:
+ * - Give every incoming request a trace ID (carried by MCPMessage, see getTraceId)
+ * - Record timed spans (HTTP parsing, session lookup, middleware chain, tool queue, tool handler,
+ *   validation, socket write) tagged with the trace ID of the request they belong to
+ * - Render the recorded spans as Chrome trace-event JSON (GET /trace), which chrome://tracing and
+ *   Perfetto open directly
+ *
+ * Recording:
+ * - Each thread writes into its own fixed-size ring, no lock and no allocation after the first span
+ *   of the thread; the oldest spans are overwritten
+ * - Slots are guarded by a sequence number, the exporter skips a slot that is being overwritten
+ *   instead of blocking the writer
+ * - Rings of finished threads are kept for export and handed to the next new thread
+ *
+ * Disabled (the default), a span costs one relaxed atomic load.
+ *
+ * The trace ID of the request a thread is working on is thread-local (Scope), so spans deep in the
+ * call chain pick it up without it being passed through every signature.
+ *
+ * Coding conventions:
+ * - Class members add m_ prefix
+ * - Pointer types add p prefix
+ * - { and } should be on separate lines
+ */
+class MCPTrace
+{
+public:
+    static constexpr int DEFAULT_BUFFER_SIZE = 16384;
+
+public:
+    static inline bool isEnabled()
+    {
+        return s_bEnabled.loadRelaxed() != 0;
+    }
+
+    static void setEnabled(bool bEnabled);
+
+    /**
+     * @brief Spans kept per thread
+     * @param nBufferSize Rounded up to a power of two, applies to rings created afterwards
+     */
+    static void setBufferSize(int nBufferSize);
+    static int getBufferSize();
+
+    /**
+     * @brief Allocate the trace ID of a new request
+     * @return Process-unique ID, 0 when tracing is disabled
+     */
+    static quint64 newTraceId();
+
+    // Trace ID of the request the calling thread is working on (0 = none)
+    static quint64 currentTraceId();
+
+    // Monotonic clock shared by all spans (ns)
+    static qint64 nowNanos();
+
+    /**
+     * @brief Record a span whose start was taken elsewhere (e.g. the time a call waited in a queue)
+     * @param pName Static string, stored by pointer
+     * @param nTraceId Trace ID
+     * @param nStartNs Start (nowNanos)
+     * @param nEndNs End (nowNanos)
+     * @param bAsync Exported as an async event on its own track instead of the recording thread's,
+     *        for waits that overlap other spans of that thread
+     */
+    static void record(const char *pName, quint64 nTraceId, qint64 nStartNs, qint64 nEndNs, bool bAsync = false);
+
+    /**
+     * @brief Render all recorded spans
+     * @return {"traceEvents":[...],"displayTimeUnit":"ms"}, complete ("X") events with the trace ID in args,
+     *         async spans as "b"/"e" pairs with the trace ID as their id
+     */
+    static QByteArray toChromeTraceJson();
+
+public:
+    /**
+     * @brief Sets the current trace ID of the thread for its lifetime (RAII)
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(quint64 nTraceId);
+        ~Scope();
+        Q_DISABLE_COPY(Scope)
+
+    private:
+        quint64 m_nPrevious;
+    };
+
+private:
+    static QAtomicInteger<int> s_bEnabled;
+};
+
+/**
+ * @brief Times its own lifetime as a span (RAII)
+ *
+ * The name must be a string literal, it is stored by pointer.
+ */
+class MCPTraceSpan
+{
+public:
+    explicit MCPTraceSpan(const char *pName)
+        : m_pName(pName)
+        , m_nTraceId(0)
+        , m_nStartNs(-1)
+    {
+        if (MCPTrace::isEnabled()) {
+            m_nTraceId = MCPTrace::currentTraceId();
+            m_nStartNs = MCPTrace::nowNanos();
+        }
+    }
+
+    MCPTraceSpan(const char *pName, quint64 nTraceId)
+        : m_pName(pName)
+        , m_nTraceId(nTraceId)
+        , m_nStartNs(MCPTrace::isEnabled() ? MCPTrace::nowNanos() : -1)
+    {}
+
+    ~MCPTraceSpan()
+    {
+        if (m_nStartNs >= 0) {
+            MCPTrace::record(m_pName, m_nTraceId, m_nStartNs, MCPTrace::nowNanos());
+        }
+    }
+
+    Q_DISABLE_COPY(MCPTraceSpan)
+
+private:
+    const char *m_pName;
+    quint64 m_nTraceId;
+    qint64 m_nStartNs;
+};
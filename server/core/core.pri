@@ -3,16 +3,30 @@ QMAKE_INCDIR += $$PWD/include
 
 HEADERS += \
     $$PWD/MCPLog.h \
+    $$PWD/MCPCancellationToken.h \
     $$PWD/MCPHelper.h \
     $$PWD/MCPNotificationHandlerBase.h \
+    $$PWD/MCPNotificationScheduler.h \
+    $$PWD/MCPProgressReporter.h \
     $$PWD/MCPInvokeHelper.h \
+    $$PWD/MCPInvocationPlan.h \
     $$PWD/MCPMetaObjectHelper.h \
-    $$PWD/MCPMethodHelper.h
+    $$PWD/MCPMethodHelper.h \
+    $$PWD/MCPMethodRegistry.h \
+    $$PWD/MCPMetrics.h \
+    $$PWD/MCPTrace.h
 
 SOURCES += \
     $$PWD/MCPLog.cpp \
+    $$PWD/MCPCancellationToken.cpp \
     $$PWD/MCPHelper.cpp \
     $$PWD/MCPNotificationHandlerBase.cpp \
+    $$PWD/MCPNotificationScheduler.cpp \
+    $$PWD/MCPProgressReporter.cpp \
     $$PWD/MCPInvokeHelper.cpp \
+    $$PWD/MCPInvocationPlan.cpp \
     $$PWD/MCPMetaObjectHelper.cpp \
-    $$PWD/MCPMethodHelper.cpp
+    $$PWD/MCPMethodHelper.cpp \
+    $$PWD/MCPMethodRegistry.cpp \
+    $$PWD/MCPMetrics.cpp \
+    $$PWD/MCPTrace.cpp
@@ -266,4 +266,26 @@ MCPError MCPError::authorizationFailed(const QString& details)
         message += QString(" - ") + details;
     }
     return MCPError(MCPErrorCode::AUTHORIZATION_FAILED, message);
+}
+
+MCPError MCPError::rateLimitExceeded(const QString& details)
+{
+
+    QString message = getErrorMessage(MCPErrorCode::RATE_LIMIT_EXCEEDED);
+    if (!details.isEmpty())
+    {
+        message += QString(" - ") + details;
+    }
+    return MCPError(MCPErrorCode::RATE_LIMIT_EXCEEDED, message);
+}
+
+MCPError MCPError::requestTimeout(const QString& details)
+{
+
+    QString message = getErrorMessage(MCPErrorCode::REQUEST_TIMEOUT);
+    if (!details.isEmpty())
+    {
+        message += QString(" - ") + details;
+    }
+    return MCPError(MCPErrorCode::REQUEST_TIMEOUT, message);
 }
\ No newline at end of file
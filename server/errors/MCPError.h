@@ -130,6 +130,8 @@ public:
     static MCPError sessionNotFound(const QString& sessionId);
     static MCPError authenticationFailed(const QString& details = QString());
     static MCPError authorizationFailed(const QString& details = QString());
+    static MCPError rateLimitExceeded(const QString& details = QString());
+    static MCPError requestTimeout(const QString& details = QString());
 
 private:
     MCPErrorCode m_code;        // Error code
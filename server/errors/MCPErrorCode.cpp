@@ -46,6 +46,8 @@ QString getErrorMessage(MCPErrorCode code)
         return QString("Rate limit: Requests are too frequent, please try again later");
     case MCPErrorCode::CONFIGURATION_ERROR:
         return QString("Configuration error: Server configuration is abnormal");
+    case MCPErrorCode::REQUEST_TIMEOUT:
+        return QString("Request timeout: The request did not complete before its deadline");
 
     // Network and transmission errors
     case MCPErrorCode::CONNECTION_CLOSED:
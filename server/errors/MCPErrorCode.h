@@ -39,6 +39,7 @@ enum class MCPErrorCode {
     AUTHORIZATION_FAILED = -32007,  // Authorization failed
     RATE_LIMIT_EXCEEDED = -32008,   // Rate limit
     CONFIGURATION_ERROR = -32009,   // Configuration error
+    REQUEST_TIMEOUT = -32010,       // Request deadline exceeded
 
     // Network and transmission errors (-32100 to -32199)
     NETWORK_ERROR_BASE = -32100,
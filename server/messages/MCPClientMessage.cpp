@@ -7,11 +7,13 @@
  */
 
 #include "MCPClientMessage.h"
+#include "MCPMethodRegistry.h"
 #include <QJsonDocument>
 
 // mcpMessage 基类实现
 MCPClientMessage::MCPClientMessage(MCPMessageType::Flags enMessageType)
 	: MCPMessage(enMessageType)
+	, m_nMethodNameId(-1)
 {
 
 }
@@ -26,6 +28,11 @@ QString MCPClientMessage::getSessionId()
 	return m_strMcpSessionId;
 }
 
+QString MCPClientMessage::getLastEventId()
+{
+	return m_strLastEventId;
+}
+
 QJsonValue MCPClientMessage::getMethodId()
 {
 	auto jsonId = m_jsonRpc.value("id");
@@ -34,8 +41,19 @@ QJsonValue MCPClientMessage::getMethodId()
 
 QString MCPClientMessage::getMethodName()
 {
-	auto strMethodName = m_jsonRpc.value("method").toString();
-	return strMethodName;
+	return m_strMethodName;
+}
+
+int MCPClientMessage::getMethodNameId()
+{
+	return m_nMethodNameId;
+}
+
+void MCPClientMessage::setJsonRpc(const QJsonObject &jsonRpc)
+{
+	m_jsonRpc = jsonRpc;
+	m_strMethodName = m_jsonRpc.value("method").toString();
+	m_nMethodNameId = MCPMethodRegistry::find(m_strMethodName);
 }
 
 QJsonValue MCPClientMessage::getParmams()
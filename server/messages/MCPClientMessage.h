@@ -16,16 +16,27 @@ public:
     virtual ~MCPClientMessage();
 public:
     QString getSessionId();
+    // SSE重连时的 Last-Event-ID（为空表示新连接）
+    QString getLastEventId();
 public:
     QJsonValue getMethodId();
     QString getMethodName();
+    // 方法名驻留后的ID（MCPMethodRegistry，解析时确定），未注册的方法为 -1
+    int getMethodNameId();
     QJsonValue getParmams();
 protected:
     QString m_strMcpSessionId;
     QString m_strProtocolVersion;
+    QString m_strLastEventId;
 protected:
     QJsonObject m_jsonRpc;
+    QString m_strMethodName;
+    int m_nMethodNameId;
+private:
+    // 设置JSON-RPC消息体，同时缓存方法名及其ID，路由时不再按字符串查找
+    void setJsonRpc(const QJsonObject &jsonRpc);
 private:
     friend class MCPHttpRequestData;
     friend class MCPHttpMessageParser;
+    friend class MCPStdioMessageParser;
 };
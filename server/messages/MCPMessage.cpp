@@ -9,6 +9,7 @@
 #include "MCPMessage.h"
 MCPMessage::MCPMessage(MCPMessageType::Flags enMessageType /*= MCPRequestType::None*/)
 	: m_enType(enMessageType)
+	, m_nTraceId(0)
 {
 
 }
@@ -24,7 +25,22 @@ MCPMessageType::Flags MCPMessage::appendType(MCPMessageType::Flags enType)
 	return m_enType;
 }
 
+quint64 MCPMessage::getTraceId() const
+{
+	return m_nTraceId;
+}
+
+void MCPMessage::setTraceId(quint64 nTraceId)
+{
+	m_nTraceId = nTraceId;
+}
+
 QByteArray MCPMessage::toData()
 {
 	return QByteArray();
 }
+
+QByteArrayList MCPMessage::toDataParts()
+{
+	return QByteArrayList{toData()};
+}
@@ -4,6 +4,7 @@
 #include <QJsonValue>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QByteArrayList>
 #include <QSet>
 #include <QString>
 #include <QSharedPointer>
@@ -29,10 +30,17 @@ public:
 public:
     MCPMessageType::Flags getType();
     MCPMessageType::Flags appendType(MCPMessageType::Flags enType);
+public:
+    // 请求的跟踪ID（见MCPTrace，0表示未跟踪），应答沿用其请求的ID
+    quint64 getTraceId() const;
+    void setTraceId(quint64 nTraceId);
 public:
     virtual QByteArray toData();
+    // 分段序列化：传输层按段写出（writev），避免拼接时复制消息体
+    virtual QByteArrayList toDataParts();
 protected:
     MCPMessageType::Flags m_enType;
+    quint64 m_nTraceId;
 };
 Q_DECLARE_METATYPE(MCPMessage*)
 Q_DECLARE_METATYPE(QSharedPointer<MCPMessage>)
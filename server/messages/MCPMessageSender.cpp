@@ -7,8 +7,10 @@
  */
 
 #include <IMCPTransport.h>
+#include <MCPClientMessage.h>
 #include <MCPContext.h>
 #include <MCPHttpReplyMessage.h>
+#include <MCPHttpResponseBuilder.h>
 #include <MCPLog.h>
 #include <MCPMessageSender.h>
 #include <MCPMessageType.h>
@@ -25,6 +27,11 @@ MCPMessageSender::MCPMessageSender(IMCPTransport *pTransport, QObject *pParent)
 
 MCPMessageSender::~MCPMessageSender() {}
 
+void MCPMessageSender::setTransport(IMCPTransport *pTransport)
+{
+    m_pTransport = pTransport;
+}
+
 void MCPMessageSender::sendMessage(const QSharedPointer<MCPServerMessage> &pServerMessage)
 {
     if (pServerMessage == nullptr) {
@@ -39,6 +46,8 @@ void MCPMessageSender::sendMessage(const QSharedPointer<MCPServerMessage> &pServ
         sendSseMessage(pServerMessage);
     } else if (enMessageType & MCPMessageType::StreamableTransport) {
         sendStreamableMessage(pServerMessage);
+    } else if (enMessageType & MCPMessageType::StdioTransport) {
+        sendStdioMessage(pServerMessage);
     } else {
         MCP_CORE_LOG_WARNING() << "MCPMessageSender:sendMessage: error:" << MCPMessageType::toString(enMessageType);
     }
@@ -60,6 +69,16 @@ void MCPMessageSender::sendAcceptNotification(quint64 nConnectionId, MCPMessageT
     m_pTransport->sendMessage(nConnectionId, pReplyMessage);
 }
 
+void MCPMessageSender::sendMetrics(quint64 nConnectionId, const QByteArray &byteMetrics)
+{
+    m_pTransport->sendMessage(nConnectionId, MCPHttpReplyMessage::CreateMetricsResponse(byteMetrics));
+}
+
+void MCPMessageSender::sendTrace(quint64 nConnectionId, const QByteArray &byteTrace)
+{
+    m_pTransport->sendMessage(nConnectionId, MCPHttpReplyMessage::CreateTraceResponse(byteTrace));
+}
+
 void MCPMessageSender::sendSseMessage(const QSharedPointer<MCPServerMessage> &pServerMessage)
 {
     auto pContext = pServerMessage->getContext();
@@ -74,6 +93,12 @@ void MCPMessageSender::sendSseMessage(const QSharedPointer<MCPServerMessage> &pS
     if (enMessageType & MCPMessageType::Connect) {
         // SSE连接响应：发送到原始连接
         pTransport->sendMessage(pContext->getConnectionId(), QSharedPointer<MCPHttpReplyMessage>::create(pServerMessage, enMessageType));
+
+        // 携带 Last-Event-ID 重连：endpoint事件之后重放错过的事件
+        auto strLastEventId = pContext->getClientMessage() ? pContext->getClientMessage()->getLastEventId() : QString();
+        if (!strLastEventId.isEmpty() && pContext->getSession() != nullptr) {
+            replaySseEvents(pContext->getSession(), strLastEventId);
+        }
     } else if (enMessageType & MCPMessageType::Response) {
         // SSE响应：发送到SSE连接，然后关闭原始连接
         auto pSession = pContext->getSession();
@@ -82,7 +107,7 @@ void MCPMessageSender::sendSseMessage(const QSharedPointer<MCPServerMessage> &pS
             return;
         }
 
-        pTransport->sendMessage(pSession->getSseConnectionId(), QSharedPointer<MCPHttpReplyMessage>::create(pServerMessage, enMessageType));
+        sendSseEvent(pSession, pServerMessage->toData(), pServerMessage->getTraceId());
 
         // 发送接受通知并关闭原始连接
         pTransport->sendCloseMessage(pContext->getConnectionId(), MCPHttpReplyMessage::CreateStreamableAcceptNotification());
@@ -90,8 +115,57 @@ void MCPMessageSender::sendSseMessage(const QSharedPointer<MCPServerMessage> &pS
         // SSE通知接受响应：发送202 Accepted
         pTransport->sendMessage(pContext->getConnectionId(), MCPHttpReplyMessage::CreateSseAcceptNotification());
     } else if (enMessageType & MCPMessageType::RequestNotification) {
-        // SSE主动通知：发送到原始连接
-        pTransport->sendMessage(pContext->getConnectionId(), QSharedPointer<MCPHttpReplyMessage>::create(pServerMessage, enMessageType));
+        // SSE主动通知：发送到SSE连接
+        if (auto pSession = pContext->getSession()) {
+            sendSseEvent(pSession, pServerMessage->toData());
+        }
+    }
+}
+
+void MCPMessageSender::sendNotificationFanOut(const QList<QSharedPointer<MCPSession>> &lstSessions, const QByteArray &byteRpcData)
+{
+    // SSE帧只有事件ID一段按会话生成，JSON消息体是同一个隐式共享的QByteArray
+    QSharedPointer<MCPServerMessage> pStdioMessage;
+    for (const auto &pSession : lstSessions) {
+        if (pSession->isStdioTransport()) {
+            if (pStdioMessage == nullptr) {
+                pStdioMessage = MCPServerMessage::CreateSerialized(QSharedPointer<MCPContext>(), byteRpcData, MCPMessageType::StdioTransport | MCPMessageType::RequestNotification);
+            }
+            m_pTransport->sendMessage(pSession->getSseConnectionId(), pStdioMessage);
+        } else {
+            sendSseEvent(pSession, byteRpcData);
+        }
+    }
+}
+
+void MCPMessageSender::sendSseEvent(const QSharedPointer<MCPSession> &pSession, const QByteArray &byteRpcData, quint64 nTraceId)
+{
+    auto &eventBuffer = pSession->getSseEventBuffer();
+    auto byteEventId = MCPSseEventBuffer::formatEventId(pSession->getSessionId(), eventBuffer.nextEventId());
+    auto lstFrame = MCPHttpResponseBuilder::buildSseMessageResponseParts(byteEventId, byteRpcData);
+    eventBuffer.push(lstFrame);
+
+    // SSE流断开期间只缓存，客户端重连后重放
+    if (auto nSseConnectionId = pSession->getSseConnectionId()) {
+        auto pReplyMessage = MCPHttpReplyMessage::CreateSseEventFrames(lstFrame);
+        pReplyMessage->setTraceId(nTraceId);
+        m_pTransport->sendMessage(nSseConnectionId, pReplyMessage);
+    }
+}
+
+void MCPMessageSender::replaySseEvents(const QSharedPointer<MCPSession> &pSession, const QString &strLastEventId)
+{
+    QString strSessionId;
+    quint64 nLastEventId = 0;
+    if (!MCPSseEventBuffer::parseEventId(strLastEventId, strSessionId, nLastEventId) || strSessionId != pSession->getSessionId()) {
+        // 无法续传，MCPSessionService已经创建了新会话
+        return;
+    }
+
+    auto lstFrames = pSession->getSseEventBuffer().framesAfter(nLastEventId);
+    MCP_CORE_LOG_INFO() << "MCPMessageSender: SSE replay session:" << strSessionId << "after:" << nLastEventId << "parts:" << lstFrames.size();
+    if (!lstFrames.isEmpty()) {
+        m_pTransport->sendMessage(pSession->getSseConnectionId(), MCPHttpReplyMessage::CreateSseEventFrames(lstFrames));
     }
 }
 
@@ -106,6 +180,17 @@ void MCPMessageSender::sendStreamableMessage(const QSharedPointer<MCPServerMessa
     auto enMessageType = pServerMessage->getType();
     auto pTransport = m_pTransport;
 
+    if (enMessageType & MCPMessageType::Connect) {
+        // GET SSE流：只发送响应头，之后的通知以SSE帧写在这个连接上
+        pTransport->sendMessage(pContext->getConnectionId(), QSharedPointer<MCPHttpReplyMessage>::create(pServerMessage, enMessageType));
+
+        auto strLastEventId = pContext->getClientMessage() ? pContext->getClientMessage()->getLastEventId() : QString();
+        if (!strLastEventId.isEmpty() && pContext->getSession() != nullptr) {
+            replaySseEvents(pContext->getSession(), strLastEventId);
+        }
+        return;
+    }
+
     // 发送响应消息
     if (enMessageType & MCPMessageType::Response) {
         pTransport->sendMessage(pContext->getConnectionId(), QSharedPointer<MCPHttpReplyMessage>::create(pServerMessage, enMessageType));
@@ -117,3 +202,18 @@ void MCPMessageSender::sendStreamableMessage(const QSharedPointer<MCPServerMessa
         pTransport->sendMessage(pContext->getConnectionId(), QSharedPointer<MCPHttpReplyMessage>::create(pServerMessage, enMessageType));
     }
 }
+
+void MCPMessageSender::sendStdioMessage(const QSharedPointer<MCPServerMessage> &pServerMessage)
+{
+    auto pContext = pServerMessage->getContext();
+    if (pContext == nullptr) {
+        MCP_CORE_LOG_WARNING() << "MCPMessageSender: Stdio context error";
+        return;
+    }
+
+    // 客户端通知不需要应答（stdio 没有 202 Accepted）
+    auto enMessageType = pServerMessage->getType();
+    if (enMessageType & (MCPMessageType::Response | MCPMessageType::RequestNotification)) {
+        m_pTransport->sendMessage(pContext->getConnectionId(), pServerMessage);
+    }
+}
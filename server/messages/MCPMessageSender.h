@@ -14,6 +14,7 @@
 
 class IMCPTransport;
 class MCPServerMessage;
+class MCPSession;
 
 /**
  * @brief MCP消息发送器
@@ -66,6 +67,33 @@ public:
      */
     void sendAcceptNotification(quint64 nConnectionId, MCPMessageType::Flags enTransportType);
 
+    /**
+     * @brief 发送 GET /metrics 的应答（200 OK，Prometheus文本格式）
+     * @param nConnectionId 连接ID
+     * @param byteMetrics 指标文本
+     */
+    void sendMetrics(quint64 nConnectionId, const QByteArray& byteMetrics);
+
+    /**
+     * @brief 发送 GET /trace 的应答（200 OK，Chrome trace-event JSON）
+     * @param nConnectionId 连接ID
+     * @param byteTrace 跟踪数据
+     */
+    void sendTrace(quint64 nConnectionId, const QByteArray& byteTrace);
+
+    /**
+     * @brief 同一通知扇出到多个即时推送会话（SSE/Stdio）
+     * @param lstSessions 会话列表
+     * @param byteRpcData 已序列化的JSON-RPC通知，所有连接的写队列共享这一份数据
+     */
+    void sendNotificationFanOut(const QList<QSharedPointer<MCPSession>>& lstSessions, const QByteArray& byteRpcData);
+
+    /**
+     * @brief 替换传输层接口（服务器启动时按配置选择传输层）
+     * @param pTransport 传输层接口
+     */
+    void setTransport(IMCPTransport* pTransport);
+
 private:
     /**
      * @brief 发送SSE传输的消息
@@ -73,12 +101,33 @@ private:
      */
     void sendSseMessage(const QSharedPointer<MCPServerMessage>& pServerMessage);
 
+    /**
+     * @brief 在SSE流上发送一个事件：分配事件ID，序列化一次并存入会话的重放缓冲区
+     * @param pSession SSE会话（未连接时只缓存，等待客户端携带 Last-Event-ID 重连）
+     * @param byteRpcData 已序列化的JSON-RPC消息
+     * @param nTraceId 应答所属请求的跟踪ID（通知为0）
+     */
+    void sendSseEvent(const QSharedPointer<MCPSession>& pSession, const QByteArray& byteRpcData, quint64 nTraceId = 0);
+
+    /**
+     * @brief SSE重连：重放 Last-Event-ID 之后的事件
+     * @param pSession SSE会话
+     * @param strLastEventId 客户端携带的 Last-Event-ID
+     */
+    void replaySseEvents(const QSharedPointer<MCPSession>& pSession, const QString& strLastEventId);
+
     /**
      * @brief 发送Streamable传输的消息
      * @param pServerMessage 服务器消息
      */
     void sendStreamableMessage(const QSharedPointer<MCPServerMessage>& pServerMessage);
 
+    /**
+     * @brief 发送Stdio传输的消息（JSON-RPC原样输出，无HTTP封装）
+     * @param pServerMessage 服务器消息
+     */
+    void sendStdioMessage(const QSharedPointer<MCPServerMessage>& pServerMessage);
+
 private:
     IMCPTransport* m_pTransport;  // 传输层接口
 };
@@ -60,6 +60,8 @@ QString MCPMessageType::toString(Flags type)
     if (type & Connect) parts << "Connect";
     if (type & Initialize) parts << "Initialize";
     if (type & Ping) parts << "Ping";
+    if (type & Metrics) parts << "Metrics";
+    if (type & Trace) parts << "Trace";
 
     // 调用模式
     if (type & Single) parts << "SingleCall";
@@ -32,6 +32,8 @@ public:
         Initialize = 1 << 17,            // 初始化
         Ping = 1 << 18,                  // Ping
         Accept = 1 << 19,                  //Accept
+        Metrics = 1 << 20,               // GET /metrics（不属于MCP协议，不进入会话和路由）
+        Trace = 1 << 21,                 // GET /trace（同上，导出MCPTrace记录的跟踪数据）
 
         // 调用类型 (bits 24-31) - 单个/批量
         InvocationTypeMask = 0xFF000000,
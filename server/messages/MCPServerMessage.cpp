@@ -42,6 +42,10 @@ MCPServerMessage::MCPServerMessage(const QSharedPointer<MCPContext>& pContext,
 {
     auto enClientMessageType = (m_pContext && m_pContext->getClientMessage())
         ? m_pContext->getClientMessage()->getType() : MCPMessageType::None;
+    if (m_pContext && m_pContext->getClientMessage())
+    {
+        m_nTraceId = m_pContext->getClientMessage()->getTraceId();
+    }
     appendType(enClientMessageType & MCPMessageType::TransportMask);
     //
     if (enClientMessageType & MCPMessageType::Request)
@@ -96,6 +100,15 @@ MCPServerMessage::MCPServerMessage(const QSharedPointer<MCPContext>& pContext,
 }
 
 
+QSharedPointer<MCPServerMessage> MCPServerMessage::CreateSerialized(const QSharedPointer<MCPContext>& pContext, const QByteArray& byteRpcData, MCPMessageType::Flags enType)
+{
+    auto pMessage = QSharedPointer<MCPServerMessage>::create();
+    pMessage->m_pContext = pContext;
+    pMessage->appendType(enType);
+    pMessage->m_byteRpcData = byteRpcData;
+    return pMessage;
+}
+
 QSharedPointer<MCPContext > MCPServerMessage::getContext() const
 {
     return m_pContext;
@@ -103,6 +116,10 @@ QSharedPointer<MCPContext > MCPServerMessage::getContext() const
 
 QByteArray MCPServerMessage::toData()
 {
+    if (!m_byteRpcData.isEmpty())
+    {
+        return m_byteRpcData;
+    }
     auto data = m_rpcValue.isArray()
         ? QJsonDocument(m_rpcValue.toArray()).toJson(QJsonDocument::Compact)
         : QJsonDocument(m_rpcValue.toObject()).toJson(QJsonDocument::Compact);
@@ -32,6 +32,9 @@ public:
 
     MCPServerMessage(const QJsonValue& rpcValue,
         MCPMessageType::Flags enType);
+public:
+    // 已序列化的JSON-RPC数据（通知扇出时所有接收者共享同一份字节）
+    static QSharedPointer<MCPServerMessage> CreateSerialized(const QSharedPointer<MCPContext>& pContext, const QByteArray& byteRpcData, MCPMessageType::Flags enType);
 public:
     QSharedPointer<MCPContext> getContext() const;
 public:
@@ -40,6 +43,7 @@ protected:
     QSharedPointer<MCPContext> m_pContext;
 protected:
     QJsonValue m_rpcValue;
+    QByteArray m_byteRpcData;
 };
 Q_DECLARE_METATYPE(MCPServerMessage*)
 Q_DECLARE_METATYPE(QSharedPointer<MCPServerMessage>)
@@ -10,6 +10,7 @@
 #include <MCPServer_global.h>
 #include <functional>
 #include <QSharedPointer>
+#include <QString>
 
 class MCPContext;
 class MCPServerMessage;
@@ -64,4 +65,17 @@ public:
      * @endcode
      */
     virtual QSharedPointer<MCPServerMessage> process(const QSharedPointer<MCPContext> &pContext, std::function<QSharedPointer<MCPServerMessage>()> next) = 0;
+
+    /**
+     * @brief Whether this middleware takes part in the pipeline of a method
+     * @param strMethod Method name
+     * @return true to be included (default)
+     *
+     * Evaluated once per route when MCPRouter compiles its pipelines, not per request
+     */
+    virtual bool appliesTo(const QString &strMethod) const
+    {
+        Q_UNUSED(strMethod);
+        return true;
+    }
 };
@@ -0,0 +1,153 @@
+/**
+ * @file MCPAdmissionMiddleware.cpp
+ * @brief MCP准入控制中间件实现
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include "MCPAdmissionMiddleware.h"
+#include "MCPClientMessage.h"
+#include "MCPContext.h"
+#include "MCPError.h"
+#include "MCPLog.h"
+#include "MCPServerMessage.h"
+#include "MCPSession.h"
+#include "MCPToolCallRegistry.h"
+#include "MCPToolExecutor.h"
+#include <QJsonObject>
+#include <QtMath>
+
+MCPAdmissionMiddleware::MCPAdmissionMiddleware(MCPToolCallRegistry *pToolCalls, MCPToolExecutor *pToolExecutor)
+    : m_pToolCalls(pToolCalls)
+    , m_pToolExecutor(pToolExecutor)
+    , m_nMaxInFlightToolCalls(0)
+    , m_nLastSweepAt(0)
+    , m_nRejectedCount(0)
+{
+    m_clock.start();
+}
+
+MCPAdmissionMiddleware::~MCPAdmissionMiddleware() {}
+
+void MCPAdmissionMiddleware::setRateLimit(double dPerSecond, int nBurst)
+{
+    m_defaultRate.dPerSecond = dPerSecond > 0 ? dPerSecond : 0;
+    m_defaultRate.dBurst = nBurst > 0 ? nBurst : qMax(1.0, m_defaultRate.dPerSecond);
+    m_dictBuckets.clear();
+    MCP_CORE_LOG_INFO() << "MCPAdmissionMiddleware: rate:" << m_defaultRate.dPerSecond << "burst:" << m_defaultRate.dBurst;
+}
+
+void MCPAdmissionMiddleware::setMethodRateLimit(const QString &strMethod, double dPerSecond, int nBurst)
+{
+    Rate rate;
+    rate.dPerSecond = dPerSecond > 0 ? dPerSecond : 0;
+    rate.dBurst = nBurst > 0 ? nBurst : qMax(1.0, rate.dPerSecond);
+    m_dictMethodRates.insert(strMethod, rate);
+    m_dictBuckets.clear();
+    MCP_CORE_LOG_INFO() << "MCPAdmissionMiddleware: method:" << strMethod << "rate:" << rate.dPerSecond << "burst:" << rate.dBurst;
+}
+
+void MCPAdmissionMiddleware::setMaxInFlightToolCalls(int nMaxInFlightToolCalls)
+{
+    m_nMaxInFlightToolCalls = nMaxInFlightToolCalls > 0 ? nMaxInFlightToolCalls : 0;
+    MCP_CORE_LOG_INFO() << "MCPAdmissionMiddleware: maxInFlightToolCalls:" << m_nMaxInFlightToolCalls;
+}
+
+quint64 MCPAdmissionMiddleware::getRejectedCount() const
+{
+    return m_nRejectedCount;
+}
+
+QSharedPointer<MCPServerMessage> MCPAdmissionMiddleware::process(const QSharedPointer<MCPContext> &pContext, std::function<QSharedPointer<MCPServerMessage>()> next)
+{
+    auto strMethod = pContext->getClientMessage()->getMethodName();
+
+    // 1. 每会话每方法的令牌桶（initialize 之前可能还没有会话）
+    if (auto pSession = pContext->getSession()) {
+        if (int nRetryAfterMs = takeToken(pSession->getSessionId(), strMethod)) {
+            return reject(pContext, QString("Too many %1 requests").arg(strMethod), nRetryAfterMs);
+        }
+    }
+
+    if (strMethod == "tools/call") {
+        // 2. 全局并发上限：排队中的调用也占名额，执行器队列满之前就拒绝
+        if (m_nMaxInFlightToolCalls > 0 && m_pToolCalls->getInFlightCount() >= m_nMaxInFlightToolCalls) {
+            return reject(pContext, "Too many tool calls in flight", BUSY_RETRY_AFTER_MS);
+        }
+
+        // 3. 持续排队：新调用只会等得更久，直接拒绝比超时更好
+        if (m_pToolExecutor->isOverloaded()) {
+            return reject(pContext, "Tool executor overloaded", qMax(BUSY_RETRY_AFTER_MS, m_pToolExecutor->getLastQueueDelay()));
+        }
+    }
+
+    return next();
+}
+
+bool MCPAdmissionMiddleware::appliesTo(const QString &strMethod) const
+{
+    return !strMethod.startsWith("notifications/");
+}
+
+MCPAdmissionMiddleware::Rate MCPAdmissionMiddleware::getRate(const QString &strMethod) const
+{
+    auto it = m_dictMethodRates.constFind(strMethod);
+    return it != m_dictMethodRates.cend() ? it.value() : m_defaultRate;
+}
+
+int MCPAdmissionMiddleware::takeToken(const QString &strSessionId, const QString &strMethod)
+{
+    const Rate rate = getRate(strMethod);
+    if (rate.dPerSecond <= 0) {
+        return 0;
+    }
+
+    const qint64 nNow = m_clock.elapsed();
+    if (nNow - m_nLastSweepAt >= SWEEP_INTERVAL_MS) {
+        sweepBuckets(nNow);
+    }
+
+    const QString strKey = strSessionId + QLatin1Char('\n') + strMethod;
+    auto it = m_dictBuckets.find(strKey);
+    if (it == m_dictBuckets.end()) {
+        // 新桶是满的
+        it = m_dictBuckets.insert(strKey, Bucket{rate.dBurst, nNow});
+    } else {
+        it->dTokens = qMin(rate.dBurst, it->dTokens + (nNow - it->nLastRefillAt) * rate.dPerSecond / 1000.0);
+        it->nLastRefillAt = nNow;
+    }
+
+    if (it->dTokens >= 1.0) {
+        it->dTokens -= 1.0;
+        return 0;
+    }
+    // 补满一个令牌还需要的时间
+    return qMax(1, qCeil((1.0 - it->dTokens) * 1000.0 / rate.dPerSecond));
+}
+
+void MCPAdmissionMiddleware::sweepBuckets(qint64 nNow)
+{
+    m_nLastSweepAt = nNow;
+    for (auto it = m_dictBuckets.begin(); it != m_dictBuckets.end();) {
+        const Rate rate = getRate(it.key().section(QLatin1Char('\n'), 1));
+        const double dRefilled = it->dTokens + (nNow - it->nLastRefillAt) * rate.dPerSecond / 1000.0;
+        if (dRefilled >= rate.dBurst) {
+            it = m_dictBuckets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+QSharedPointer<MCPServerMessage> MCPAdmissionMiddleware::reject(const QSharedPointer<MCPContext> &pContext, const QString &strReason, int nRetryAfterMs)
+{
+    ++m_nRejectedCount;
+    MCP_CORE_LOG_DEBUG() << "MCPAdmissionMiddleware: rejected:" << strReason << "retryAfterMs:" << nRetryAfterMs;
+
+    auto error = MCPError::rateLimitExceeded(strReason);
+    QJsonObject jsonData;
+    jsonData["retryAfterMs"] = nRetryAfterMs;
+    error.setData(jsonData);
+    return QSharedPointer<MCPServerErrorResponse>::create(pContext, error);
+}
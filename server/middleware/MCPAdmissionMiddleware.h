@@ -0,0 +1,118 @@
+/**
+ * @file MCPAdmissionMiddleware.h
+ * @brief MCP准入控制中间件（每会话每方法令牌桶、tools/call全局并发上限、排队延迟卸载）
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include "IMCPMiddleware.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+
+class MCPToolCallRegistry;
+class MCPToolExecutor;
+
+/**
+ * @brief 准入控制中间件
+ *
+ * 职责：
+ * - 每个会话的每个方法一个令牌桶，超出速率的请求直接拒绝，避免单个客户端占满服务
+ * - 限制全局进行中的 tools/call 数量（已受理但尚未应答的调用，包括排队中的）
+ * - 可选的 CoDel 式卸载：工具执行器出现持续排队（排队延迟在整个间隔内都高于目标）时拒绝新的 tools/call
+ * - 拒绝时返回 RATE_LIMIT_EXCEEDED 错误，data 中带 retryAfterMs 提示客户端何时重试
+ *
+ * 设计说明：
+ * - 只在MCPServer线程中访问，不加锁
+ * - 通知（notifications/*）没有应答，不能拒绝，不进入管道；notifications/cancelled 还能减轻负载
+ * - 空闲到已经补满的令牌桶与新建的桶等价，定期清理，不需要跟踪会话删除
+ *
+ * 编码规范：
+ * - 类成员添加 m_ 前缀
+ * - 指针类型添加 p 前缀
+ * - { 和 } 要单独一行
+ */
+class MCPAdmissionMiddleware : public IMCPMiddleware
+{
+public:
+    static constexpr int BUSY_RETRY_AFTER_MS = 100; // 并发已满时建议的重试间隔
+    static constexpr int SWEEP_INTERVAL_MS = 60000;  // 清理空闲令牌桶的间隔
+
+public:
+    /**
+     * @brief 构造函数
+     * @param pToolCalls 进行中的工具调用（全局并发上限）
+     * @param pToolExecutor 工具执行器（排队延迟卸载）
+     */
+    MCPAdmissionMiddleware(MCPToolCallRegistry *pToolCalls, MCPToolExecutor *pToolExecutor);
+    virtual ~MCPAdmissionMiddleware();
+
+public:
+    /**
+     * @brief 设置默认速率（每个会话的每个方法）
+     * @param dPerSecond 每秒补充的令牌数，<= 0 表示不限制
+     * @param nBurst 桶容量（允许的突发请求数），<= 0 时取每秒速率
+     */
+    void setRateLimit(double dPerSecond, int nBurst);
+
+    /**
+     * @brief 设置某个方法的速率，覆盖默认速率
+     * @param strMethod 方法名
+     * @param dPerSecond 每秒补充的令牌数，<= 0 表示不限制
+     * @param nBurst 桶容量，<= 0 时取每秒速率
+     */
+    void setMethodRateLimit(const QString &strMethod, double dPerSecond, int nBurst);
+
+    /**
+     * @brief 设置全局进行中的 tools/call 上限
+     * @param nMaxInFlightToolCalls 上限，<= 0 表示不限制
+     */
+    void setMaxInFlightToolCalls(int nMaxInFlightToolCalls);
+
+    // 被拒绝的请求数
+    quint64 getRejectedCount() const;
+
+    QSharedPointer<MCPServerMessage> process(const QSharedPointer<MCPContext> &pContext, std::function<QSharedPointer<MCPServerMessage>()> next) override;
+
+    // 通知没有应答，不进入管道
+    bool appliesTo(const QString &strMethod) const override;
+
+private:
+    struct Rate
+    {
+        double dPerSecond = 0;
+        double dBurst = 0;
+    };
+
+    struct Bucket
+    {
+        double dTokens = 0;
+        qint64 nLastRefillAt = 0;
+    };
+
+private:
+    Rate getRate(const QString &strMethod) const;
+
+    /**
+     * @brief 从令牌桶取一个令牌
+     * @return 0 表示放行，否则为建议的重试间隔（毫秒）
+     */
+    int takeToken(const QString &strSessionId, const QString &strMethod);
+
+    void sweepBuckets(qint64 nNow);
+
+    QSharedPointer<MCPServerMessage> reject(const QSharedPointer<MCPContext> &pContext, const QString &strReason, int nRetryAfterMs);
+
+private:
+    MCPToolCallRegistry *m_pToolCalls;
+    MCPToolExecutor *m_pToolExecutor;
+    Rate m_defaultRate;
+    QHash<QString, Rate> m_dictMethodRates;
+    int m_nMaxInFlightToolCalls;
+    QHash<QString, Bucket> m_dictBuckets; // "会话ID\n方法名" -> 令牌桶
+    QElapsedTimer m_clock;
+    qint64 m_nLastSweepAt;
+    quint64 m_nRejectedCount;
+};
@@ -11,6 +11,7 @@
 #include "MCPContext.h"
 #include "MCPError.h"
 #include "MCPLog.h"
+#include "MCPMetrics.h"
 #include "MCPServerMessage.h"
 #include "MCPSession.h"
 #include <QElapsedTimer>
@@ -59,6 +60,11 @@ QSharedPointer<MCPServerMessage> MCPPerformanceMiddleware::process(const QShared
     // 计算耗时
     qint64 nElapsed = timer.elapsed();
 
+    // 同步应答的请求在这里统计；tools/call 排队后返回空，完成时由 MCPRequestDispatcher 统计
+    if (pResponse != nullptr) {
+        MCPMetrics::instance()->recordRequest(strMethod, timer.nsecsElapsed() / 1000, pResponse.dynamicCast<MCPServerErrorResponse>() != nullptr);
+    }
+
     // 只记录慢请求
     if (nElapsed > m_nSlowThresholdMs) {
         MCP_CORE_LOG_WARNING() << "[慢请求] " << strMethod << " 耗时:" << nElapsed << "ms";
@@ -79,11 +85,6 @@ QSharedPointer<MCPServerMessage> MCPSessionValidationMiddleware::process(const Q
 {
     auto strMethod = pContext->getClientMessage()->getMethodName();
 
-    // 这些方法不需要会话验证
-    if (strMethod == "connect" || strMethod == "ping" || strMethod == "initialize") {
-        return next();
-    }
-
     // 验证会话存在
     auto pSession = pContext->getSession();
     if (!pSession) {
@@ -103,3 +104,9 @@ QSharedPointer<MCPServerMessage> MCPSessionValidationMiddleware::process(const Q
     // 验证通过，继续执行
     return next();
 }
+
+bool MCPSessionValidationMiddleware::appliesTo(const QString &strMethod) const
+{
+    // 这些方法不需要会话验证
+    return strMethod != "connect" && strMethod != "ping" && strMethod != "initialize";
+}
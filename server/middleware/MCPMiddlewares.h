@@ -39,7 +39,7 @@ public:
  * 职责：
  * - 监控请求处理时间
  * - 识别和记录慢请求
- * - 提供性能统计数据
+ * - 提供性能统计数据（按方法记录到 MCPMetrics，GET /metrics 输出）
  * 
  * 编码规范：
  * - 类成员添加 m_ 前缀
@@ -85,5 +85,8 @@ public:
     QSharedPointer<MCPServerMessage> process(
         const QSharedPointer<MCPContext>& pContext,
         std::function<QSharedPointer<MCPServerMessage>()> next) override;
+
+    // connect/ping/initialize 不需要会话验证，不进入这些方法的管道
+    bool appliesTo(const QString& strMethod) const override;
 };
 
@@ -3,7 +3,9 @@ QMAKE_INCDIR += $$PWD
 
 HEADERS += \
     $$PWD/IMCPMiddleware.h \
+    $$PWD/MCPAdmissionMiddleware.h \
     $$PWD/MCPMiddlewares.h
 
 SOURCES += \
+    $$PWD/MCPAdmissionMiddleware.cpp \
     $$PWD/MCPMiddlewares.cpp
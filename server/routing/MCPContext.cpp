@@ -12,7 +12,7 @@ MCPContext::MCPContext(quint64 nConnectionId, const QSharedPointer<MCPSession> &
     , m_pClientMessage(pClientMessage)
     , m_pSession(pSession)
 {
-    //
+    m_timer.start();
 }
 
 quint64 MCPContext::getConnectionId() const
@@ -31,4 +31,19 @@ QSharedPointer<MCPSession> MCPContext::getSession() const
 {
 
     return m_pSession;
-}
\ No newline at end of file
+}
+
+void MCPContext::setCancellationToken(const QSharedPointer<MCPCancellationToken> &pToken)
+{
+    m_pCancellationToken = pToken;
+}
+
+QSharedPointer<MCPCancellationToken> MCPContext::getCancellationToken() const
+{
+    return m_pCancellationToken;
+}
+
+qint64 MCPContext::getElapsedMicros() const
+{
+    return m_timer.nsecsElapsed() / 1000;
+}
@@ -7,8 +7,10 @@
 #include <QSet>
 #include <QString>
 #include <QSharedPointer>
+#include <QElapsedTimer>
 #include "MCPSession.h"
 #include "MCPClientMessage.h"
+#include "MCPCancellationToken.h"
 class MCPContext
 {
 public:
@@ -17,8 +19,15 @@ public:
 	quint64 getConnectionId() const ;
 	QSharedPointer<MCPClientMessage> getClientMessage() const ;
 	QSharedPointer<MCPSession> getSession() const;
+	// Cancellation token of cancellable requests (tools/call), null for other requests
+	void setCancellationToken(const QSharedPointer<MCPCancellationToken>& pToken);
+	QSharedPointer<MCPCancellationToken> getCancellationToken() const;
+	// Time since the request reached the server thread (latency metrics of asynchronously answered requests)
+	qint64 getElapsedMicros() const;
 private:
 	quint64 m_nConnectionId;
 	const QSharedPointer<MCPClientMessage> m_pClientMessage;
 	const QSharedPointer<MCPSession> m_pSession;
+	QSharedPointer<MCPCancellationToken> m_pCancellationToken;
+	QElapsedTimer m_timer;
 };
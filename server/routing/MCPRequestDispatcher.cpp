@@ -7,20 +7,26 @@
  */
 
 #include "MCPRequestDispatcher.h"
+#include "MCPAdmissionMiddleware.h"
 #include "MCPContext.h"
 #include "MCPError.h"
 #include "MCPInitializeHandler.h"
 #include "MCPLog.h"
+#include "MCPMetrics.h"
 #include "MCPMiddlewares.h"
+#include "MCPNotificationScheduler.h"
 #include "MCPPromptService.h"
 #include "MCPResourceService.h"
 #include "MCPRouter.h"
 #include "MCPServer.h"
+#include "MCPSessionService.h"
 #include "MCPSubscriptionHandler.h"
+#include "MCPTool.h"
+#include "MCPToolExecutor.h"
 #include "MCPToolService.h"
 #include <QJsonDocument>
 #include <QJsonParseError>
-#include <QtConcurrent>
+#include <QTimer>
 
 MCPRequestDispatcher::MCPRequestDispatcher(MCPServer *pServer, QObject *pParent)
     : QObject(pParent)
@@ -31,6 +37,9 @@ MCPRequestDispatcher::MCPRequestDispatcher(MCPServer *pServer, QObject *pParent)
 {
     // Initialize routing table
     initializeRoutes();
+
+    // A removed session can no longer receive answers: cancel its in-flight tool calls
+    QObject::connect(m_pServer->getSessionService(), &MCPSessionService::sessionRemoved, this, &MCPRequestDispatcher::onSessionRemoved);
 }
 
 
@@ -42,6 +51,8 @@ void MCPRequestDispatcher::initializeRoutes()
     m_pRouter->use(QSharedPointer<MCPLoggingMiddleware>::create());
     m_pRouter->use(QSharedPointer<MCPPerformanceMiddleware>::create(500)); // 500ms slow request threshold
     m_pRouter->use(QSharedPointer<MCPSessionValidationMiddleware>::create());
+    m_pAdmissionMiddleware = QSharedPointer<MCPAdmissionMiddleware>::create(&m_toolCalls, m_pServer->getToolExecutor());
+    m_pRouter->use(m_pAdmissionMiddleware);
 
     // Register all routes (using Lambda to bind member functions)
     m_pRouter->registerRoute("ping", [this](const QSharedPointer<MCPContext> &pContext) { return handlePing(pContext); });
@@ -52,6 +63,8 @@ void MCPRequestDispatcher::initializeRoutes()
 
     m_pRouter->registerRoute("notifications/initialized", [this](const QSharedPointer<MCPContext> &pContext) { return m_pInitializeHandler->handleInitialized(pContext); });
 
+    m_pRouter->registerRoute("notifications/cancelled", [this](const QSharedPointer<MCPContext> &pContext) { return handleCancelled(pContext); });
+
     m_pRouter->registerRoute("tools/list", [this](const QSharedPointer<MCPContext> &pContext) { return handleToolsList(pContext); });
 
     m_pRouter->registerRoute("tools/call", [this](const QSharedPointer<MCPContext> &pContext) { return handleToolsCall(pContext); });
@@ -77,8 +90,8 @@ void MCPRequestDispatcher::initializeRoutes()
 
 QSharedPointer<MCPServerMessage> MCPRequestDispatcher::handleClientMessage(const QSharedPointer<MCPContext> &pContext)
 {
-    QString strMethod = pContext->getClientMessage()->getMethodName();
-    return m_pRouter->dispatch(strMethod, pContext);
+    // The method ID was resolved when the message was parsed
+    return m_pRouter->dispatch(pContext);
 }
 
 QSharedPointer<MCPServerMessage> MCPRequestDispatcher::handleConnect(const QSharedPointer<MCPContext> &pContext)
@@ -94,13 +107,138 @@ QSharedPointer<MCPServerMessage> MCPRequestDispatcher::handleToolsList(const QSh
 
 QSharedPointer<MCPServerMessage> MCPRequestDispatcher::handleToolsCall(const QSharedPointer<MCPContext> &pContext)
 {
-    auto rc = QtConcurrent::run([this, pContext]() {
-        auto pServerMessage = syncHandleToolsCall(pContext);
-        emit this->serverMessageReceived(pServerMessage);
+    auto pToolExecutor = m_pServer->getToolExecutor();
+    auto jsonCall = pContext->getClientMessage()->getParmams().toObject();
+    auto strToolName = jsonCall.value("name").toString();
+
+    // Calls of a serialized tool share one lane, all other calls run concurrently
+    QString strLane;
+    int nTimeoutMs = pToolExecutor->getDefaultTimeout();
+    if (auto pTool = m_pServer->getToolService()->getTool(strToolName)) {
+        if (pTool->getConcurrency() == EnumToolConcurrency::enSerialized) {
+            strLane = strToolName;
+        }
+        if (pTool->getTimeout() > 0) {
+            nTimeoutMs = pTool->getTimeout();
+        }
+    }
+
+    // A request may shorten the deadline with params._meta.timeoutMs, never extend it
+    const int nRequestTimeoutMs = jsonCall.value("_meta").toObject().value("timeoutMs").toInt(0);
+    if (nRequestTimeoutMs > 0 && (nTimeoutMs <= 0 || nRequestTimeoutMs < nTimeoutMs)) {
+        nTimeoutMs = nRequestTimeoutMs;
+    }
+
+    auto pToken = QSharedPointer<MCPCancellationToken>::create();
+    auto jsonProgressToken = jsonCall.value("_meta").toObject().value("progressToken");
+    if (jsonProgressToken.isString() || jsonProgressToken.isDouble()) {
+        // The reporter is closed when the token finishes, so no progress follows the response
+        auto strSessionId = pContext->getSession()->getSessionId();
+        int nProgressIntervalMs = m_pServer->getNotificationScheduler()->getProgressInterval();
+        pToken->setProgressReporter(QSharedPointer<MCPProgressReporter>::create(jsonProgressToken, nProgressIntervalMs, [this, strSessionId](const QJsonObject &objNotification) {
+            emit progressNotification(strSessionId, objNotification);
+        }));
+    }
+    pContext->setCancellationToken(pToken);
+    m_toolCalls.add(pContext);
+
+    bool bQueued = pToolExecutor->submit(strLane, [this, pContext, pToken]() {
+        // Cancelled or timed out while queued: give the slot back without running the tool
+        if (pToken->isCancelled()) {
+            return;
+        }
+        MCPCancellationToken::Scope scope(pToken.data());
+        finishToolCall(pContext, EnumRequestState::enCompleted, syncHandleToolsCall(pContext));
     });
+    if (!bQueued) {
+        pToken->finish(EnumRequestState::enCancelled);
+        m_toolCalls.remove(pContext);
+        return QSharedPointer<MCPServerErrorResponse>::create(pContext, MCPError::rateLimitExceeded("Tool executor queue full"));
+    }
+
+    if (nTimeoutMs > 0) {
+        // Weak: the timer must not keep a finished call alive until its deadline
+        QWeakPointer<MCPContext> pWeakContext = pContext;
+        QTimer::singleShot(nTimeoutMs, this, [this, pWeakContext, nTimeoutMs]() {
+            if (auto pTimedOutContext = pWeakContext.toStrongRef()) {
+                auto error = MCPError::requestTimeout(QString("Tool call exceeded %1 ms").arg(nTimeoutMs));
+                finishToolCall(pTimedOutContext, EnumRequestState::enTimedOut, QSharedPointer<MCPServerErrorResponse>::create(pTimedOutContext, error));
+            }
+        });
+    }
     return QSharedPointer<MCPServerMessage>();
 }
 
+void MCPRequestDispatcher::finishToolCall(const QSharedPointer<MCPContext> &pContext, EnumRequestState enState, const QSharedPointer<MCPServerMessage> &pServerMessage)
+{
+    // Completion, cancellation and timeout race, only the first one answers
+    if (!pContext->getCancellationToken()->finish(enState)) {
+        return;
+    }
+    m_toolCalls.remove(pContext);
+    recordToolCallMetrics(pContext, enState, pServerMessage);
+    if (pServerMessage != nullptr) {
+        emit serverMessageReceived(pServerMessage);
+    }
+}
+
+void MCPRequestDispatcher::recordToolCallMetrics(const QSharedPointer<MCPContext> &pContext, EnumRequestState enState, const QSharedPointer<MCPServerMessage> &pServerMessage)
+{
+    auto pMetrics = MCPMetrics::instance();
+    if (enState == EnumRequestState::enCancelled) {
+        pMetrics->addCancelledToolCall();
+        return;
+    }
+
+    const qint64 nMicros = pContext->getElapsedMicros();
+    const bool bError = enState == EnumRequestState::enTimedOut || pServerMessage.dynamicCast<MCPServerErrorResponse>() != nullptr;
+    pMetrics->recordRequest("tools/call", nMicros, bError);
+
+    // Only registered tools get a series, unknown names from clients must not grow the label set
+    auto strToolName = pContext->getClientMessage()->getParmams().toObject().value("name").toString();
+    if (m_pServer->getToolService()->getTool(strToolName) != nullptr) {
+        pMetrics->recordToolCall(strToolName, nMicros, bError);
+    }
+}
+
+QSharedPointer<MCPServerMessage> MCPRequestDispatcher::handleCancelled(const QSharedPointer<MCPContext> &pContext)
+{
+    auto jsonParams = pContext->getClientMessage()->getParmams().toObject();
+    auto strSessionId = pContext->getSession()->getSessionId();
+    if (auto pCallContext = m_toolCalls.find(strSessionId, jsonParams.value("requestId"))) {
+        MCP_CORE_LOG_INFO() << "MCPRequestDispatcher: tool call cancelled:" << strSessionId << jsonParams.value("requestId") << jsonParams.value("reason").toString();
+        // According to the MCP specification, a cancelled request is not answered
+        finishToolCall(pCallContext, EnumRequestState::enCancelled, QSharedPointer<MCPServerMessage>());
+    }
+
+    // Notification: no response
+    return QSharedPointer<MCPServerMessage>::create(pContext, (MCPMessageType::Flags) MCPMessageType::ResponseNotification);
+}
+
+void MCPRequestDispatcher::onSessionRemoved(const QString &strSessionId)
+{
+    for (const auto &pCallContext : m_toolCalls.findBySession(strSessionId)) {
+        finishToolCall(pCallContext, EnumRequestState::enCancelled, QSharedPointer<MCPServerMessage>());
+    }
+}
+
+void MCPRequestDispatcher::cancelConnectionCalls(quint64 nConnectionId)
+{
+    for (const auto &pCallContext : m_toolCalls.findByConnection(nConnectionId)) {
+        finishToolCall(pCallContext, EnumRequestState::enCancelled, QSharedPointer<MCPServerMessage>());
+    }
+}
+
+MCPToolCallRegistry *MCPRequestDispatcher::getToolCallRegistry()
+{
+    return &m_toolCalls;
+}
+
+MCPAdmissionMiddleware *MCPRequestDispatcher::getAdmissionMiddleware() const
+{
+    return m_pAdmissionMiddleware.data();
+}
+
 QSharedPointer<MCPServerMessage> MCPRequestDispatcher::syncHandleToolsCall(const QSharedPointer<MCPContext> &pContext)
 {
     auto pClientMesage = pContext->getClientMessage().dynamicCast<MCPClientMessage>();
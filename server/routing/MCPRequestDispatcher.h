@@ -7,12 +7,16 @@
  */
 
 #pragma once
+#include "MCPCancellationToken.h"
 #include "MCPServerMessage.h"
+#include "MCPToolCallRegistry.h"
 #include <QJsonArray>
+#include <QJsonObject>
 #include <QObject>
 #include <QSharedPointer>
 #include <QString>
 
+class MCPAdmissionMiddleware;
 class MCPToolService;
 class MCPResourceService;
 class MCPPromptService;
@@ -54,6 +58,13 @@ public:
 signals:
     void serverMessageReceived(const QSharedPointer<MCPServerMessage> &pServerMessage);
 
+    /**
+     * @brief A running tool call reported progress (emitted from the executor thread)
+     * @param strSessionId Session ID of the call
+     * @param objNotification notifications/progress message
+     */
+    void progressNotification(const QString &strSessionId, const QJsonObject &objNotification);
+
 public:
     /**
      * @brief Handle client message
@@ -62,6 +73,20 @@ public:
      */
     QSharedPointer<MCPServerMessage> handleClientMessage(const QSharedPointer<MCPContext> &pContext);
 
+    /**
+     * @brief Cancel the tool calls answered on a closed connection (Streamable HTTP POST)
+     * @param nConnectionId Connection ID
+     */
+    void cancelConnectionCalls(quint64 nConnectionId);
+
+    MCPToolCallRegistry *getToolCallRegistry();
+
+    // Rate limits and tools/call admission, configured by MCPServer::doStart
+    MCPAdmissionMiddleware *getAdmissionMiddleware() const;
+
+private slots:
+    void onSessionRemoved(const QString &strSessionId);
+
 private:
     /**
      * @brief Initialize routing table
@@ -80,13 +105,19 @@ private:
     QSharedPointer<MCPServerMessage> handleListPrompts(const QSharedPointer<MCPContext> &pContext);
     QSharedPointer<MCPServerMessage> handleGetPrompt(const QSharedPointer<MCPContext> &pContext);
     QSharedPointer<MCPServerMessage> handlePing(const QSharedPointer<MCPContext> &pContext);
+    QSharedPointer<MCPServerMessage> handleCancelled(const QSharedPointer<MCPContext> &pContext);
 
 private:
     QSharedPointer<MCPServerMessage> syncHandleToolsCall(const QSharedPointer<MCPContext> &pContext);
+    // Answers a tool call unless it was already completed, cancelled or timed out (any thread)
+    void finishToolCall(const QSharedPointer<MCPContext> &pContext, EnumRequestState enState, const QSharedPointer<MCPServerMessage> &pServerMessage);
+    void recordToolCallMetrics(const QSharedPointer<MCPContext> &pContext, EnumRequestState enState, const QSharedPointer<MCPServerMessage> &pServerMessage);
 
 private:
     MCPServer *m_pServer;
     MCPRouter *m_pRouter;
     MCPInitializeHandler *m_pInitializeHandler;
     MCPSubscriptionHandler *m_pSubscriptionHandler;
+    MCPToolCallRegistry m_toolCalls; // in-flight tools/call requests
+    QSharedPointer<MCPAdmissionMiddleware> m_pAdmissionMiddleware;
 };
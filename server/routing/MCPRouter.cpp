@@ -11,7 +11,9 @@
 #include "MCPContext.h"
 #include "MCPError.h"
 #include "MCPLog.h"
+#include "MCPMethodRegistry.h"
 #include "MCPServerMessage.h"
+#include "MCPTrace.h"
 
 MCPRouter::MCPRouter(QObject *pParent)
     : QObject(pParent)
@@ -21,56 +23,68 @@ MCPRouter::~MCPRouter() {}
 
 void MCPRouter::registerRoute(const QString &strMethod, RouteHandler handler)
 {
-    if (m_dictRoutes.contains(strMethod)) {
+    // Process-wide ID, the same one the message parsers resolve for incoming requests
+    const int nMethodId = MCPMethodRegistry::intern(strMethod);
+    if (nMethodId >= m_arrRoutes.size()) {
+        m_arrRoutes.resize(nMethodId + 1);
+    }
+    if (m_arrRoutes[nMethodId] != nullptr) {
         MCP_CORE_LOG_WARNING() << "MCPRouter: Route already exist:" << strMethod;
     }
+    m_dictMethodIds.insert(strMethod, nMethodId);
 
-    m_dictRoutes[strMethod] = handler;
+    compileRoute(nMethodId, strMethod, handler);
 }
 
 void MCPRouter::unregisterRoute(const QString &strMethod)
 {
-    if (m_dictRoutes.remove(strMethod) == 0) {
+    int nMethodId = getMethodId(strMethod);
+    if (nMethodId < 0 || nMethodId >= m_arrRoutes.size() || m_arrRoutes[nMethodId] == nullptr) {
         MCP_CORE_LOG_WARNING() << "MCPRouter: Route not found for:" << strMethod;
+        return;
     }
+    m_arrRoutes[nMethodId].reset();
 }
 
-QSharedPointer<MCPServerMessage> MCPRouter::dispatch(const QString &strMethod, const QSharedPointer<MCPContext> &pContext)
+int MCPRouter::getMethodId(const QString &strMethod) const
 {
-    MCP_CORE_LOG_DEBUG() << "MCPRouter: -------------------------------------------";
-    MCP_CORE_LOG_DEBUG() << "MCPRouter: Dispatch:" << strMethod;
-    MCP_CORE_LOG_DEBUG() << "MCPRouter: id:" << pContext->getClientMessage()->getMethodId();
-    MCP_CORE_LOG_DEBUG() << "MCPRouter: name:" << pContext->getClientMessage()->getMethodName();
-    MCP_CORE_LOG_DEBUG() << "MCPRouter: sid:" << pContext->getClientMessage()->getSessionId();
-    MCP_CORE_LOG_DEBUG() << "MCPRouter: params:" << pContext->getClientMessage()->getParmams();
-
-    // Find the route processor
-    auto it = m_dictRoutes.find(strMethod);
-    if (it == m_dictRoutes.end()) {
-        MCP_CORE_LOG_WARNING() << "MCPRouter: No route for:" << strMethod;
-        return QSharedPointer<MCPServerErrorResponse>::create(pContext, MCPError::methodNotFound(QString("No route for method: %1").arg(strMethod)));
-    }
+    return MCPMethodRegistry::find(strMethod);
+}
 
-    RouteHandler finalHandler = it.value();
+QSharedPointer<MCPServerMessage> MCPRouter::dispatch(const QString &strMethod, const QSharedPointer<MCPContext> &pContext)
+{
+    return dispatch(getMethodId(strMethod), strMethod, pContext);
+}
 
-    // Build a middleware pipeline (wrapping from back to front)
-    std::function<QSharedPointer<MCPServerMessage>()> pipeline = [finalHandler, pContext]() {
-        return finalHandler(pContext);
-    };
+QSharedPointer<MCPServerMessage> MCPRouter::dispatch(const QSharedPointer<MCPContext> &pContext)
+{
+    auto pClientMessage = pContext->getClientMessage();
+    const int nMethodId = pClientMessage->getMethodNameId();
+    if (nMethodId < 0) {
+        // Unknown when the message was parsed, a route registered since then still gets a chance
+        return dispatch(pClientMessage->getMethodName(), pContext);
+    }
+    return dispatch(nMethodId, pClientMessage->getMethodName(), pContext);
+}
 
-    // Reverse order packaging of middleware (middleware added later is placed in the outer layer).
-    for (int i = m_listMiddlewares.size() - 1; i >= 0; --i) {
-        auto pMiddleware = m_listMiddlewares[i];
-        auto nextPipeline = pipeline; // 捕获当前pipeline
+QSharedPointer<MCPServerMessage> MCPRouter::dispatch(int nMethodId, const QString &strMethod, const QSharedPointer<MCPContext> &pContext)
+{
+    // One statement: the operands are only evaluated when debug output of the category is enabled
+    MCP_CORE_LOG_DEBUG() << "MCPRouter: Dispatch:" << strMethod << "id:" << pContext->getClientMessage()->getMethodId() << "sid:" << pContext->getClientMessage()->getSessionId()
+                         << "params:" << pContext->getClientMessage()->getParmams();
 
-        pipeline = [pMiddleware, pContext, nextPipeline]() {
-            return pMiddleware->process(pContext, nextPipeline);
-        };
+    // Find the compiled route, the reference keeps it alive even if routes are recompiled meanwhile
+    auto pRoute = (nMethodId >= 0 && nMethodId < m_arrRoutes.size()) ? m_arrRoutes.at(nMethodId) : QSharedPointer<const CompiledRoute>();
+    if (pRoute == nullptr) {
+        MCP_CORE_LOG_WARNING() << "MCPRouter: No route for:" << strMethod;
+        return QSharedPointer<MCPServerErrorResponse>::create(pContext, MCPError::methodNotFound(QString("No route for method: %1").arg(strMethod)));
     }
 
-    // Execute middleware pipeline and catch exceptions
+    // Execute the precompiled middleware pipeline and catch exceptions
     try {
-        return pipeline();
+        PipelineCursor cursor{pRoute.data(), &pContext};
+        MCPTraceSpan span("middleware");
+        return runPipeline(&cursor, 0);
     } catch (const MCPError &error) {
         MCP_CORE_LOG_WARNING() << "MCPRouter: Error:" << strMethod << ":" << error.getMessage();
         return QSharedPointer<MCPServerErrorResponse>::create(pContext, error);
@@ -83,24 +97,69 @@ QSharedPointer<MCPServerMessage> MCPRouter::dispatch(const QString &strMethod, c
     }
 }
 
+QSharedPointer<MCPServerMessage> MCPRouter::runPipeline(const PipelineCursor *pCursor, int nIndex)
+{
+    const auto &lstPipeline = pCursor->pRoute->lstPipeline;
+    if (nIndex >= lstPipeline.size()) {
+        // Nested in the "middleware" span, the difference is the cost of the chain itself
+        MCPTraceSpan span("route.handler");
+        return pCursor->pRoute->handler(*pCursor->pContext);
+    }
+
+    // The closure is two words, std::function stores it inline
+    return lstPipeline.at(nIndex)->process(*pCursor->pContext, [pCursor, nIndex]() { return runPipeline(pCursor, nIndex + 1); });
+}
+
+void MCPRouter::compileRoute(int nMethodId, const QString &strMethod, const RouteHandler &handler)
+{
+    // Middlewares that skip this method are left out once here instead of being checked per request
+    auto pRoute = QSharedPointer<CompiledRoute>::create();
+    pRoute->handler = handler;
+    for (const auto &pMiddleware : std::as_const(m_listMiddlewares)) {
+        if (pMiddleware->appliesTo(strMethod)) {
+            pRoute->lstPipeline.append(pMiddleware);
+        }
+    }
+    m_arrRoutes[nMethodId] = pRoute;
+}
+
+void MCPRouter::compileAllRoutes()
+{
+    for (auto it = m_dictMethodIds.cbegin(); it != m_dictMethodIds.cend(); ++it) {
+        if (auto pRoute = m_arrRoutes.at(it.value())) {
+            compileRoute(it.value(), it.key(), pRoute->handler);
+        }
+    }
+}
+
 bool MCPRouter::hasRoute(const QString &strMethod) const
 {
-    return m_dictRoutes.contains(strMethod);
+    int nMethodId = getMethodId(strMethod);
+    return nMethodId >= 0 && nMethodId < m_arrRoutes.size() && m_arrRoutes.at(nMethodId) != nullptr;
 }
 
 QStringList MCPRouter::getRegisteredRoutes() const
 {
-    return m_dictRoutes.keys();
+    QStringList lstRoutes;
+    for (auto it = m_dictMethodIds.cbegin(); it != m_dictMethodIds.cend(); ++it) {
+        if (m_arrRoutes.at(it.value()) != nullptr) {
+            lstRoutes.append(it.key());
+        }
+    }
+    lstRoutes.sort();
+    return lstRoutes;
 }
 
 void MCPRouter::use(QSharedPointer<IMCPMiddleware> pMiddleware)
 {
     m_listMiddlewares.append(pMiddleware);
+    compileAllRoutes();
 }
 
 void MCPRouter::clearMiddlewares()
 {
     m_listMiddlewares.clear();
+    compileAllRoutes();
 }
 
 int MCPRouter::getMiddlewareCount() const
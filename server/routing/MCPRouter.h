@@ -8,7 +8,7 @@
 
 #pragma once
 #include <QObject>
-#include <QMap>
+#include <QHash>
 #include <QList>
 #include <QString>
 #include <QSharedPointer>
@@ -30,6 +30,12 @@ class IMCPMiddleware;
  * 设计模式：
  * - 命令模式（Command Pattern）
  * - 使用std::function实现动态路由注册
+ *
+ * 性能说明：
+ * - 方法名注册时驻留为进程内唯一的整数ID（MCPMethodRegistry），路由表是按ID下标访问的数组
+ * - 消息解析时已确定方法ID（MCPClientMessage::getMethodNameId），调度时不再按字符串查找
+ * - 每个路由的中间件管道在路由或中间件变化时编译一次（已按 appliesTo 过滤），
+ *   调度时不再为每个请求嵌套构造std::function闭包
  * 
  * 编码规范：
  * - 类成员添加 m_ 前缀
@@ -62,6 +68,13 @@ public:
      */
     void unregisterRoute(const QString& strMethod);
     
+    /**
+     * @brief 获取方法名驻留后的ID
+     * @param strMethod 方法名
+     * @return 方法ID（进程内唯一），未注册过的方法返回 -1
+     */
+    int getMethodId(const QString& strMethod) const;
+
     /**
      * @brief 调度请求到对应的处理函数
      * @param strMethod 方法名
@@ -70,6 +83,24 @@ public:
      */
     QSharedPointer<MCPServerMessage> dispatch(const QString& strMethod, 
                                                const QSharedPointer<MCPContext>& pContext);
+
+    /**
+     * @brief 按消息解析时确定的方法ID调度请求
+     * @param pContext 请求上下文
+     * @return 响应消息，如果路由不存在返回错误消息
+     */
+    QSharedPointer<MCPServerMessage> dispatch(const QSharedPointer<MCPContext>& pContext);
+
+    /**
+     * @brief 按方法ID调度请求（调用方已缓存ID时跳过字符串查找）
+     * @param nMethodId 方法ID（getMethodId的返回值）
+     * @param strMethod 方法名（用于日志和错误信息）
+     * @param pContext 请求上下文
+     * @return 响应消息，如果路由不存在返回错误消息
+     */
+    QSharedPointer<MCPServerMessage> dispatch(int nMethodId,
+                                               const QString& strMethod,
+                                               const QSharedPointer<MCPContext>& pContext);
     
     /**
      * @brief 检查是否已注册某个路由
@@ -106,8 +137,31 @@ public:
     int getMiddlewareCount() const;
     
 private:
-    // 路由表：方法名 -> 处理函数
-    QMap<QString, RouteHandler> m_dictRoutes;
+    // 编译后的路由：处理函数 + 该方法适用的中间件（按执行顺序）
+    struct CompiledRoute
+    {
+        RouteHandler handler;
+        QList<QSharedPointer<IMCPMiddleware>> lstPipeline;
+    };
+
+    // 一次调度的执行位置（在栈上，next() 闭包只捕获指针和下标，不分配内存）
+    struct PipelineCursor
+    {
+        const CompiledRoute* pRoute;
+        const QSharedPointer<MCPContext>* pContext;
+    };
+
+private:
+    void compileRoute(int nMethodId, const QString& strMethod, const RouteHandler& handler);
+    void compileAllRoutes();
+    static QSharedPointer<MCPServerMessage> runPipeline(const PipelineCursor* pCursor, int nIndex);
+
+private:
+    // 本路由器注册过的方法名 -> 方法ID（ID来自 MCPMethodRegistry，注销路由不回收ID，已缓存的ID保持有效）
+    QHash<QString, int> m_dictMethodIds;
+
+    // 路由表：方法ID -> 编译后的路由（nullptr 表示已注销），调度时持有引用，重新编译不影响进行中的请求
+    QList<QSharedPointer<const CompiledRoute>> m_arrRoutes;
     
     // 中间件列表（按添加顺序执行）
     QList<QSharedPointer<IMCPMiddleware>> m_listMiddlewares;
@@ -0,0 +1,82 @@
+/**
+ * @file MCPToolCallRegistry.cpp
+ * @brief Registry of in-flight tool calls (cancellation and deadlines)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include "MCPToolCallRegistry.h"
+#include "MCPContext.h"
+#include "MCPMessageType.h"
+
+MCPToolCallRegistry::MCPToolCallRegistry() {}
+
+void MCPToolCallRegistry::add(const QSharedPointer<MCPContext> &pContext)
+{
+    Entry entry;
+    entry.pContext = pContext;
+    entry.strSessionId = pContext->getSession()->getSessionId();
+    // Streamable HTTP answers on the POST connection itself, SSE/stdio answer on the session's stream
+    if (pContext->getClientMessage()->getType() & MCPMessageType::StreamableTransport) {
+        entry.nConnectionId = pContext->getConnectionId();
+    }
+
+    const QString strKey = makeKey(entry.strSessionId, pContext->getClientMessage()->getMethodId());
+    QMutexLocker locker(&m_mutex);
+    m_dictCalls.insert(strKey, entry);
+}
+
+void MCPToolCallRegistry::remove(const QSharedPointer<MCPContext> &pContext)
+{
+    const QString strKey = makeKey(pContext->getSession()->getSessionId(), pContext->getClientMessage()->getMethodId());
+    QMutexLocker locker(&m_mutex);
+    auto it = m_dictCalls.find(strKey);
+    if (it != m_dictCalls.end() && it->pContext == pContext) {
+        m_dictCalls.erase(it);
+    }
+}
+
+QSharedPointer<MCPContext> MCPToolCallRegistry::find(const QString &strSessionId, const QJsonValue &jsonRequestId) const
+{
+    const QString strKey = makeKey(strSessionId, jsonRequestId);
+    QMutexLocker locker(&m_mutex);
+    return m_dictCalls.value(strKey).pContext;
+}
+
+QList<QSharedPointer<MCPContext>> MCPToolCallRegistry::findBySession(const QString &strSessionId) const
+{
+    QList<QSharedPointer<MCPContext>> lstContexts;
+    QMutexLocker locker(&m_mutex);
+    for (const auto &entry : m_dictCalls) {
+        if (entry.strSessionId == strSessionId) {
+            lstContexts.append(entry.pContext);
+        }
+    }
+    return lstContexts;
+}
+
+QList<QSharedPointer<MCPContext>> MCPToolCallRegistry::findByConnection(quint64 nConnectionId) const
+{
+    QList<QSharedPointer<MCPContext>> lstContexts;
+    QMutexLocker locker(&m_mutex);
+    for (const auto &entry : m_dictCalls) {
+        if (entry.nConnectionId == nConnectionId) {
+            lstContexts.append(entry.pContext);
+        }
+    }
+    return lstContexts;
+}
+
+int MCPToolCallRegistry::getInFlightCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_dictCalls.size());
+}
+
+QString MCPToolCallRegistry::makeKey(const QString &strSessionId, const QJsonValue &jsonRequestId)
+{
+    // JSON-RPC ids are strings or numbers, 1 and "1" are different requests
+    const QString strRequestId = jsonRequestId.isString() ? QStringLiteral("s:") + jsonRequestId.toString() : QStringLiteral("n:") + QString::number(jsonRequestId.toDouble(), 'g', 17);
+    return strSessionId + QLatin1Char('\n') + strRequestId;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file MCPToolCallRegistry.h
+ * @brief Registry of in-flight tool calls (cancellation and deadlines)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <QHash>
+#include <QJsonValue>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+
+class MCPContext;
+
+/**
+ * @brief In-flight tool call registry
+ *
+ * Responsibilities:
+ * - Track tools/call requests from submission until they are answered, cancelled or timed out
+ * - Find a call by (session, request id) for notifications/cancelled
+ * - Find all calls of a session or of a Streamable HTTP connection when it goes away
+ *
+ * Each registered context carries an MCPCancellationToken, the token decides which of
+ * completion, cancellation and timeout wins; the registry only locates the calls.
+ *
+ * Thread safety:
+ * - Calls are added/cancelled on the MCPServer thread and completed on executor workers, every method locks
+ *
+ * Coding conventions:
+ * - Class members add m_ prefix
+ * - Pointer types add p prefix
+ * - { and } should be on separate lines
+ */
+class MCPToolCallRegistry
+{
+public:
+    MCPToolCallRegistry();
+
+public:
+    /**
+     * @brief Register a call (a call with the same session and request id is replaced)
+     * @param pContext Request context with a cancellation token
+     */
+    void add(const QSharedPointer<MCPContext> &pContext);
+
+    /**
+     * @brief Unregister a call
+     * @param pContext Request context, ignored if another call has taken its key since
+     */
+    void remove(const QSharedPointer<MCPContext> &pContext);
+
+    /**
+     * @brief Find a call by its request id
+     * @param strSessionId Session ID
+     * @param jsonRequestId JSON-RPC id of the tools/call request
+     * @return Context, null if the call is not in flight
+     */
+    QSharedPointer<MCPContext> find(const QString &strSessionId, const QJsonValue &jsonRequestId) const;
+
+    /**
+     * @brief All in-flight calls of a session
+     */
+    QList<QSharedPointer<MCPContext>> findBySession(const QString &strSessionId) const;
+
+    /**
+     * @brief All in-flight calls answered on a connection (Streamable HTTP POST)
+     */
+    QList<QSharedPointer<MCPContext>> findByConnection(quint64 nConnectionId) const;
+
+    int getInFlightCount() const;
+
+private:
+    static QString makeKey(const QString &strSessionId, const QJsonValue &jsonRequestId);
+
+private:
+    struct Entry
+    {
+        QSharedPointer<MCPContext> pContext;
+        QString strSessionId;
+        quint64 nConnectionId = 0; // connection carrying the response, 0 if the response goes to the session's stream
+    };
+
+private:
+    mutable QMutex m_mutex;
+    QHash<QString, Entry> m_dictCalls; // "<session>\n<request id>" -> call
+};
@@ -5,10 +5,12 @@ HEADERS += \
     $$PWD/MCPContext.h \
     $$PWD/MCPRouter.h \
     $$PWD/MCPInitializeHandler.h \
-    $$PWD/MCPRequestDispatcher.h
+    $$PWD/MCPRequestDispatcher.h \
+    $$PWD/MCPToolCallRegistry.h
 
 SOURCES += \
     $$PWD/MCPContext.cpp \
     $$PWD/MCPRouter.cpp \
     $$PWD/MCPInitializeHandler.cpp \
-    $$PWD/MCPRequestDispatcher.cpp
+    $$PWD/MCPRequestDispatcher.cpp \
+    $$PWD/MCPToolCallRegistry.cpp
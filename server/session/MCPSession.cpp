@@ -16,7 +16,13 @@ MCPSession::MCPSession(QObject* parent)
 	, m_nSseConnectId(0)
 	, m_nConnectionId(0)
 	, m_enStatus(EnumSessionStatus::enConnect)
+	, m_nLastActiveTime(0)
+	, m_pLruPrev(nullptr)
+	, m_pLruNext(nullptr)
+	, m_nWheelSlot(-1)
+	, m_nPendingListBits(0)
 	, m_bIsStreamableTransport(false)
+	, m_bIsStdioTransport(false)
 {
 	m_strSessionId = QUuid::createUuid().toString().remove('{').remove('}');
 }
@@ -66,17 +72,24 @@ EnumSessionStatus MCPSession::setStatus(EnumSessionStatus enStatus)
 	return enPrevStatus;
 }
 
+static quint8 pendingListBit(MCPPendingNotificationType type)
+{
+	return static_cast<quint8>(1u << static_cast<int>(type));
+}
+
 void MCPSession::addPendingNotification(const MCPPendingNotification& notification)
 {
-	// 检查是否已存在相同的通知（避免重复）
-	for (const auto& existing : m_pendingNotifications)
+	if (notification.isResourceChanged())
 	{
-		if (existing == notification)
+		// 同一URI只保留一条，发送时读取最新内容
+		if (!m_setPendingUris.contains(notification.getUri()))
 		{
-			return;  // 已存在，不重复添加
+			m_setPendingUris.insert(notification.getUri());
+			m_lstPendingUris.append(notification.getUri());
 		}
+		return;
 	}
-	m_pendingNotifications.append(notification);
+	m_nPendingListBits |= pendingListBit(notification.getType());
 }
 
 void MCPSession::addResourceChangedNotification(const QString& strUri)
@@ -101,14 +114,29 @@ void MCPSession::addPromptsListChangedNotification()
 
 QList<MCPPendingNotification> MCPSession::takePendingNotifications()
 {
-	QList<MCPPendingNotification> notifications = m_pendingNotifications;
-	m_pendingNotifications.clear();
+	QList<MCPPendingNotification> notifications;
+	notifications.reserve(m_lstPendingUris.size() + 3);
+	for (const auto& strUri : std::as_const(m_lstPendingUris))
+	{
+		notifications.append(MCPPendingNotification(MCPPendingNotificationType::ResourceChanged, strUri));
+	}
+	for (auto type : {MCPPendingNotificationType::ResourcesListChanged, MCPPendingNotificationType::ToolsListChanged, MCPPendingNotificationType::PromptsListChanged})
+	{
+		if (m_nPendingListBits & pendingListBit(type))
+		{
+			notifications.append(MCPPendingNotification(type));
+		}
+	}
+
+	m_lstPendingUris.clear();
+	m_setPendingUris.clear();
+	m_nPendingListBits = 0;
 	return notifications;
 }
 
 bool MCPSession::hasPendingNotifications() const
 {
-	return !m_pendingNotifications.isEmpty();
+	return m_nPendingListBits != 0 || !m_lstPendingUris.isEmpty();
 }
 
 void MCPSession::setTransportType(bool bIsStreamable)
@@ -121,6 +149,16 @@ bool MCPSession::isStreamableTransport() const
 	return m_bIsStreamableTransport;
 }
 
+void MCPSession::setStdioTransport(bool bIsStdio)
+{
+	m_bIsStdioTransport = bIsStdio;
+}
+
+bool MCPSession::isStdioTransport() const
+{
+	return m_bIsStdioTransport;
+}
+
 void MCPSession::setConnectionId(quint64 nConnectionId)
 {
 	m_nConnectionId = nConnectionId;
@@ -131,3 +169,12 @@ quint64 MCPSession::getConnectionId() const
 	return m_nConnectionId;
 }
 
+qint64 MCPSession::getLastActiveTime() const
+{
+	return m_nLastActiveTime;
+}
+
+MCPSseEventBuffer& MCPSession::getSseEventBuffer()
+{
+	return m_sseEventBuffer;
+}
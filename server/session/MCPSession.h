@@ -1,5 +1,6 @@
 #pragma once
 #include "MCPPendingNotification.h"
+#include "MCPSseEventBuffer.h"
 #include <QDateTime>
 #include <QList>
 #include <QObject>
@@ -85,6 +86,18 @@ public:
      */
     bool isStreamableTransport() const;
 
+    /**
+     * @brief 设置是否为Stdio传输（通知通过连接ID立即推送，与SSE相同）
+     * @param bIsStdio true表示Stdio传输
+     */
+    void setStdioTransport(bool bIsStdio);
+
+    /**
+     * @brief 是否为Stdio传输
+     * @return true表示Stdio传输
+     */
+    bool isStdioTransport() const;
+
     /**
      * @brief 设置连接ID（用于StreamableTransport）
      * @param nConnectionId 连接ID
@@ -97,8 +110,20 @@ public:
      */
     quint64 getConnectionId() const;
 
+    /**
+     * @brief 获取最后活跃时间（单调时钟毫秒，由MCPSessionService在每次请求时更新）
+     * @return 最后活跃时间
+     */
+    qint64 getLastActiveTime() const;
+
+    /**
+     * @brief SSE事件缓冲区（事件ID分配和 Last-Event-ID 重放，只在MCPServer线程访问）
+     * @return 事件缓冲区
+     */
+    MCPSseEventBuffer &getSseEventBuffer();
+
 public:
-    quint64 m_nSseConnectId;
+    quint64 m_nSseConnectId; // SSE长连接ID（SSE/Stdio会话，或StreamableTransport会话打开的GET流），0 表示没有
     quint64 m_nConnectionId; // 通用连接ID（用于StreamableTransport）
     //
     QString m_strSessionId;
@@ -108,7 +133,17 @@ public:
     QString m_strProtocolVersion;
 
 private:
-    QDateTime m_lastTime;
-    QList<MCPPendingNotification> m_pendingNotifications; // 待发送的通知列表（用于StreamableTransport）
+    // 以下字段由MCPSessionService维护（索引、LRU链表、时间轮）
+    friend class MCPSessionService;
+    qint64 m_nLastActiveTime;
+    MCPSession *m_pLruPrev;
+    MCPSession *m_pLruNext;
+    int m_nWheelSlot;
+    // 待发送的通知（用于StreamableTransport）：列表变化用脏位，资源变化按URI哈希去重，插入O(1)
+    quint8 m_nPendingListBits;
+    QList<QString> m_lstPendingUris; // 保持到达顺序
+    QSet<QString> m_setPendingUris;
     bool m_bIsStreamableTransport;                        // 是否为StreamableTransport
+    bool m_bIsStdioTransport;                             // 是否为StdioTransport
+    MCPSseEventBuffer m_sseEventBuffer;                   // 已发送的SSE帧（用于断线续传）
 };
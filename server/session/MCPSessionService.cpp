@@ -10,56 +10,134 @@
 #include "MCPClientMessage.h"
 #include "MCPLog.h"
 #include "MCPSession.h"
-#include <QDateTime>
+#include <QTimer>
 
 MCPSessionService::MCPSessionService(QObject *parent)
     : QObject(parent)
-{}
+    , m_pLruHead(nullptr)
+    , m_pLruTail(nullptr)
+    , m_pWheelTimer(new QTimer(this))
+    , m_nWheelCursor(0)
+    , m_nSessionTimeoutMs(static_cast<qint64>(DEFAULT_SESSION_TIMEOUT) * 1000)
+    , m_nMaxSessions(DEFAULT_MAX_SESSIONS)
+    , m_nSseReplayBufferSize(DEFAULT_SSE_REPLAY_BUFFER_SIZE)
+    , m_nSseReplayRetentionMs(static_cast<qint64>(DEFAULT_SSE_REPLAY_RETENTION) * 1000)
+{
+    m_clock.start();
+    m_arrWheel.resize(WHEEL_SIZE);
+    m_pWheelTimer->setInterval(WHEEL_TICK_MS);
+    QObject::connect(m_pWheelTimer, &QTimer::timeout, this, &MCPSessionService::onWheelTick);
+}
 
 MCPSessionService::~MCPSessionService() {}
 
-void MCPSessionService::removeSessionBySSEConnectId(quint64 /*nConnectionId*/)
+void MCPSessionService::setLimits(int nSessionTimeout, int nMaxSessions)
+{
+    m_nSessionTimeoutMs = nSessionTimeout > 0 ? static_cast<qint64>(nSessionTimeout) * 1000 : 0;
+    m_nMaxSessions = nMaxSessions > 0 ? nMaxSessions : 0;
+
+    // 重新调度已有会话（超时时间可能变化）
+    wheelRescheduleAll();
+    evictOverflow();
+
+    MCP_CORE_LOG_INFO() << "MCPSessionService: timeout(s):" << nSessionTimeout << "maxSessions:" << m_nMaxSessions;
+}
+
+void MCPSessionService::setSseReplay(int nBufferSize, int nRetention)
+{
+    // 缓冲区大小只影响之后创建的会话
+    m_nSseReplayBufferSize = nBufferSize > 0 ? nBufferSize : 0;
+    m_nSseReplayRetentionMs = nRetention > 0 ? static_cast<qint64>(nRetention) * 1000 : 0;
+    wheelRescheduleAll();
+
+    MCP_CORE_LOG_INFO() << "MCPSessionService: SSE replay buffer:" << m_nSseReplayBufferSize << "retention(s):" << nRetention;
+}
+
+void MCPSessionService::removeSessionBySSEConnectId(quint64 nConnectionId)
 {
-    // -
+    // SSE会话的生命周期就是GET长连接，开启续传时保留到 retention 到期
+    if (auto pSession = m_dictSseConnections.take(nConnectionId)) {
+        if (pSession->isStreamableTransport()) {
+            // Streamable会话的GET流只是可选的推送通道，断开后回退到随下次请求发送
+            pSession->setSseConnectionId(0);
+            MCP_CORE_LOG_DEBUG() << "MCPSessionService: streamable SSE stream closed:" << pSession->getSessionId();
+            return;
+        }
+        if (m_nSseReplayRetentionMs > 0 && !pSession->isStdioTransport()) {
+            pSession->setSseConnectionId(0);
+            pSession->m_nLastActiveTime = m_clock.elapsed();
+            wheelReschedule(pSession);
+            MCP_CORE_LOG_DEBUG() << "MCPSessionService: SSE stream detached:" << pSession->getSessionId();
+            return;
+        }
+        removeSession(pSession, "connection closed");
+        return;
+    }
+    // Streamable会话通过Mcp-Session-Id继续存在，只解除连接索引
+    if (auto pSession = m_dictConnections.take(nConnectionId)) {
+        pSession->setConnectionId(0);
+    }
 }
 
 QSharedPointer<MCPSession> MCPSessionService::getSession(quint64 nConnectionId, const QSharedPointer<MCPClientMessage> pClientMessage)
 {
     auto strSessionId = pClientMessage->getSessionId();
-    if (auto pSession = m_dictSessions.value(strSessionId)) {
-        return pSession;
-    }
-    if (strSessionId.isEmpty()) {
-        auto enMsgType = pClientMessage->getType();
-        if ((enMsgType & MCPMessageType::SseTransport) && (enMsgType & MCPMessageType::Connect)) {
-            auto pSeesion = QSharedPointer<MCPSession>::create();
-            pSeesion->setSseConnectionId(nConnectionId);
-            pSeesion->setTransportType(false); // SSE传输
-            m_dictSessions[pSeesion->getSessionId()] = pSeesion;
-            return pSeesion;
-        } else if ((enMsgType & MCPMessageType::StreamableTransport) && (enMsgType & MCPMessageType::Initialize)) {
-            auto pSeesion = QSharedPointer<MCPSession>::create();
-            pSeesion->setTransportType(true);         // StreamableTransport传输
-            pSeesion->setConnectionId(nConnectionId); // 存储连接ID
-            m_dictSessions[pSeesion->getSessionId()] = pSeesion;
-            return pSeesion;
-        } else if (enMsgType & MCPMessageType::Ping) {
-            auto pSeesion = QSharedPointer<MCPSession>::create();
-            return pSeesion;
+    if (!strSessionId.isEmpty()) {
+        if (auto pSession = m_dictSessions.value(strSessionId)) {
+            touch(pSession.data());
+            if (pSession->isStreamableTransport() && (pClientMessage->getType() & MCPMessageType::Connect)) {
+                openStreamableStream(pSession.data(), nConnectionId);
+                return pSession;
+            }
+            // Streamable客户端可能换了keep-alive连接，索引指向最近一次使用的连接
+            if (pSession->isStreamableTransport() && pSession->getConnectionId() != nConnectionId) {
+                bindConnection(pSession.data(), nConnectionId);
+            }
+            return pSession;
+        }
+        return QSharedPointer<MCPSession>();
+    }
+
+    auto enMsgType = pClientMessage->getType();
+    if (enMsgType & MCPMessageType::StdioTransport) {
+        // stdio 进程内只有一个客户端，没有Mcp-Session-Id，会话按连接ID复用
+        if (auto pSession = m_dictSseConnections.value(nConnectionId, nullptr)) {
+            touch(pSession);
+            return m_dictSessions.value(pSession->getSessionId());
+        }
+        auto pSeesion = QSharedPointer<MCPSession>::create();
+        pSeesion->setTransportType(false);
+        pSeesion->setStdioTransport(true);
+        bindSseConnection(pSeesion.data(), nConnectionId); // 通知与SSE一样立即推送到该连接
+        return addSession(pSeesion);
+    } else if ((enMsgType & MCPMessageType::SseTransport) && (enMsgType & MCPMessageType::Connect)) {
+        auto strLastEventId = pClientMessage->getLastEventId();
+        if (!strLastEventId.isEmpty()) {
+            if (auto pSession = resumeSseSession(nConnectionId, strLastEventId)) {
+                return pSession;
+            }
         }
+        auto pSeesion = QSharedPointer<MCPSession>::create();
+        pSeesion->setTransportType(false); // SSE传输
+        pSeesion->getSseEventBuffer().setCapacity(m_nSseReplayBufferSize);
+        bindSseConnection(pSeesion.data(), nConnectionId);
+        return addSession(pSeesion);
+    } else if ((enMsgType & MCPMessageType::StreamableTransport) && (enMsgType & MCPMessageType::Initialize)) {
+        auto pSeesion = QSharedPointer<MCPSession>::create();
+        pSeesion->setTransportType(true);                // StreamableTransport传输
+        bindConnection(pSeesion.data(), nConnectionId); // 存储连接ID
+        return addSession(pSeesion);
+    } else if (enMsgType & MCPMessageType::Ping) {
+        // 临时会话，不进入存储
+        auto pSeesion = QSharedPointer<MCPSession>::create();
+        return pSeesion;
     }
     return QSharedPointer<MCPSession>();
 }
 
 QList<quint64> MCPSessionService::getAllActiveConnectionIds() const
 {
-    QList<quint64> connectionIds;
-    for (const auto &pSession : m_dictSessions.values()) {
-        if (pSession && pSession->getSseConnectionId() > 0) {
-            connectionIds.append(pSession->getSseConnectionId());
-        }
-    }
-    return connectionIds;
+    return m_dictSseConnections.keys();
 }
 
 QSharedPointer<MCPSession> MCPSessionService::getSessionBySessionId(const QString &strSessionId) const
@@ -69,22 +147,256 @@ QSharedPointer<MCPSession> MCPSessionService::getSessionBySessionId(const QStrin
 
 QSharedPointer<MCPSession> MCPSessionService::getSessionByConnectionId(quint64 nConnectionId) const
 {
-    // 首先尝试通过SSE连接ID查找
-    for (const auto &pSession : m_dictSessions.values()) {
-        if (pSession) {
-            if (pSession->getSseConnectionId() == nConnectionId) {
-                return pSession;
-            }
-            // 也检查StreamableTransport的连接ID
-            if (pSession->isStreamableTransport() && pSession->getConnectionId() == nConnectionId) {
-                return pSession;
-            }
-        }
+    auto pSession = m_dictSseConnections.value(nConnectionId, nullptr);
+    if (pSession == nullptr) {
+        pSession = m_dictConnections.value(nConnectionId, nullptr);
     }
-    return QSharedPointer<MCPSession>();
+    return pSession ? m_dictSessions.value(pSession->getSessionId()) : QSharedPointer<MCPSession>();
 }
 
 QList<QSharedPointer<MCPSession>> MCPSessionService::getAllSessions() const
 {
     return m_dictSessions.values();
 }
+
+int MCPSessionService::getSessionCount() const
+{
+    return static_cast<int>(m_dictSessions.size());
+}
+
+QSharedPointer<MCPSession> MCPSessionService::addSession(const QSharedPointer<MCPSession> &pSession)
+{
+    m_dictSessions.insert(pSession->getSessionId(), pSession);
+    touch(pSession.data());
+    evictOverflow();
+    return pSession;
+}
+
+void MCPSessionService::removeSession(MCPSession *pSession, const char *pReason)
+{
+    // 持有引用直到清理结束
+    auto pHolder = m_dictSessions.take(pSession->getSessionId());
+    if (pHolder == nullptr) {
+        return;
+    }
+
+    if (pSession->getSseConnectionId() != 0) {
+        m_dictSseConnections.remove(pSession->getSseConnectionId());
+    }
+    if (pSession->getConnectionId() != 0 && m_dictConnections.value(pSession->getConnectionId(), nullptr) == pSession) {
+        m_dictConnections.remove(pSession->getConnectionId());
+    }
+    lruUnlink(pSession);
+    wheelCancel(pSession);
+
+    const QString strSessionId = pSession->getSessionId();
+    MCP_CORE_LOG_INFO() << "MCPSessionService: remove session:" << strSessionId << pReason << "remaining:" << m_dictSessions.size();
+    emit sessionRemoved(strSessionId);
+}
+
+void MCPSessionService::touch(MCPSession *pSession)
+{
+    pSession->m_nLastActiveTime = m_clock.elapsed();
+    lruUnlink(pSession);
+    lruPushFront(pSession);
+    // 已在时间轮中的会话不移动，到期时按新的时间戳惰性重新调度
+    if (pSession->m_nWheelSlot < 0) {
+        wheelSchedule(pSession, pSession->m_nLastActiveTime);
+    }
+}
+
+QSharedPointer<MCPSession> MCPSessionService::resumeSseSession(quint64 nConnectionId, const QString &strLastEventId)
+{
+    QString strSessionId;
+    quint64 nLastEventId = 0;
+    if (!MCPSseEventBuffer::parseEventId(strLastEventId, strSessionId, nLastEventId)) {
+        return QSharedPointer<MCPSession>();
+    }
+
+    auto pSession = m_dictSessions.value(strSessionId);
+    if (pSession == nullptr || pSession->isStreamableTransport() || pSession->isStdioTransport()) {
+        return QSharedPointer<MCPSession>();
+    }
+
+    if (!pSession->getSseEventBuffer().canReplayAfter(nLastEventId)) {
+        // 错过的事件已被覆盖，无法无缺失续传，客户端需要新会话
+        MCP_CORE_LOG_WARNING() << "MCPSessionService: SSE replay gap:" << strSessionId << "last event:" << nLastEventId;
+        if (pSession->getSseConnectionId() == 0) {
+            removeSession(pSession.data(), "replay gap");
+        }
+        return QSharedPointer<MCPSession>();
+    }
+
+    // 旧连接可能还没检测到断开（半开连接），索引改指向新连接
+    if (auto nPrevId = pSession->getSseConnectionId()) {
+        m_dictSseConnections.remove(nPrevId);
+    }
+    bindSseConnection(pSession.data(), nConnectionId);
+    touch(pSession.data());
+
+    MCP_CORE_LOG_INFO() << "MCPSessionService: SSE stream resumed:" << strSessionId << "after event:" << nLastEventId;
+    return pSession;
+}
+
+void MCPSessionService::openStreamableStream(MCPSession *pSession, quint64 nConnectionId)
+{
+    // 每个会话只保留一个GET流，新的流替换旧的（旧连接可能是还没检测到断开的半开连接）
+    if (auto nPrevId = pSession->getSseConnectionId()) {
+        m_dictSseConnections.remove(nPrevId);
+    }
+    // 第一次打开流时才分配重放缓冲区，只用POST的会话没有这部分开销
+    if (pSession->getSseEventBuffer().getCapacity() == 0 && m_nSseReplayBufferSize > 0) {
+        pSession->getSseEventBuffer().setCapacity(m_nSseReplayBufferSize);
+    }
+    bindSseConnection(pSession, nConnectionId);
+
+    MCP_CORE_LOG_INFO() << "MCPSessionService: streamable SSE stream opened:" << pSession->getSessionId() << "connection:" << nConnectionId;
+}
+
+qint64 MCPSessionService::sessionTtlMs(const MCPSession *pSession) const
+{
+    // SSE流已断开的会话只保留到续传期限
+    if (!pSession->isStreamableTransport() && !pSession->isStdioTransport() && pSession->getSseConnectionId() == 0) {
+        return m_nSseReplayRetentionMs;
+    }
+    return m_nSessionTimeoutMs;
+}
+
+void MCPSessionService::bindSseConnection(MCPSession *pSession, quint64 nConnectionId)
+{
+    pSession->setSseConnectionId(nConnectionId);
+    m_dictSseConnections.insert(nConnectionId, pSession);
+}
+
+void MCPSessionService::bindConnection(MCPSession *pSession, quint64 nConnectionId)
+{
+    auto nPrevId = pSession->getConnectionId();
+    if (nPrevId != 0 && m_dictConnections.value(nPrevId, nullptr) == pSession) {
+        m_dictConnections.remove(nPrevId);
+    }
+    pSession->setConnectionId(nConnectionId);
+    m_dictConnections.insert(nConnectionId, pSession);
+}
+
+void MCPSessionService::lruPushFront(MCPSession *pSession)
+{
+    pSession->m_pLruPrev = nullptr;
+    pSession->m_pLruNext = m_pLruHead;
+    if (m_pLruHead != nullptr) {
+        m_pLruHead->m_pLruPrev = pSession;
+    }
+    m_pLruHead = pSession;
+    if (m_pLruTail == nullptr) {
+        m_pLruTail = pSession;
+    }
+}
+
+void MCPSessionService::lruUnlink(MCPSession *pSession)
+{
+    if (pSession->m_pLruPrev != nullptr) {
+        pSession->m_pLruPrev->m_pLruNext = pSession->m_pLruNext;
+    } else if (m_pLruHead == pSession) {
+        m_pLruHead = pSession->m_pLruNext;
+    }
+    if (pSession->m_pLruNext != nullptr) {
+        pSession->m_pLruNext->m_pLruPrev = pSession->m_pLruPrev;
+    } else if (m_pLruTail == pSession) {
+        m_pLruTail = pSession->m_pLruPrev;
+    }
+    pSession->m_pLruPrev = nullptr;
+    pSession->m_pLruNext = nullptr;
+}
+
+void MCPSessionService::wheelSchedule(MCPSession *pSession, qint64 nNow)
+{
+    const qint64 nTtlMs = sessionTtlMs(pSession);
+    if (nTtlMs <= 0) {
+        return; // 不过期
+    }
+
+    // 超过一圈的超时先停在最远的格子，到期后再继续调度
+    qint64 nRemainMs = pSession->m_nLastActiveTime + nTtlMs - nNow;
+    qint64 nTicks = (nRemainMs + WHEEL_TICK_MS - 1) / WHEEL_TICK_MS;
+    nTicks = qBound<qint64>(1, nTicks, WHEEL_SIZE - 1);
+    int nSlot = static_cast<int>((m_nWheelCursor + nTicks) % WHEEL_SIZE);
+    m_arrWheel[nSlot].insert(pSession);
+    pSession->m_nWheelSlot = nSlot;
+}
+
+void MCPSessionService::wheelCancel(MCPSession *pSession)
+{
+    if (pSession->m_nWheelSlot >= 0) {
+        m_arrWheel[pSession->m_nWheelSlot].remove(pSession);
+        pSession->m_nWheelSlot = -1;
+    }
+}
+
+void MCPSessionService::wheelReschedule(MCPSession *pSession)
+{
+    wheelCancel(pSession);
+    wheelSchedule(pSession, m_clock.elapsed());
+}
+
+void MCPSessionService::wheelRescheduleAll()
+{
+    const qint64 nNow = m_clock.elapsed();
+    for (auto &set : m_arrWheel) {
+        for (auto pSession : set) {
+            pSession->m_nWheelSlot = -1;
+        }
+        set.clear();
+    }
+    for (const auto &pSession : std::as_const(m_dictSessions)) {
+        wheelSchedule(pSession.data(), nNow);
+    }
+
+    if (m_nSessionTimeoutMs > 0 || m_nSseReplayRetentionMs > 0) {
+        m_pWheelTimer->start();
+    } else {
+        m_pWheelTimer->stop();
+    }
+}
+
+void MCPSessionService::onWheelTick()
+{
+    m_nWheelCursor = (m_nWheelCursor + 1) % WHEEL_SIZE;
+    QSet<MCPSession *> setDue;
+    setDue.swap(m_arrWheel[m_nWheelCursor]);
+
+    const qint64 nNow = m_clock.elapsed();
+    for (auto pSession : setDue) {
+        pSession->m_nWheelSlot = -1;
+        const qint64 nTtlMs = sessionTtlMs(pSession);
+        if (nTtlMs <= 0) {
+            continue; // 配置改为不过期
+        }
+        if (nNow - pSession->m_nLastActiveTime < nTtlMs) {
+            wheelSchedule(pSession, nNow);
+        } else if (pSession->getSseConnectionId() != 0) {
+            // SSE长连接（或stdio）仍然打开，客户端在线，不按空闲超时删除
+            pSession->m_nLastActiveTime = nNow;
+            wheelSchedule(pSession, nNow);
+        } else {
+            removeSession(pSession, "idle timeout");
+        }
+    }
+}
+
+void MCPSessionService::evictOverflow()
+{
+    // 流还开着的会话客户端在线（与空闲超时的处理一致），移到表头而不是淘汰，每个会话最多跳过一次
+    qsizetype nSkipped = 0;
+    while (m_nMaxSessions > 0 && m_dictSessions.size() > m_nMaxSessions && m_pLruTail != nullptr) {
+        auto pVictim = m_pLruTail;
+        if (pVictim->getSseConnectionId() == 0) {
+            removeSession(pVictim, "LRU eviction");
+            continue;
+        }
+        if (++nSkipped > m_dictSessions.size()) {
+            MCP_CORE_LOG_WARNING() << "MCPSessionService: maxSessions exceeded, all sessions have an open stream:" << m_dictSessions.size();
+            break;
+        }
+        lruUnlink(pVictim);
+        lruPushFront(pVictim);
+    }
+}
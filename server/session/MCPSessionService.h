@@ -1,13 +1,16 @@
 #pragma once
 #include <QObject>
-#include <QMap>
+#include <QHash>
 #include <QList>
-#include <QDateTime>
+#include <QSet>
+#include <QElapsedTimer>
 #include <QString>
 #include "MCPMessage.h"
 #include "MCPSession.h"
 #include "MCPClientMessage.h"
 
+class QTimer;
+
 /**
  * @brief MCP 会话服务
  *
@@ -15,16 +18,51 @@
  * - Session创建和验证
  * - Session状态维护
  * - 过期清理
+ *
+ * 数据结构：
+ * - 会话ID / SSE连接ID / Streamable连接ID 三个哈希索引，查找均为O(1)
+ * - 侵入式LRU双向链表（每次请求移到表头），超过最大会话数时淘汰表尾；
+ *   打开着SSE/GET流（或stdio）的会话不淘汰，否则流还连着却再也收不到事件
+ * - 时间轮（1秒一格）处理空闲超时；活跃只更新时间戳，到期时再惰性重新调度
+ * - SSE流断开后会话保留一段时间（sseReplayRetention），客户端携带 Last-Event-ID 重连时续传
+ *
+ * 只在MCPServer线程中访问，不加锁
  */
 class MCPSessionService : public QObject
 {
     Q_OBJECT
 
+public:
+    static constexpr int DEFAULT_SESSION_TIMEOUT = 30 * 60; // 秒
+    static constexpr int DEFAULT_MAX_SESSIONS = 10000;
+    static constexpr int DEFAULT_SSE_REPLAY_BUFFER_SIZE = 256; // 每个会话保留的SSE帧数
+    static constexpr int DEFAULT_SSE_REPLAY_RETENTION = 60;    // 秒
+    static constexpr int WHEEL_TICK_MS = 1000;
+    static constexpr int WHEEL_SIZE = 64;
+
 public:
     explicit MCPSessionService(QObject* pParent = nullptr);
     virtual ~MCPSessionService();
 public:
-    void removeSessionBySSEConnectId(quint64);
+    /**
+     * @brief 连接关闭：SSE连接关闭时删除会话，Streamable连接只解除索引
+     * @param nConnectionId 连接ID
+     */
+    void removeSessionBySSEConnectId(quint64 nConnectionId);
+
+    /**
+     * @brief 设置空闲超时和最大会话数
+     * @param nSessionTimeout 空闲超时（秒），<= 0 表示不过期
+     * @param nMaxSessions 最大会话数，<= 0 表示不限制
+     */
+    void setLimits(int nSessionTimeout, int nMaxSessions);
+
+    /**
+     * @brief 设置SSE断线续传参数
+     * @param nBufferSize 每个会话保留的SSE帧数，<= 0 表示不保留
+     * @param nRetention SSE流断开后会话保留的时间（秒），<= 0 表示断开即删除
+     */
+    void setSseReplay(int nBufferSize, int nRetention);
 
 public:
     QSharedPointer<MCPSession> getSession(quint64 nConnectionId, const QSharedPointer<MCPClientMessage> pClientMessage);
@@ -43,7 +81,7 @@ public:
     QSharedPointer<MCPSession> getSessionBySessionId(const QString& strSessionId) const;
 
     /**
-     * @brief 根据连接ID获取会话（用于StreamableTransport）
+     * @brief 根据连接ID获取会话（SSE连接或StreamableTransport连接）
      * @param nConnectionId 连接ID
      * @return 会话指针，如果不存在则返回nullptr
      */
@@ -55,6 +93,56 @@ public:
      */
     QList<QSharedPointer<MCPSession>> getAllSessions() const;
 
+    /**
+     * @brief 当前会话数
+     */
+    int getSessionCount() const;
+
+signals:
+    /**
+     * @brief 会话被删除（连接关闭、空闲超时或LRU淘汰）
+     * @param strSessionId 会话ID
+     */
+    void sessionRemoved(const QString& strSessionId);
+
+private slots:
+    void onWheelTick();
+
+private:
+    QSharedPointer<MCPSession> addSession(const QSharedPointer<MCPSession>& pSession);
+    void removeSession(MCPSession* pSession, const char* pReason);
+    void touch(MCPSession* pSession);
+    QSharedPointer<MCPSession> resumeSseSession(quint64 nConnectionId, const QString& strLastEventId);
+    void openStreamableStream(MCPSession* pSession, quint64 nConnectionId);
+    qint64 sessionTtlMs(const MCPSession* pSession) const;
+    void bindSseConnection(MCPSession* pSession, quint64 nConnectionId);
+    void bindConnection(MCPSession* pSession, quint64 nConnectionId);
+    // LRU
+    void lruPushFront(MCPSession* pSession);
+    void lruUnlink(MCPSession* pSession);
+    // 时间轮
+    void wheelSchedule(MCPSession* pSession, qint64 nNow);
+    void wheelCancel(MCPSession* pSession);
+    void wheelReschedule(MCPSession* pSession);
+    void wheelRescheduleAll();
+    void evictOverflow();
+
+private:
+    QHash<QString, QSharedPointer<MCPSession>> m_dictSessions;
+    QHash<quint64, MCPSession*> m_dictSseConnections;
+    QHash<quint64, MCPSession*> m_dictConnections;
+
+private:
+    MCPSession* m_pLruHead; // 最近活跃
+    MCPSession* m_pLruTail; // 最久未活跃
+
 private:
-    QMap<QString, QSharedPointer<MCPSession>> m_dictSessions;
+    QElapsedTimer m_clock;
+    QTimer* m_pWheelTimer;
+    QList<QSet<MCPSession*>> m_arrWheel;
+    int m_nWheelCursor;
+    qint64 m_nSessionTimeoutMs;
+    int m_nMaxSessions;
+    int m_nSseReplayBufferSize;
+    qint64 m_nSseReplayRetentionMs;
 };
@@ -0,0 +1,97 @@
+/**
+ * @file MCPSseEventBuffer.cpp
+ * @brief SSE事件环形缓冲区实现
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include "MCPSseEventBuffer.h"
+
+MCPSseEventBuffer::MCPSseEventBuffer(int nCapacity)
+    : m_nHead(0)
+    , m_nCount(0)
+    , m_nNextEventId(1)
+{
+    setCapacity(nCapacity);
+}
+
+void MCPSseEventBuffer::setCapacity(int nCapacity)
+{
+    m_arrFrames.clear();
+    m_arrFrames.resize(qMax(0, nCapacity));
+    m_nHead = 0;
+    m_nCount = 0;
+}
+
+int MCPSseEventBuffer::getCapacity() const
+{
+    return static_cast<int>(m_arrFrames.size());
+}
+
+quint64 MCPSseEventBuffer::nextEventId() const
+{
+    return m_nNextEventId;
+}
+
+void MCPSseEventBuffer::push(const QByteArrayList &lstFrame)
+{
+    ++m_nNextEventId;
+    const int nCapacity = getCapacity();
+    if (nCapacity == 0) {
+        return;
+    }
+
+    if (m_nCount < nCapacity) {
+        m_arrFrames[(m_nHead + m_nCount) % nCapacity] = lstFrame;
+        ++m_nCount;
+    } else {
+        // 已满，覆盖最旧的帧
+        m_arrFrames[m_nHead] = lstFrame;
+        m_nHead = (m_nHead + 1) % nCapacity;
+    }
+}
+
+bool MCPSseEventBuffer::canReplayAfter(quint64 nLastEventId) const
+{
+    // 缓冲区中的序号连续：[m_nNextEventId - m_nCount, m_nNextEventId - 1]
+    const quint64 nOldestEventId = m_nNextEventId - static_cast<quint64>(m_nCount);
+    return nLastEventId < m_nNextEventId && nLastEventId + 1 >= nOldestEventId;
+}
+
+QByteArrayList MCPSseEventBuffer::framesAfter(quint64 nLastEventId) const
+{
+    QByteArrayList lstParts;
+    if (!canReplayAfter(nLastEventId)) {
+        return lstParts;
+    }
+
+    const int nCapacity = getCapacity();
+    const quint64 nOldestEventId = m_nNextEventId - static_cast<quint64>(m_nCount);
+    const int nSkip = static_cast<int>(nLastEventId + 1 - nOldestEventId);
+    for (int i = nSkip; i < m_nCount; ++i) {
+        lstParts.append(m_arrFrames[(m_nHead + i) % nCapacity]);
+    }
+    return lstParts;
+}
+
+QByteArray MCPSseEventBuffer::formatEventId(const QString &strSessionId, quint64 nEventId)
+{
+    return strSessionId.toLatin1() + ':' + QByteArray::number(nEventId);
+}
+
+bool MCPSseEventBuffer::parseEventId(const QString &strEventId, QString &strSessionId, quint64 &nEventId)
+{
+    auto nPos = strEventId.lastIndexOf(':');
+    if (nPos <= 0) {
+        return false;
+    }
+
+    bool bOk = false;
+    nEventId = strEventId.mid(nPos + 1).toULongLong(&bOk);
+    if (!bOk) {
+        return false;
+    }
+    strSessionId = strEventId.left(nPos);
+    return true;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file MCPSseEventBuffer.h
+ * @brief SSE事件环形缓冲区（Last-Event-ID 断线续传）
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <QByteArray>
+#include <QByteArrayList>
+#include <QList>
+#include <QString>
+
+/**
+ * @brief SSE事件环形缓冲区
+ *
+ * 职责：
+ * - 为会话的SSE事件分配递增的事件序号
+ * - 保存最近N个已序列化的SSE帧（与发送的数据隐式共享，不复制）
+ * - 客户端携带 Last-Event-ID 重连时，给出之后的全部帧用于重放
+ *
+ * 事件ID格式：<SessionId>:<序号>，重连的GET请求只带 Last-Event-ID 也能找到会话
+ *
+ * 编码规范：
+ * - 类成员添加 m_ 前缀
+ * - { 和 } 要单独一行
+ */
+class MCPSseEventBuffer
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param nCapacity 最多保存的帧数，0 表示不保存（只分配序号）
+     */
+    explicit MCPSseEventBuffer(int nCapacity = 0);
+
+public:
+    /**
+     * @brief 设置容量（清空已保存的帧，序号继续递增）
+     * @param nCapacity 最多保存的帧数
+     */
+    void setCapacity(int nCapacity);
+    int getCapacity() const;
+
+    /**
+     * @brief 下一个push的帧将获得的事件序号
+     */
+    quint64 nextEventId() const;
+
+    /**
+     * @brief 保存一帧，序号为 nextEventId()，超出容量时覆盖最旧的帧
+     * @param lstFrame 已序列化的SSE帧
+     */
+    void push(const QByteArrayList& lstFrame);
+
+    /**
+     * @brief 客户端最后收到 nLastEventId 时，之后的帧是否都还在缓冲区中
+     * @param nLastEventId 客户端最后收到的事件序号
+     * @return true表示可以无缺失地重放
+     */
+    bool canReplayAfter(quint64 nLastEventId) const;
+
+    /**
+     * @brief 获取 nLastEventId 之后的全部帧（按顺序）
+     * @param nLastEventId 客户端最后收到的事件序号
+     * @return 帧分段，可直接写出
+     */
+    QByteArrayList framesAfter(quint64 nLastEventId) const;
+
+public:
+    /**
+     * @brief 生成事件ID
+     * @param strSessionId 会话ID
+     * @param nEventId 事件序号
+     * @return "<SessionId>:<序号>"
+     */
+    static QByteArray formatEventId(const QString& strSessionId, quint64 nEventId);
+
+    /**
+     * @brief 解析事件ID
+     * @param strEventId Last-Event-ID 的值
+     * @param strSessionId 输出会话ID
+     * @param nEventId 输出事件序号
+     * @return 格式正确返回true
+     */
+    static bool parseEventId(const QString& strEventId, QString& strSessionId, quint64& nEventId);
+
+private:
+    QList<QByteArrayList> m_arrFrames; // 环形存储
+    int m_nHead;                       // 最旧帧的位置
+    int m_nCount;                      // 当前保存的帧数
+    quint64 m_nNextEventId;            // 从1开始
+};
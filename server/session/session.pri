@@ -4,10 +4,12 @@ QMAKE_INCDIR += $$PWD
 HEADERS += \
     $$PWD/MCPSession.h \
     $$PWD/MCPPendingNotification.h \
+    $$PWD/MCPSseEventBuffer.h \
     $$PWD/MCPSessionService.h
 
 SOURCES += \
     $$PWD/MCPSession.cpp \
     $$PWD/MCPPendingNotification.cpp \
+    $$PWD/MCPSseEventBuffer.cpp \
     $$PWD/MCPSessionService.cpp
 
@@ -8,10 +8,13 @@
 
 #pragma once
 #include <MCPServer_global.h>
+#include <MCPTypedInvoker.h>
 #include <functional>
 #include <QJsonObject>
 #include <QObject>
 #include <QString>
+#include <QStringList>
+#include <type_traits>
 
 /**
  * @brief MCP tool service interface
@@ -92,6 +95,48 @@ public:
         const QString &strName, const QString &strTitle, const QString &strDescription, const QJsonObject &jsonInputSchema, const QJsonObject &jsonOutputSchema, std::function<QJsonObject()> execFun)
         = 0;
 
+    /**
+     * @brief Register tool (typed member function, bound at compile time)
+     * @tparam pMethod Member function pointer, the method must return QJsonObject
+     * @param strName Tool name
+     * @param strTitle Tool title
+     * @param strDescription Tool description
+     * @param jsonInputSchema Input Schema (JSON format)
+     * @param jsonOutputSchema Output Schema (JSON format)
+     * @param pHandler Handler object, a QObject handler unregisters the tool when destroyed
+     * @param lstArgumentNames JSON argument name of each method parameter, in declaration order
+     * @return true if registration is successful, false if it fails
+     *
+     * Arguments are unmarshalled by code generated for the parameter types (see MCPTypedInvoker)
+     * and the method is called directly, without QVariant conversion or metaobject lookup.
+     *
+     * Usage example:
+     * @code
+     * pToolService->addTyped<&MyHandler::readFile>("readFile", "Read File", "Read a text file",
+     *     inputSchema, outputSchema, pMyHandler, {"path", "offset", "length"});
+     * @endcode
+     */
+    template<auto pMethod>
+    bool addTyped(const QString &strName,
+                  const QString &strTitle,
+                  const QString &strDescription,
+                  const QJsonObject &jsonInputSchema,
+                  const QJsonObject &jsonOutputSchema,
+                  typename MCPTypedMethodTraits<decltype(pMethod)>::Class *pHandler,
+                  const QStringList &lstArgumentNames = QStringList())
+    {
+        using Traits = MCPTypedMethodTraits<decltype(pMethod)>;
+        if (pHandler == nullptr || lstArgumentNames.size() != Traits::nArguments) {
+            return false;
+        }
+
+        QObject *pLifetimeHandler = nullptr;
+        if constexpr (std::is_base_of_v<QObject, typename Traits::Class>) {
+            pLifetimeHandler = pHandler;
+        }
+        return addInvoker(strName, strTitle, strDescription, jsonInputSchema, jsonOutputSchema, pLifetimeHandler, MCPTypedInvoker::create<pMethod>(pHandler, lstArgumentNames));
+    }
+
     /**
      * @brief Unregister tool
      * @param strName Tool name
@@ -99,6 +144,15 @@ public:
      */
     virtual bool remove(const QString &strName) = 0;
 
+    /**
+     * @brief Drop cached results (tools annotated readOnlyHint/idempotentHint are cached)
+     * @param strToolName Tool name, empty drops the results of all tools
+     *
+     * Call this when the data behind a cached tool changes outside of tool calls,
+     * e.g. a file handler after writing a file. Safe to call from any thread.
+     */
+    virtual void invalidateCache(const QString &strToolName = QString()) = 0;
+
     /**
      * @brief Get tool list
      * @return Tool list (JSON array format)
@@ -135,6 +189,21 @@ public:
      */
     virtual bool addFromJson(const QJsonObject &jsonTool, QObject *pSearchRoot = nullptr) = 0;
 
+protected:
+    /**
+     * @brief Register tool with a typed invoker (backend of addTyped)
+     * @param pHandler QObject handler for lifetime and thread affinity, nullptr for other handlers
+     * @param execInvoker Invoker receiving the call arguments
+     */
+    virtual bool addInvoker(const QString &strName,
+                            const QString &strTitle,
+                            const QString &strDescription,
+                            const QJsonObject &jsonInputSchema,
+                            const QJsonObject &jsonOutputSchema,
+                            QObject *pHandler,
+                            std::function<QJsonObject(const QJsonObject &)> execInvoker)
+        = 0;
+
 signals:
     /**
      * @brief Tool list change signal
@@ -0,0 +1,57 @@
+/**
+ * @file MCPJsonConverter.cpp
+ * @brief Structural conversion from Qt JSON values to nlohmann::json
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include <MCPJsonConverter.h>
+#include <cmath>
+#include <cstdint>
+
+nlohmann::json MCPJsonConverter::toNlohmann(const QJsonValue &value)
+{
+    switch (value.type()) {
+        case QJsonValue::Bool:
+            return nlohmann::json(value.toBool());
+        case QJsonValue::Double: {
+            // QJsonDocument writes integral doubles without a fraction and nlohmann parses them as integers
+            double dValue = value.toDouble();
+            if (std::isfinite(dValue) && std::trunc(dValue) == dValue && std::fabs(dValue) < 9223372036854775808.0) {
+                return nlohmann::json(static_cast<std::int64_t>(dValue));
+            }
+            return nlohmann::json(dValue);
+        }
+        case QJsonValue::String: {
+            QByteArray byteUtf8 = value.toString().toUtf8();
+            return nlohmann::json(std::string(byteUtf8.constData(), static_cast<size_t>(byteUtf8.size())));
+        }
+        case QJsonValue::Array:
+            return toNlohmann(value.toArray());
+        case QJsonValue::Object:
+            return toNlohmann(value.toObject());
+        default:
+            return nlohmann::json();
+    }
+}
+
+nlohmann::json MCPJsonConverter::toNlohmann(const QJsonObject &object)
+{
+    nlohmann::json json = nlohmann::json::object();
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+        QByteArray byteKey = it.key().toUtf8();
+        json.emplace(std::string(byteKey.constData(), static_cast<size_t>(byteKey.size())), toNlohmann(it.value()));
+    }
+    return json;
+}
+
+nlohmann::json MCPJsonConverter::toNlohmann(const QJsonArray &array)
+{
+    nlohmann::json json = nlohmann::json::array();
+    json.get_ref<nlohmann::json::array_t &>().reserve(static_cast<size_t>(array.size()));
+    for (const QJsonValue &value : array) {
+        json.push_back(toNlohmann(value));
+    }
+    return json;
+}
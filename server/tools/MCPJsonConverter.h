@@ -0,0 +1,37 @@
+/**
+ * @file MCPJsonConverter.h
+ * @brief Structural conversion from Qt JSON values to nlohmann::json
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <json.hpp>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+
+/**
+ * @brief Qt JSON -> nlohmann::json converter
+ *
+ * Responsibilities:
+ * - Walk a QJsonValue tree and build the equivalent nlohmann::json directly,
+ *   without serializing to text and parsing it again (used to feed json_validator)
+ *
+ * Conversion rules (same result as QJsonDocument::toJson() + nlohmann::json::parse()):
+ * - Doubles with an integral value become integers, so "integer" schemas keep matching
+ * - Strings are converted to UTF-8
+ * - Undefined values become null
+ *
+ * Coding conventions:
+ * - Static methods, no instantiation required
+ * - { and } should be on separate lines
+ */
+class MCPJsonConverter
+{
+public:
+    static nlohmann::json toNlohmann(const QJsonValue &value);
+    static nlohmann::json toNlohmann(const QJsonObject &object);
+    static nlohmann::json toNlohmann(const QJsonArray &array);
+};
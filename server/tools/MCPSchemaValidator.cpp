@@ -0,0 +1,78 @@
+/**
+ * @file MCPSchemaValidator.cpp
+ * @brief Shared, lazily compiled JSON schema validators
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include <json-schema.hpp>
+#include <MCPJsonConverter.h>
+#include <MCPLog.h>
+#include <MCPSchemaValidator.h>
+#include <QJsonDocument>
+#include <stdexcept>
+
+// ============================================================================
+// MCPSchemaValidator
+// ============================================================================
+
+MCPSchemaValidator::MCPSchemaValidator(const QJsonObject &jsonSchema)
+    : m_jsonSchema(jsonSchema)
+{}
+
+MCPSchemaValidator::~MCPSchemaValidator() {}
+
+void MCPSchemaValidator::validate(const nlohmann::json &instance) const
+{
+    std::call_once(m_compileFlag, [this]() { compile(); });
+    if (m_pValidator == nullptr) {
+        throw std::runtime_error("invalid schema: " + m_strCompileError);
+    }
+    m_pValidator->validate(instance);
+}
+
+void MCPSchemaValidator::compile() const
+{
+    try {
+        auto pValidator = std::make_unique<nlohmann::json_schema::json_validator>();
+        pValidator->set_root_schema(MCPJsonConverter::toNlohmann(m_jsonSchema));
+        m_pValidator = std::move(pValidator);
+    } catch (const std::exception &e) {
+        m_strCompileError = e.what();
+        MCP_TOOLS_LOG_WARNING() << "MCPSchemaValidator: compile error:" << e.what();
+    }
+}
+
+// ============================================================================
+// MCPSchemaValidatorCache
+// ============================================================================
+
+QMutex MCPSchemaValidatorCache::s_mutex;
+QHash<QByteArray, QWeakPointer<MCPSchemaValidator>> MCPSchemaValidatorCache::s_dictValidators;
+qsizetype MCPSchemaValidatorCache::s_nSweepThreshold = 64;
+
+QSharedPointer<MCPSchemaValidator> MCPSchemaValidatorCache::acquire(const QJsonObject &jsonSchema)
+{
+    const QByteArray byteKey = QJsonDocument(jsonSchema).toJson(QJsonDocument::Compact);
+
+    QMutexLocker locker(&s_mutex);
+    auto it = s_dictValidators.find(byteKey);
+    if (it != s_dictValidators.end()) {
+        if (auto pValidator = it.value().toStrongRef()) {
+            return pValidator;
+        }
+    }
+
+    // Drop entries whose tools are gone, amortized: only when the table doubled since the last sweep
+    if (s_dictValidators.size() >= s_nSweepThreshold) {
+        for (auto itExpired = s_dictValidators.begin(); itExpired != s_dictValidators.end();) {
+            itExpired = itExpired.value().isNull() ? s_dictValidators.erase(itExpired) : std::next(itExpired);
+        }
+        s_nSweepThreshold = qMax<qsizetype>(64, s_dictValidators.size() * 2);
+    }
+
+    auto pValidator = QSharedPointer<MCPSchemaValidator>::create(jsonSchema);
+    s_dictValidators.insert(byteKey, pValidator.toWeakRef());
+    return pValidator;
+}
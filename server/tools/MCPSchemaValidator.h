@@ -0,0 +1,96 @@
+/**
+ * @file MCPSchemaValidator.h
+ * @brief Shared, lazily compiled JSON schema validators
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <json.hpp>
+#include <memory>
+#include <mutex>
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QWeakPointer>
+
+namespace nlohmann {
+namespace json_schema {
+class json_validator;
+}
+} // namespace nlohmann
+
+/**
+ * @brief JSON schema validator of one schema
+ *
+ * Responsibilities:
+ * - Own the nlohmann json_validator of a schema
+ * - Compile the schema on first use (tools that are never called never pay for it)
+ *
+ * Thread safety:
+ * - validate() may be called from several threads, compilation happens exactly once
+ *
+ * Coding conventions:
+ * - Class members add m_ prefix
+ * - { and } should be on separate lines
+ */
+class MCPSchemaValidator
+{
+public:
+    explicit MCPSchemaValidator(const QJsonObject &jsonSchema);
+    ~MCPSchemaValidator();
+
+public:
+    /**
+     * @brief Validate an instance against the schema
+     * @param instance Instance to validate
+     * @throws std::exception when the instance does not match or the schema failed to compile
+     */
+    void validate(const nlohmann::json &instance) const;
+
+private:
+    void compile() const;
+
+private:
+    QJsonObject m_jsonSchema;
+    mutable std::once_flag m_compileFlag;
+    mutable std::unique_ptr<nlohmann::json_schema::json_validator> m_pValidator; // nullptr when the schema is invalid
+    mutable std::string m_strCompileError;
+};
+
+/**
+ * @brief Process-wide cache of schema validators
+ *
+ * Responsibilities:
+ * - Hand out one shared MCPSchemaValidator per distinct schema, tools with identical
+ *   schemas (e.g. the default empty object schema) share it
+ * - Ownership stays with the tools (QSharedPointer), the cache only keeps weak
+ *   references so validators of removed tools are freed
+ *
+ * Design notes:
+ * - Keyed by the compact serialization of the schema (QJsonObject keys are sorted,
+ *   so equal schemas produce equal keys); QHash hashes the key
+ * - Only touched when a schema is set, never on the call path
+ *
+ * Coding conventions:
+ * - Static methods, no instantiation required
+ * - { and } should be on separate lines
+ */
+class MCPSchemaValidatorCache
+{
+public:
+    /**
+     * @brief Get the shared validator of a schema (not compiled yet)
+     * @param jsonSchema JSON schema
+     * @return Validator shared by every tool with the same schema
+     */
+    static QSharedPointer<MCPSchemaValidator> acquire(const QJsonObject &jsonSchema);
+
+private:
+    static QMutex s_mutex;
+    static QHash<QByteArray, QWeakPointer<MCPSchemaValidator>> s_dictValidators;
+    static qsizetype s_nSweepThreshold;
+};
@@ -5,15 +5,19 @@
  * @date 2025-01-01
  * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
  */
+#include <MCPCancellationToken.h>
+#include <MCPInvocationPlan.h>
+#include <MCPInvokeHelper.h>
+#include <MCPJsonConverter.h>
 #include <MCPLog.h>
-#include <MCPMethodHelper.h>
+#include <MCPSchemaValidator.h>
 #include <MCPTool.h>
-#include <json-schema.hpp>
-#include <json.hpp>
+#include <MCPTrace.h>
 #include <QDateTime>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QThread>
 
 MCPTool::MCPTool(const QString &strName, QObject *pParent)
     : QObject(pParent)
@@ -21,8 +25,15 @@ MCPTool::MCPTool(const QString &strName, QObject *pParent)
     , m_audience(QJsonArray())
     , m_priority(0.5) // Default priority is 0.5
     , m_strLastModified("")
+    , m_nCacheTtl(DEFAULT_CACHE_TTL)
+    , m_nTimeoutMs(0)
+    , m_enValidationPolicy(EnumToolValidationPolicy::enAlways)
+    , m_nValidationSampleInterval(1)
+    , m_nValidationCounter(0)
+    , m_enConcurrency(EnumToolConcurrency::enAffinity)
     , m_pExecHandler(nullptr)
     , m_execFun(nullptr)
+    , m_execInvoker(nullptr)
 {
     m_strExecMethodName = m_strName;
     m_strTitle = QString("Tool: %1").arg(m_strName);
@@ -37,6 +48,8 @@ MCPTool::MCPTool(const QString &strName, QObject *pParent)
                                      {"type", "object"},
                                      {"properties", QJsonObject{}},
                                      {"required", QJsonArray{}}};
+    m_pInputValidator = MCPSchemaValidatorCache::acquire(m_jsonInputSchema);
+    m_pOutputValidator = MCPSchemaValidatorCache::acquire(m_jsonOutputSchema);
 }
 
 MCPTool::~MCPTool() {}
@@ -58,6 +71,7 @@ MCPTool *MCPTool::withDescription(const QString &strDescription)
 MCPTool *MCPTool::withInputSchema(const QJsonObject &jsonInputSchema)
 {
     m_jsonInputSchema = jsonInputSchema;
+    m_pInputValidator = MCPSchemaValidatorCache::acquire(m_jsonInputSchema);
     return this;
 }
 
@@ -65,6 +79,7 @@ MCPTool *MCPTool::withInputSchema(const QJsonObject &jsonInputSchema)
 MCPTool *MCPTool::withOutputSchema(const QJsonObject &jsonOutputSchema)
 {
     m_jsonOutputSchema = jsonOutputSchema;
+    m_pOutputValidator = MCPSchemaValidatorCache::acquire(m_jsonOutputSchema);
     return this;
 }
 
@@ -97,6 +112,12 @@ MCPTool *MCPTool::withAnnotations(const QJsonObject &annotations)
         m_strLastModified = annotations["lastModified"].toString();
     }
 
+    for (const char *szHint : {"readOnlyHint", "idempotentHint", "destructiveHint", "openWorldHint"}) {
+        if (annotations.value(szHint).isBool()) {
+            m_jsonHints[szHint] = annotations.value(szHint);
+        }
+    }
+
     return this;
 }
 
@@ -116,6 +137,10 @@ QJsonObject MCPTool::getAnnotations() const
         annotations["lastModified"] = m_strLastModified;
     }
 
+    for (auto it = m_jsonHints.constBegin(); it != m_jsonHints.constEnd(); ++it) {
+        annotations[it.key()] = it.value();
+    }
+
     return annotations;
 }
 
@@ -165,7 +190,7 @@ MCPTool *MCPTool::withExecHandler(QObject *pExecHandler, const QString &strMetho
 
     if (m_pExecHandler == pExecHandler) {
         m_strExecMethodName = strMethodName.isEmpty() ? m_strExecMethodName : strMethodName;
-        initSchemaValidator();
+        m_pInvocationPlan = MCPInvocationPlan::create(pExecHandler, m_strExecMethodName);
         // Listen to Handler's destruction signal, notify ToolService when Handler is destroyed
         QObject::connect(pExecHandler, &QObject::destroyed, this, &MCPTool::onHandlerDestroyed);
     }
@@ -176,33 +201,25 @@ MCPTool *MCPTool::withExecHandler(QObject *pExecHandler, const QString &strMetho
 MCPTool *MCPTool::withExecFun(std::function<QJsonObject()> execFun)
 {
     m_execFun = execFun;
-    initSchemaValidator();
     return this;
 }
 
-void MCPTool::initSchemaValidator()
+MCPTool *MCPTool::withExecInvoker(QObject *pExecHandler, std::function<QJsonObject(const QJsonObject &)> execInvoker)
 {
-    static auto _initValidator = [](QObject *pThis, const QJsonObject &schemaObject, const char *szValidatorName) {
-        QScopedPointer<nlohmann::json_schema::json_validator> pValidator(new nlohmann::json_schema::json_validator());
-        try {
-            auto schemaData = QJsonDocument(schemaObject).toJson();
-            pValidator->set_root_schema(nlohmann::json::parse(schemaData.constData()));
-            pThis->setProperty(szValidatorName, QVariant::fromValue<void *>(pValidator.take()));
-        } catch (const std::exception &e) {
-            MCP_TOOLS_LOG_WARNING() << "initSchemaValidator:" << szValidatorName << " error: " << e.what();
-        }
-    };
-
-    // Directly use JSON Schema
-    _initValidator(this, m_jsonInputSchema, "InputValidator");
-    _initValidator(this, m_jsonOutputSchema, "OutputValidator");
+    m_execInvoker = execInvoker;
+    if (pExecHandler != nullptr && m_pExecHandler == nullptr) {
+        m_pExecHandler = pExecHandler;
+        QObject::connect(pExecHandler, &QObject::destroyed, this, &MCPTool::onHandlerDestroyed);
+    }
+    return this;
 }
 
 bool MCPTool::validateInput(const QJsonObject &inputObject)
 {
-    if (auto pValidator = (nlohmann::json_schema::json_validator *) property("InputValidator").value<void *>()) {
+    if (auto pValidator = m_pInputValidator) {
         try {
-            auto json = pValidator->validate(nlohmann::json::parse(QJsonDocument(inputObject).toJson().constData()));
+            // Converted structurally, no QJsonDocument text round trip
+            pValidator->validate(MCPJsonConverter::toNlohmann(inputObject));
             return true;
         } catch (const std::exception &e) {
             MCP_TOOLS_LOG_WARNING() << "Input validation failed: " << e.what();
@@ -226,9 +243,9 @@ bool MCPTool::validateOutput(const QJsonObject &outputObject)
         MCP_TOOLS_LOG_WARNING() << "missing field 'structuredContent'";
         return false;
     }
-    if (auto pValidator = (nlohmann::json_schema::json_validator *) property("OutputValidator").value<void *>()) {
+    if (auto pValidator = m_pOutputValidator) {
         try {
-            pValidator->validate(nlohmann::json::parse(QJsonDocument(outputObject.value("structuredContent").toObject()).toJson().constData()));
+            pValidator->validate(MCPJsonConverter::toNlohmann(outputObject.value("structuredContent").toObject()));
             return true;
         } catch (const std::exception &e) {
             MCP_TOOLS_LOG_WARNING() << "validator exception: " << e.what();
@@ -238,6 +255,98 @@ bool MCPTool::validateOutput(const QJsonObject &outputObject)
     return true;
 }
 
+MCPTool *MCPTool::withValidationPolicy(EnumToolValidationPolicy enPolicy, int nSampleInterval)
+{
+    m_enValidationPolicy = enPolicy;
+    m_nValidationSampleInterval = qMax(1, nSampleInterval);
+    return this;
+}
+
+EnumToolValidationPolicy MCPTool::validationPolicyFromString(const QString &strPolicy)
+{
+    if (strPolicy.compare("sampled", Qt::CaseInsensitive) == 0) {
+        return EnumToolValidationPolicy::enSampled;
+    }
+    if (strPolicy.compare("off", Qt::CaseInsensitive) == 0) {
+        return EnumToolValidationPolicy::enOff;
+    }
+    if (!strPolicy.isEmpty() && strPolicy.compare("always", Qt::CaseInsensitive) != 0) {
+        MCP_TOOLS_LOG_WARNING() << "MCPTool: unknown validation policy:" << strPolicy << "using always";
+    }
+    return EnumToolValidationPolicy::enAlways;
+}
+
+MCPTool *MCPTool::withConcurrency(EnumToolConcurrency enConcurrency)
+{
+    m_enConcurrency = enConcurrency;
+    return this;
+}
+
+EnumToolConcurrency MCPTool::getConcurrency() const
+{
+    return m_enConcurrency;
+}
+
+EnumToolConcurrency MCPTool::concurrencyFromString(const QString &strConcurrency)
+{
+    if (strConcurrency.compare("serialized", Qt::CaseInsensitive) == 0) {
+        return EnumToolConcurrency::enSerialized;
+    }
+    if (strConcurrency.compare("thread-safe", Qt::CaseInsensitive) == 0) {
+        return EnumToolConcurrency::enThreadSafe;
+    }
+    if (!strConcurrency.isEmpty() && strConcurrency.compare("affinity", Qt::CaseInsensitive) != 0) {
+        MCP_TOOLS_LOG_WARNING() << "MCPTool: unknown concurrency policy:" << strConcurrency << "using affinity";
+    }
+    return EnumToolConcurrency::enAffinity;
+}
+
+MCPTool *MCPTool::withCache(int nCacheTtl, const QStringList &lstCacheInvalidates)
+{
+    m_nCacheTtl = nCacheTtl;
+    m_lstCacheInvalidates = lstCacheInvalidates;
+    return this;
+}
+
+bool MCPTool::isCacheable() const
+{
+    return m_jsonHints.value("readOnlyHint").toBool() || m_jsonHints.value("idempotentHint").toBool();
+}
+
+int MCPTool::getCacheTtl() const
+{
+    return m_nCacheTtl;
+}
+
+QStringList MCPTool::getCacheInvalidates() const
+{
+    return m_lstCacheInvalidates;
+}
+
+MCPTool *MCPTool::withTimeout(int nTimeoutMs)
+{
+    m_nTimeoutMs = qMax(0, nTimeoutMs);
+    return this;
+}
+
+int MCPTool::getTimeout() const
+{
+    return m_nTimeoutMs;
+}
+
+bool MCPTool::shouldValidate()
+{
+    switch (m_enValidationPolicy) {
+        case EnumToolValidationPolicy::enOff:
+            return false;
+        case EnumToolValidationPolicy::enSampled:
+            // The first call is always validated, then one out of every interval
+            return m_nValidationCounter.fetchAndAddRelaxed(1) % static_cast<quint32>(m_nValidationSampleInterval) == 0;
+        default:
+            return true;
+    }
+}
+
 QString MCPTool::getName() const
 {
     return m_strName;
@@ -247,18 +356,49 @@ QJsonObject MCPTool::execute(const QJsonObject &jsonCallArguments)
 {
     QJsonObject jsonObject; //
 
-    validateInput(jsonCallArguments); // may false
+    // Input and output of the same call are validated together
+    const bool bValidate = shouldValidate();
+    if (bValidate) {
+        MCPTraceSpan span("tool.validate");
+        validateInput(jsonCallArguments); // may false
+    }
 
-    if (m_pExecHandler != nullptr) {
-        jsonObject = MCPMethodHelper::syncCallMethod( //
-                         m_pExecHandler,
-                         m_strExecMethodName, //
-                         jsonCallArguments.toVariantMap())
-                         .toJsonObject();
-        validateOutput(jsonObject);
+    if (m_execInvoker != nullptr || (m_pExecHandler != nullptr && m_pInvocationPlan != nullptr)) {
+        // The handler sees the call's cancellation token and trace even when marshalled onto its own thread
+        auto pToken = MCPCancellationToken::current();
+        const quint64 nTraceId = MCPTrace::currentTraceId();
+        auto callHandler = [&]() {
+            MCPCancellationToken::Scope scope(pToken);
+            MCPTrace::Scope traceScope(nTraceId);
+            MCPTraceSpan span("tool.handler");
+            if (m_execInvoker != nullptr) {
+                jsonObject = m_execInvoker(jsonCallArguments); // typed tools
+            } else {
+                jsonObject = m_pInvocationPlan->invoke(m_pExecHandler, jsonCallArguments).toJsonObject();
+            }
+        };
+
+        // Only affinity handlers are marshalled onto their own thread
+        if (m_enConcurrency == EnumToolConcurrency::enAffinity && m_pExecHandler != nullptr && m_pExecHandler->thread() != QThread::currentThread()) {
+            // Blocking hop: includes the wait for the handler's thread, "tool.handler" only the call
+            MCPTraceSpan span("tool.affinity");
+            MCPInvokeHelper::syncInvoke(m_pExecHandler, callHandler);
+        } else {
+            callHandler();
+        }
+        if (bValidate) {
+            MCPTraceSpan span("tool.validate");
+            validateOutput(jsonObject);
+        }
     } else if (m_execFun != nullptr) {
-        jsonObject = m_execFun();
-        validateOutput(jsonObject);
+        {
+            MCPTraceSpan span("tool.handler");
+            jsonObject = m_execFun();
+        }
+        if (bValidate) {
+            MCPTraceSpan span("tool.validate");
+            validateOutput(jsonObject);
+        }
     } else {
         jsonObject["success"] = false;
         jsonObject["error"] = "Execution handler not found or NULL.";
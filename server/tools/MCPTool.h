@@ -8,11 +8,35 @@
 
 #pragma once
 #include <functional>
+#include <QAtomicInteger>
 #include <QDateTime>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QObject>
+#include <QSharedPointer>
 #include <QString>
+#include <QStringList>
+
+class MCPInvocationPlan;
+class MCPSchemaValidator;
+
+/**
+ * @brief Schema validation policy of tool calls (tool config "validation")
+ */
+enum class EnumToolValidationPolicy {
+    enAlways,  // "always": validate input and output of every call (default)
+    enSampled, // "sampled": validate one call out of every validationSampleInterval calls
+    enOff      // "off": never validate
+};
+
+/**
+ * @brief Concurrency policy of tool calls (tool config "concurrency")
+ */
+enum class EnumToolConcurrency {
+    enAffinity,   // "affinity": calls run on the executor, the handler is invoked on its own thread (default)
+    enSerialized, // "serialized": one call at a time, the handler is invoked directly on the worker
+    enThreadSafe  // "thread-safe": calls run in parallel, the handler is invoked directly on the worker
+};
 
 /**
  * @brief MCP tool class
@@ -30,6 +54,10 @@
 class MCPTool : public QObject
 {
     Q_OBJECT
+public:
+    // Seconds, same as the "cacheTtl" default of JSON-configured tools (MCPToolsConfig)
+    static constexpr int DEFAULT_CACHE_TTL = 60;
+
 public:
     /**
      * @brief Constructor
@@ -53,6 +81,7 @@ public:
      * - audience: array, valid values are "user" and "assistant"
      * - priority: number between 0.0 and 1.0, indicating importance
      * - lastModified: ISO 8601 formatted timestamp
+     * - readOnlyHint, idempotentHint, destructiveHint, openWorldHint: booleans
      */
     MCPTool *withAnnotations(const QJsonObject &annotations);
 
@@ -85,6 +114,55 @@ public:
      */
     MCPTool *updateLastModified();
 
+    /**
+     * @brief Set the schema validation policy
+     * @param enPolicy Validation policy
+     * @param nSampleInterval For enSampled: validate one call out of every nSampleInterval calls
+     */
+    MCPTool *withValidationPolicy(EnumToolValidationPolicy enPolicy, int nSampleInterval = 1);
+
+    /**
+     * @brief Parse a validation policy name ("always", "sampled", "off")
+     * @param strPolicy Policy name, empty or unknown names map to enAlways
+     * @return Validation policy
+     */
+    static EnumToolValidationPolicy validationPolicyFromString(const QString &strPolicy);
+
+    /**
+     * @brief Set the concurrency policy
+     * @param enConcurrency Concurrency policy
+     */
+    MCPTool *withConcurrency(EnumToolConcurrency enConcurrency);
+    EnumToolConcurrency getConcurrency() const;
+
+    /**
+     * @brief Parse a concurrency policy name ("affinity", "serialized", "thread-safe")
+     * @param strConcurrency Policy name, empty or unknown names map to enAffinity
+     * @return Concurrency policy
+     */
+    static EnumToolConcurrency concurrencyFromString(const QString &strConcurrency);
+
+    /**
+     * @brief Set result caching
+     * @param nCacheTtl Seconds a cached result stays valid, <= 0 means until evicted or invalidated
+     * @param lstCacheInvalidates Tools whose cached results are dropped after a successful call of this tool
+     */
+    MCPTool *withCache(int nCacheTtl, const QStringList &lstCacheInvalidates);
+
+    /**
+     * @brief Whether results may be cached (annotated readOnlyHint or idempotentHint)
+     */
+    bool isCacheable() const;
+    int getCacheTtl() const;
+    QStringList getCacheInvalidates() const;
+
+    /**
+     * @brief Set the call deadline
+     * @param nTimeoutMs Milliseconds before a call is answered with a timeout error, 0 uses the server default
+     */
+    MCPTool *withTimeout(int nTimeoutMs);
+    int getTimeout() const;
+
 public:
     QString getName() const;
     QJsonObject execute(const QJsonObject &jsonCallArguments);
@@ -107,9 +185,10 @@ private slots:
 private:
     MCPTool *withExecHandler(QObject *pExecHandler, const QString &strMethodName = QString());
     MCPTool *withExecFun(std::function<QJsonObject()> execFun);
+    MCPTool *withExecInvoker(QObject *pExecHandler, std::function<QJsonObject(const QJsonObject &)> execInvoker);
 
 private:
-    void initSchemaValidator();
+    bool shouldValidate();
     bool validateInput(const QJsonObject &inputObject);
     bool validateOutput(const QJsonObject &outputObject);
 
@@ -119,15 +198,34 @@ private:
     QString m_strDescription;
     QJsonObject m_jsonInputSchema;
     QJsonObject m_jsonOutputSchema;
+    // Shared with every tool using the same schema, compiled on the first validated call
+    QSharedPointer<MCPSchemaValidator> m_pInputValidator;
+    QSharedPointer<MCPSchemaValidator> m_pOutputValidator;
 
     // Tool annotations, according to MCP protocol specification, optional
     QJsonArray m_audience;     // Audience array, valid values are "user" and "assistant"
     double m_priority;         // Priority, range 0.0 to 1.0
     QString m_strLastModified; // Last modified time, ISO 8601 format
+    QJsonObject m_jsonHints;   // readOnlyHint, idempotentHint, destructiveHint, openWorldHint
+
+    // Result cache
+    int m_nCacheTtl;
+    QStringList m_lstCacheInvalidates;
+
+    int m_nTimeoutMs;
+
+    // Schema validation policy, execute() may run on several threads at once
+    EnumToolValidationPolicy m_enValidationPolicy;
+    int m_nValidationSampleInterval;
+    QAtomicInteger<quint32> m_nValidationCounter;
+
+    EnumToolConcurrency m_enConcurrency;
 
     QObject *m_pExecHandler;
     QString m_strExecMethodName;
+    QSharedPointer<const MCPInvocationPlan> m_pInvocationPlan; // resolved once in withExecHandler
     std::function<QJsonObject()> m_execFun;
+    std::function<QJsonObject(const QJsonObject &)> m_execInvoker; // typed tools (IMCPToolService::addTyped)
 
 private:
     friend class MCPToolService;
@@ -0,0 +1,223 @@
+/**
+ * @file MCPToolExecutor.cpp
+ * @brief Tool call executor with its own bounded thread pool
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include <MCPLog.h>
+#include <MCPToolExecutor.h>
+#include <MCPTrace.h>
+#include <climits>
+#include <QThread>
+#include <QThreadPool>
+
+MCPToolExecutor::MCPToolExecutor(QObject *pParent)
+    : QObject(pParent)
+    , m_pThreadPool(new QThreadPool(this))
+    , m_nQueueSize(DEFAULT_QUEUE_SIZE)
+    , m_nDefaultTimeoutMs(0)
+    , m_nQueueDepth(0)
+    , m_nPeakQueueDepth(0)
+    , m_nActiveCount(0)
+    , m_nCompletedCount(0)
+    , m_nRejectedCount(0)
+    , m_nShedTargetMs(0)
+    , m_nShedIntervalMs(DEFAULT_SHED_INTERVAL_MS)
+    , m_nFirstAboveTargetAt(0)
+    , m_nLastQueueDelayMs(0)
+    , m_bOverloaded(0)
+{
+    m_clock.start();
+    m_pThreadPool->setMaxThreadCount(QThread::idealThreadCount());
+}
+
+MCPToolExecutor::~MCPToolExecutor()
+{
+    // Running calls reference this executor
+    m_pThreadPool->waitForDone();
+}
+
+void MCPToolExecutor::setLimits(int nThreads, int nQueueSize)
+{
+    m_pThreadPool->setMaxThreadCount(nThreads > 0 ? nThreads : QThread::idealThreadCount());
+    {
+        QMutexLocker locker(&m_mutex);
+        m_nQueueSize = nQueueSize > 0 ? nQueueSize : 0;
+    }
+    MCP_TOOLS_LOG_INFO() << "MCPToolExecutor: threads:" << m_pThreadPool->maxThreadCount() << "queue:" << nQueueSize;
+}
+
+void MCPToolExecutor::setDefaultTimeout(int nTimeoutMs)
+{
+    m_nDefaultTimeoutMs.storeRelaxed(nTimeoutMs > 0 ? nTimeoutMs : 0);
+}
+
+int MCPToolExecutor::getDefaultTimeout() const
+{
+    return m_nDefaultTimeoutMs.loadRelaxed();
+}
+
+void MCPToolExecutor::setShedding(int nTargetMs, int nIntervalMs)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_nShedTargetMs = nTargetMs > 0 ? nTargetMs : 0;
+        m_nShedIntervalMs = nIntervalMs > 0 ? nIntervalMs : DEFAULT_SHED_INTERVAL_MS;
+        m_nFirstAboveTargetAt = 0;
+        m_bOverloaded.storeRelaxed(0);
+    }
+    MCP_TOOLS_LOG_INFO() << "MCPToolExecutor: shed target(ms):" << m_nShedTargetMs << "interval(ms):" << m_nShedIntervalMs;
+}
+
+bool MCPToolExecutor::isOverloaded() const
+{
+    // An empty queue has no queueing delay, whatever the last measurement said
+    return m_bOverloaded.loadRelaxed() != 0 && m_nQueueDepth.loadRelaxed() > 0;
+}
+
+bool MCPToolExecutor::submit(const QString &strLane, std::function<void()> task)
+{
+    // Measure how long the call waits for a worker (pool queue or serialized lane)
+    const qint64 nEnqueuedAt = m_clock.elapsed();
+    // The worker continues the trace of the request that submitted the call
+    const quint64 nTraceId = MCPTrace::currentTraceId();
+    const qint64 nEnqueuedNs = MCPTrace::isEnabled() ? MCPTrace::nowNanos() : -1;
+    task = [this, nEnqueuedAt, nTraceId, nEnqueuedNs, task = std::move(task)]() {
+        recordQueueDelay(m_clock.elapsed() - nEnqueuedAt);
+        if (nEnqueuedNs >= 0) {
+            MCPTrace::record("tool.queue", nTraceId, nEnqueuedNs, MCPTrace::nowNanos(), true);
+        }
+        MCPTrace::Scope traceScope(nTraceId);
+        MCPTraceSpan span("tool.run");
+        task();
+    };
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_nQueueSize > 0 && m_nQueueDepth.loadRelaxed() >= m_nQueueSize) {
+            m_nRejectedCount.fetchAndAddRelaxed(1);
+            MCP_TOOLS_LOG_WARNING() << "MCPToolExecutor: queue full, rejected:" << strLane << "depth:" << m_nQueueDepth.loadRelaxed();
+            return false;
+        }
+
+        const int nDepth = m_nQueueDepth.fetchAndAddRelaxed(1) + 1;
+        if (nDepth > m_nPeakQueueDepth.loadRelaxed()) {
+            m_nPeakQueueDepth.storeRelaxed(nDepth);
+        }
+
+        if (!strLane.isEmpty()) {
+            // A call of this tool is already running: wait in its lane, not in the pool
+            auto &lane = m_dictLanes[strLane];
+            if (lane.bRunning) {
+                lane.queTasks.enqueue(std::move(task));
+                return true;
+            }
+            lane.bRunning = true;
+        }
+    }
+
+    start(strLane, std::move(task));
+    return true;
+}
+
+void MCPToolExecutor::start(const QString &strLane, std::function<void()> task)
+{
+    m_pThreadPool->start([this, strLane, task = std::move(task)]() {
+        m_nQueueDepth.fetchAndAddRelaxed(-1);
+        m_nActiveCount.fetchAndAddRelaxed(1);
+        try {
+            task();
+        } catch (const std::exception &e) {
+            MCP_TOOLS_LOG_CRITICAL() << "MCPToolExecutor: exception:" << strLane << e.what();
+        } catch (...) {
+            MCP_TOOLS_LOG_CRITICAL() << "MCPToolExecutor: unknown exception:" << strLane;
+        }
+        m_nActiveCount.fetchAndAddRelaxed(-1);
+        m_nCompletedCount.fetchAndAddRelaxed(1);
+
+        if (!strLane.isEmpty()) {
+            finishLaneTask(strLane);
+        }
+    });
+}
+
+void MCPToolExecutor::finishLaneTask(const QString &strLane)
+{
+    std::function<void()> nextTask;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_dictLanes.find(strLane);
+        if (it == m_dictLanes.end()) {
+            return;
+        }
+        if (it->queTasks.isEmpty()) {
+            m_dictLanes.erase(it);
+            return;
+        }
+        nextTask = it->queTasks.dequeue();
+    }
+
+    // The lane stays marked running, its next call takes the worker slot
+    start(strLane, std::move(nextTask));
+}
+
+void MCPToolExecutor::recordQueueDelay(qint64 nDelayMs)
+{
+    m_nLastQueueDelayMs.storeRelaxed(static_cast<int>(qMin<qint64>(nDelayMs, INT_MAX)));
+
+    QMutexLocker locker(&m_mutex);
+    if (m_nShedTargetMs <= 0) {
+        return;
+    }
+    // CoDel: a single slow start is a burst, a delay that stays above the target for a whole
+    // interval is a standing queue; one call starting within the target ends the overload
+    if (nDelayMs < m_nShedTargetMs) {
+        m_nFirstAboveTargetAt = 0;
+        m_bOverloaded.storeRelaxed(0);
+        return;
+    }
+    const qint64 nNow = m_clock.elapsed();
+    if (m_nFirstAboveTargetAt == 0) {
+        m_nFirstAboveTargetAt = nNow + m_nShedIntervalMs;
+    } else if (nNow >= m_nFirstAboveTargetAt && m_bOverloaded.loadRelaxed() == 0) {
+        m_bOverloaded.storeRelaxed(1);
+        MCP_TOOLS_LOG_WARNING() << "MCPToolExecutor: standing queue, shedding new calls, delay(ms):" << nDelayMs << "depth:" << m_nQueueDepth.loadRelaxed();
+    }
+}
+
+int MCPToolExecutor::getThreadCount() const
+{
+    return m_pThreadPool->maxThreadCount();
+}
+
+int MCPToolExecutor::getQueueDepth() const
+{
+    return m_nQueueDepth.loadRelaxed();
+}
+
+int MCPToolExecutor::getPeakQueueDepth() const
+{
+    return m_nPeakQueueDepth.loadRelaxed();
+}
+
+int MCPToolExecutor::getActiveCount() const
+{
+    return m_nActiveCount.loadRelaxed();
+}
+
+quint64 MCPToolExecutor::getCompletedCount() const
+{
+    return m_nCompletedCount.loadRelaxed();
+}
+
+quint64 MCPToolExecutor::getRejectedCount() const
+{
+    return m_nRejectedCount.loadRelaxed();
+}
+
+int MCPToolExecutor::getLastQueueDelay() const
+{
+    return m_nLastQueueDelayMs.loadRelaxed();
+}
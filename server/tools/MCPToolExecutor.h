@@ -0,0 +1,134 @@
+/**
+ * @file MCPToolExecutor.h
+ * @brief Tool call executor with its own bounded thread pool
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <functional>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QQueue>
+#include <QString>
+
+class QThreadPool;
+
+/**
+ * @brief Tool call executor
+ *
+ * Responsibilities:
+ * - Run tools/call requests on a dedicated, sized thread pool instead of the global QThreadPool
+ * - Bound the number of calls waiting for a worker, calls beyond the bound are rejected at once
+ * - Run the calls of a "serialized" tool one at a time (per-tool lane), other tools keep running in parallel
+ * - Expose queue depth and throughput counters
+ * - Detect a standing queue CoDel-style: when the queueing delay of started calls stays above a
+ *   target for a whole interval, the executor reports itself overloaded until a call starts within
+ *   the target again (admission control sheds new calls meanwhile, see MCPAdmissionMiddleware)
+ *
+ * How the handler itself is invoked (directly on the worker or marshalled onto the handler's
+ * thread) is decided by the tool's concurrency policy in MCPTool::execute
+ *
+ * Thread safety:
+ * - submit() is called from the MCPServer thread, lanes advance from worker threads
+ *
+ * Coding conventions:
+ * - Class members add m_ prefix
+ * - Pointer types add p prefix
+ * - { and } should be on separate lines
+ */
+class MCPToolExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_QUEUE_SIZE = 256;
+    static constexpr int DEFAULT_SHED_INTERVAL_MS = 100;
+
+public:
+    explicit MCPToolExecutor(QObject *pParent = nullptr);
+    virtual ~MCPToolExecutor();
+
+public:
+    /**
+     * @brief Set pool size and queue bound
+     * @param nThreads Worker threads, <= 0 means QThread::idealThreadCount()
+     * @param nQueueSize Calls allowed to wait for a worker, <= 0 means unbounded
+     */
+    void setLimits(int nThreads, int nQueueSize);
+
+    /**
+     * @brief Default deadline of tool calls without their own "timeoutMs"
+     * @param nTimeoutMs Milliseconds, <= 0 means no deadline
+     */
+    void setDefaultTimeout(int nTimeoutMs);
+    int getDefaultTimeout() const;
+
+    /**
+     * @brief Queueing delay target of the overload detection
+     * @param nTargetMs Acceptable time a call waits for a worker, <= 0 disables the detection
+     * @param nIntervalMs How long the delay must stay above the target before shedding starts
+     */
+    void setShedding(int nTargetMs, int nIntervalMs);
+
+    /**
+     * @brief Whether new calls should be shed because of a standing queue
+     * @return false if shedding is disabled or nothing is waiting
+     */
+    bool isOverloaded() const;
+
+    /**
+     * @brief Queue a tool call
+     * @param strLane Serialization lane (tool name of a "serialized" tool), empty to run concurrently
+     * @param task Call to run on a worker thread
+     * @return false if the queue is full and the call was rejected
+     */
+    bool submit(const QString &strLane, std::function<void()> task);
+
+public:
+    // Metrics
+    int getThreadCount() const;
+    int getQueueDepth() const;     // calls waiting for a worker (including serialized lanes)
+    int getPeakQueueDepth() const; // highest queue depth seen
+    int getActiveCount() const;    // calls running right now
+    quint64 getCompletedCount() const;
+    quint64 getRejectedCount() const;
+    int getLastQueueDelay() const; // ms the most recently started call waited for a worker
+
+private:
+    void start(const QString &strLane, std::function<void()> task);
+    void finishLaneTask(const QString &strLane);
+    void recordQueueDelay(qint64 nDelayMs);
+
+private:
+    struct Lane
+    {
+        bool bRunning = false;
+        QQueue<std::function<void()>> queTasks;
+    };
+
+private:
+    QThreadPool *m_pThreadPool;
+    int m_nQueueSize;
+    QAtomicInteger<int> m_nDefaultTimeoutMs;
+    QMutex m_mutex;
+    QHash<QString, Lane> m_dictLanes; // only lanes with a running or waiting call
+
+    QAtomicInteger<int> m_nQueueDepth;
+    QAtomicInteger<int> m_nPeakQueueDepth;
+    QAtomicInteger<int> m_nActiveCount;
+    QAtomicInteger<quint64> m_nCompletedCount;
+    QAtomicInteger<quint64> m_nRejectedCount;
+
+    // Overload detection, guarded by m_mutex except the flags read by isOverloaded()
+    QElapsedTimer m_clock;
+    int m_nShedTargetMs;
+    int m_nShedIntervalMs;
+    qint64 m_nFirstAboveTargetAt; // 0 while the delay is below the target
+    QAtomicInteger<int> m_nLastQueueDelayMs;
+    QAtomicInteger<int> m_bOverloaded;
+};
@@ -0,0 +1,137 @@
+/**
+ * @file MCPToolResultCache.cpp
+ * @brief Result cache of read-only/idempotent tools
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include <MCPLog.h>
+#include <MCPToolResultCache.h>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+
+MCPToolResultCache::MCPToolResultCache()
+    : m_nMaxBytes(DEFAULT_MAX_BYTES)
+    , m_nGeneration(0)
+    , m_nHitCount(0)
+    , m_nMissCount(0)
+{
+    m_clock.start();
+    m_cache.setMaxCost(m_nMaxBytes);
+}
+
+void MCPToolResultCache::setMaxBytes(qint64 nMaxBytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_nMaxBytes = nMaxBytes > 0 ? nMaxBytes : 0;
+    if (m_nMaxBytes == 0) {
+        m_cache.clear();
+        m_dictToolKeys.clear();
+        ++m_nGeneration;
+    } else {
+        m_cache.setMaxCost(m_nMaxBytes);
+    }
+    MCP_TOOLS_LOG_INFO() << "MCPToolResultCache: maxBytes:" << m_nMaxBytes;
+}
+
+bool MCPToolResultCache::isEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_nMaxBytes > 0;
+}
+
+bool MCPToolResultCache::lookup(const QString &strToolName, const QJsonObject &jsonArguments, QJsonObject &jsonResult)
+{
+    const QByteArray byteKey = makeKey(strToolName, jsonArguments);
+
+    QMutexLocker locker(&m_mutex);
+    // QCache::object() also moves the entry to the front of the LRU list
+    Entry *pEntry = m_cache.object(byteKey);
+    if (pEntry != nullptr && pEntry->nExpiresAt != 0 && pEntry->nExpiresAt <= m_clock.elapsed()) {
+        m_cache.remove(byteKey);
+        pEntry = nullptr;
+    }
+    if (pEntry == nullptr) {
+        m_nMissCount.fetchAndAddRelaxed(1);
+        return false;
+    }
+
+    m_nHitCount.fetchAndAddRelaxed(1);
+    jsonResult = pEntry->jsonResult;
+    return true;
+}
+
+quint64 MCPToolResultCache::getGeneration() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_nGeneration;
+}
+
+void MCPToolResultCache::insert(const QString &strToolName, const QJsonObject &jsonArguments, const QJsonObject &jsonResult, qint64 nTtlMs, quint64 nGeneration)
+{
+    const QByteArray byteKey = makeKey(strToolName, jsonArguments);
+    // Cost: serialized size is a close, cheap proxy of the memory held by the result
+    const qint64 nCost = QJsonDocument(jsonResult).toJson(QJsonDocument::Compact).size() + byteKey.size();
+
+    QMutexLocker locker(&m_mutex);
+    if (m_nMaxBytes == 0) {
+        return;
+    }
+    // Invalidated while the tool ran: the result may predate the write that invalidated it
+    if (nGeneration != m_nGeneration) {
+        return;
+    }
+
+    auto pEntry = new Entry();
+    pEntry->jsonResult = jsonResult;
+    pEntry->nExpiresAt = nTtlMs > 0 ? m_clock.elapsed() + nTtlMs : 0;
+    // Results larger than the whole budget are rejected (and deleted) by QCache
+    if (m_cache.insert(byteKey, pEntry, nCost)) {
+        auto &setKeys = m_dictToolKeys[strToolName];
+        setKeys.insert(byteKey);
+        // Evicted keys are pruned once they outnumber the live entries
+        if (setKeys.size() > 2 * m_cache.count() + 16) {
+            setKeys.removeIf([this](const QByteArray &byteOldKey) { return !m_cache.contains(byteOldKey); });
+        }
+    }
+}
+
+void MCPToolResultCache::invalidate(const QString &strToolName)
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_nGeneration;
+    if (strToolName.isEmpty()) {
+        m_cache.clear();
+        m_dictToolKeys.clear();
+        return;
+    }
+
+    const auto setKeys = m_dictToolKeys.take(strToolName);
+    for (const auto &byteKey : setKeys) {
+        m_cache.remove(byteKey);
+    }
+}
+
+qint64 MCPToolResultCache::getTotalBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.totalCost();
+}
+
+quint64 MCPToolResultCache::getHitCount() const
+{
+    return m_nHitCount.loadRelaxed();
+}
+
+quint64 MCPToolResultCache::getMissCount() const
+{
+    return m_nMissCount.loadRelaxed();
+}
+
+QByteArray MCPToolResultCache::makeKey(const QString &strToolName, const QJsonObject &jsonArguments)
+{
+    // QJsonObject keeps its keys sorted, so the compact form is canonical
+    const QByteArray byteArguments = QJsonDocument(jsonArguments).toJson(QJsonDocument::Compact);
+    return strToolName.toUtf8() + '\0' + QCryptographicHash::hash(byteArguments, QCryptographicHash::Sha1);
+}
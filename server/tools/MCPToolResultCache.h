@@ -0,0 +1,109 @@
+/**
+ * @file MCPToolResultCache.h
+ * @brief Result cache of read-only/idempotent tools
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QCache>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+/**
+ * @brief Tool result cache
+ *
+ * Responsibilities:
+ * - Memoize results of tools annotated with readOnlyHint/idempotentHint
+ * - Key: tool name + SHA-1 of the canonical (compact, key-sorted) JSON arguments
+ * - Bound the memory by a byte budget with LRU eviction (QCache, cost = result size)
+ * - Expire entries after the tool's TTL and drop them on explicit invalidation
+ * - Refuse results computed across an invalidation (see getGeneration), a call that started before
+ *   a concurrent write must not cache what it read before the write
+ *
+ * Thread safety:
+ * - Tool calls run on the tool executor's workers, every method locks
+ *
+ * Coding conventions:
+ * - Class members add m_ prefix
+ * - { and } should be on separate lines
+ */
+class MCPToolResultCache
+{
+public:
+    static constexpr qint64 DEFAULT_MAX_BYTES = 16 * 1024 * 1024;
+
+public:
+    MCPToolResultCache();
+
+public:
+    /**
+     * @brief Set the memory budget
+     * @param nMaxBytes Budget in bytes, <= 0 disables the cache and drops all entries
+     */
+    void setMaxBytes(qint64 nMaxBytes);
+    bool isEnabled() const;
+
+    /**
+     * @brief Look up a cached result
+     * @param strToolName Tool name
+     * @param jsonArguments Call arguments
+     * @param jsonResult Output result
+     * @return true on a fresh hit
+     */
+    bool lookup(const QString &strToolName, const QJsonObject &jsonArguments, QJsonObject &jsonResult);
+
+    /**
+     * @brief Invalidation generation, bumped by every invalidate() and cache reset
+     * @return Read it before running the tool and pass it to insert()
+     */
+    quint64 getGeneration() const;
+
+    /**
+     * @brief Store a result
+     * @param nTtlMs Time to live in milliseconds, <= 0 means until evicted or invalidated
+     * @param nGeneration getGeneration() taken before the result was computed, the result is dropped
+     *        if an invalidation happened since
+     */
+    void insert(const QString &strToolName, const QJsonObject &jsonArguments, const QJsonObject &jsonResult, qint64 nTtlMs, quint64 nGeneration);
+
+    /**
+     * @brief Drop all results of a tool
+     * @param strToolName Tool name, empty drops everything
+     */
+    void invalidate(const QString &strToolName);
+
+public:
+    // Metrics
+    qint64 getTotalBytes() const;
+    quint64 getHitCount() const;
+    quint64 getMissCount() const;
+
+private:
+    static QByteArray makeKey(const QString &strToolName, const QJsonObject &jsonArguments);
+
+private:
+    struct Entry
+    {
+        QJsonObject jsonResult;
+        qint64 nExpiresAt = 0; // 0 = no expiry
+    };
+
+private:
+    mutable QMutex m_mutex;
+    QCache<QByteArray, Entry> m_cache;
+    QHash<QString, QSet<QByteArray>> m_dictToolKeys; // tool name -> keys (may contain evicted keys)
+    QElapsedTimer m_clock;
+    qint64 m_nMaxBytes;
+    quint64 m_nGeneration;
+
+    QAtomicInteger<quint64> m_nHitCount;
+    QAtomicInteger<quint64> m_nMissCount;
+};
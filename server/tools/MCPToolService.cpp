@@ -7,6 +7,7 @@
  */
 
 
+#include <MCPCancellationToken.h>
 #include <MCPError.h>
 #include <MCPHandlerResolver.h>
 #include <MCPInvokeHelper.h>
@@ -43,6 +44,19 @@ bool MCPToolService::add(
     });
 }
 
+bool MCPToolService::addInvoker(const QString &strName,
+                                const QString &strTitle,
+                                const QString &strDescription,
+                                const QJsonObject &jsonInputSchema,
+                                const QJsonObject &jsonOutputSchema,
+                                QObject *pHandler,
+                                std::function<QJsonObject(const QJsonObject &)> execInvoker)
+{
+    return MCPInvokeHelper::syncInvokeReturn(this, [this, strName, strTitle, strDescription, jsonInputSchema, jsonOutputSchema, pHandler, execInvoker]() {
+        return doAddImpl(strName, strTitle, strDescription, jsonInputSchema, jsonOutputSchema, pHandler, execInvoker) != nullptr;
+    });
+}
+
 bool MCPToolService::remove(const QString &strName)
 {
     return MCPInvokeHelper::syncInvokeReturn(this, [this, strName]() { return doRemoveImpl(strName); });
@@ -94,6 +108,13 @@ bool MCPToolService::addFromConfig(const MCPToolConfig &toolConfig, const QMap<Q
         pTool->withAnnotations(toolConfig.annotations);
     }
 
+    if (pTool != nullptr) {
+        pTool->withValidationPolicy(MCPTool::validationPolicyFromString(toolConfig.strValidation), toolConfig.nValidationSampleInterval);
+        pTool->withConcurrency(MCPTool::concurrencyFromString(toolConfig.strConcurrency));
+        pTool->withCache(toolConfig.nCacheTtl, toolConfig.lstCacheInvalidates);
+        pTool->withTimeout(toolConfig.nTimeoutMs);
+    }
+
     return pTool != nullptr;
 }
 
@@ -157,6 +178,35 @@ MCPTool *MCPToolService::doAddImpl(const QString &strName,
     return pTool;
 }
 
+MCPTool *MCPToolService::doAddImpl(const QString &strName,
+                                   const QString &strTitle,
+                                   const QString &strDescription,
+                                   const QJsonObject &jsonInputSchema,
+                                   const QJsonObject &jsonOutputSchema,
+                                   QObject *pHandler,
+                                   std::function<QJsonObject(const QJsonObject &)> execInvoker)
+{
+    if (execInvoker == nullptr) {
+        MCP_TOOLS_LOG_WARNING() << "doAddImpl no invoker:" << strName;
+        return nullptr;
+    }
+
+    // Create tool object (set parent to this for lifecycle management)
+    MCPTool *pTool = (new MCPTool(strName, this))
+                         ->withTitle(strTitle) //
+                         ->withDescription(strDescription)
+                         ->withInputSchema(jsonInputSchema)
+                         ->withOutputSchema(jsonOutputSchema)
+                         ->withExecInvoker(pHandler, execInvoker);
+
+    // QObject handlers unregister the tool when destroyed
+    if (pHandler != nullptr) {
+        QObject::connect(pTool, &MCPTool::handlerDestroyed, this, &MCPToolService::onHandlerDestroyed);
+    }
+    registerTool(pTool);
+    return pTool;
+}
+
 bool MCPToolService::doRemoveImpl(const QString &strName, bool bEmitSignal)
 {
     if (!m_dictTools.contains(strName)) {
@@ -168,6 +218,7 @@ bool MCPToolService::doRemoveImpl(const QString &strName, bool bEmitSignal)
     if (pTool) {
         pTool->deleteLater();
     }
+    m_resultCache.invalidate(strName);
 
     //MCP_TOOLS_LOG_INFO() << "doRemoveImpl:" << strName;
     if (bEmitSignal) {
@@ -241,6 +292,16 @@ void MCPToolService::onHandlerDestroyed(const QString &strToolName)
     remove(strToolName);
 }
 
+void MCPToolService::invalidateCache(const QString &strToolName)
+{
+    m_resultCache.invalidate(strToolName);
+}
+
+MCPToolResultCache *MCPToolService::getResultCache()
+{
+    return &m_resultCache;
+}
+
 MCPTool *MCPToolService::getTool(const QString &strToolName) const
 {
     return m_dictTools.value(strToolName, nullptr);
@@ -255,7 +316,28 @@ QJsonObject MCPToolService::callTool(const QString &strToolName, const QJsonObje
         throw MCPError::toolNotFound(strToolName);
     }
     try {
-        return pTool->execute(jsonCallArguments);
+        // Read-only/idempotent tools: identical arguments return the memoized result
+        const bool bCacheable = pTool->isCacheable() && m_resultCache.isEnabled();
+        QJsonObject jsonResult;
+        if (bCacheable && m_resultCache.lookup(strToolName, jsonCallArguments, jsonResult)) {
+            return jsonResult;
+        }
+        const quint64 nCacheGeneration = bCacheable ? m_resultCache.getGeneration() : 0;
+
+        jsonResult = pTool->execute(jsonCallArguments);
+        // A cancelled handler may have returned early with a partial result
+        auto pToken = MCPCancellationToken::current();
+        const bool bCancelled = pToken != nullptr && pToken->isCancelled();
+        if (!bCancelled && !jsonResult.contains("error") && !jsonResult.value("isError").toBool()) {
+            if (bCacheable) {
+                m_resultCache.insert(strToolName, jsonCallArguments, jsonResult, pTool->getCacheTtl() * 1000LL, nCacheGeneration);
+            }
+            // e.g. a write tool drops the cached reads of the files it may have changed
+            for (const auto &strInvalidatedTool : pTool->getCacheInvalidates()) {
+                m_resultCache.invalidate(strInvalidatedTool);
+            }
+        }
+        return jsonResult;
     } catch (const MCPError &e) {
         // Re-throw MCPError exception
         throw e;
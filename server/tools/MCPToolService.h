@@ -14,6 +14,7 @@
 #include <QString>
 #include <functional>
 #include "IMCPToolService.h"
+#include "MCPToolResultCache.h"
 
 class MCPTool;
 class MCPError;
@@ -60,6 +61,17 @@ public:
     
     bool remove(const QString& strName) override;
 
+    void invalidateCache(const QString& strToolName = QString()) override;
+
+protected:
+    bool addInvoker(const QString& strName,
+                    const QString& strTitle,
+                    const QString& strDescription,
+                    const QJsonObject& jsonInputSchema,
+                    const QJsonObject& jsonOutputSchema,
+                    QObject* pHandler,
+                    std::function<QJsonObject(const QJsonObject&)> execInvoker) override;
+
 public:
 	//
     QJsonArray list() const override;
@@ -73,6 +85,8 @@ public:
     bool registerTool(MCPTool* pTool, QObject* pExecHandler, const QString& strMethodName = QString());
     bool registerTool(MCPTool* pTool, std::function<QJsonObject()> execFun);
     QJsonObject callTool(const QString& strMethodName, const QJsonObject& jsonCallArguments);
+    MCPTool* getTool(const QString& strToolName) const;
+    MCPToolResultCache* getResultCache();
 
 signals:
     /**
@@ -85,7 +99,6 @@ private:
 	void onHandlerDestroyed(const QString& strToolName);
 
 private:
-    MCPTool* getTool(const QString& strToolName) const;
 	bool registerTool(MCPTool* pTool); // For tools that have handler already set
 
 	/**
@@ -111,6 +124,18 @@ private:
                    const QJsonObject& jsonOutputSchema,
                    std::function<QJsonObject()> execFun);
 
+	/**
+	 * @brief Internal method: actually perform the add tool operation (using typed invoker)
+	 * @return Success returns tool object pointer, failure returns nullptr
+	 */
+	MCPTool* doAddImpl(const QString& strName,
+                   const QString& strTitle,
+                   const QString& strDescription,
+                   const QJsonObject& jsonInputSchema,
+                   const QJsonObject& jsonOutputSchema,
+                   QObject* pHandler,
+                   std::function<QJsonObject(const QJsonObject&)> execInvoker);
+
 	/**
 	 * @brief Internal method: actually perform the remove tool operation
 	 * @param strName Tool name
@@ -137,6 +162,7 @@ private:
 
 private:
     QMap<QString, MCPTool*> m_dictTools;
+    MCPToolResultCache m_resultCache;
     
 private:
 	friend class MCPAutoServer;
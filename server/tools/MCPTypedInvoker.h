@@ -0,0 +1,181 @@
+/**
+ * @file MCPTypedInvoker.h
+ * @brief Compile-time typed tool invokers (used by IMCPToolService::addTyped)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <MCPServer_global.h>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Member function traits of a typed tool handler method
+ */
+template<typename T>
+struct MCPTypedMethodTraits;
+
+template<typename ClassType, typename ReturnType, typename... Args>
+struct MCPTypedMethodTraits<ReturnType (ClassType::*)(Args...)>
+{
+    using Class = ClassType;
+    using Return = ReturnType;
+    using Arguments = std::tuple<std::decay_t<Args>...>;
+    static constexpr int nArguments = static_cast<int>(sizeof...(Args));
+};
+
+template<typename ClassType, typename ReturnType, typename... Args>
+struct MCPTypedMethodTraits<ReturnType (ClassType::*)(Args...) const> : MCPTypedMethodTraits<ReturnType (ClassType::*)(Args...)>
+{};
+
+/**
+ * @brief Typed tool invoker
+ *
+ * Responsibilities:
+ * - Deduce the parameter types of a handler method at compile time
+ * - Unmarshal the JSON call arguments straight into those types (no QVariant, no metaobject)
+ * - Call the member function directly
+ *
+ * Supported parameter types: QJsonValue, QJsonObject, QJsonArray, QString, QStringList, bool,
+ * integral and floating point types, QVariant. The method must return QJsonObject.
+ *
+ * Argument rules:
+ * - Absent arguments keep their default-constructed value (the input schema decides what is required)
+ * - Arguments of the wrong JSON type fail the call with an "error" result, so do fractional or
+ *   out-of-range numbers for integral parameters
+ *
+ * Coding conventions:
+ * - Class members add m_ prefix
+ * - Pointer types add p prefix
+ * - { and } should be on separate lines
+ */
+class MCPTypedInvoker
+{
+public:
+    using Invoker = std::function<QJsonObject(const QJsonObject &)>;
+
+public:
+    /**
+     * @brief Create the invoker of a handler method
+     * @tparam pMethod Member function pointer, e.g. &MyHandler::readFile
+     * @param pHandler Handler object
+     * @param lstArgumentNames JSON argument name of each parameter, in declaration order
+     * @return Invoker
+     */
+    template<auto pMethod>
+    static Invoker create(typename MCPTypedMethodTraits<decltype(pMethod)>::Class *pHandler, const QStringList &lstArgumentNames)
+    {
+        using Traits = MCPTypedMethodTraits<decltype(pMethod)>;
+        static_assert(std::is_same_v<typename Traits::Return, QJsonObject>, "typed tool methods must return QJsonObject");
+
+        return [pHandler, lstArgumentNames](const QJsonObject &jsonArguments) -> QJsonObject {
+            return invoke<pMethod>(pHandler, lstArgumentNames, jsonArguments, std::make_index_sequence<Traits::nArguments>{});
+        };
+    }
+
+    /**
+     * @brief Convert one JSON argument
+     * @param jsonValue JSON value (undefined if the argument is absent)
+     * @param value Output value
+     * @return false if the JSON type does not match the parameter type
+     */
+    template<typename T>
+    static bool fromJson(const QJsonValue &jsonValue, T &value)
+    {
+        if (jsonValue.isUndefined()) {
+            return true;
+        }
+
+        if constexpr (std::is_same_v<T, QJsonValue>) {
+            value = jsonValue;
+            return true;
+        } else if constexpr (std::is_same_v<T, QJsonObject>) {
+            value = jsonValue.toObject();
+            return jsonValue.isObject();
+        } else if constexpr (std::is_same_v<T, QJsonArray>) {
+            value = jsonValue.toArray();
+            return jsonValue.isArray();
+        } else if constexpr (std::is_same_v<T, QString>) {
+            value = jsonValue.toString();
+            return jsonValue.isString();
+        } else if constexpr (std::is_same_v<T, QStringList>) {
+            if (!jsonValue.isArray()) {
+                return false;
+            }
+            const auto arrValues = jsonValue.toArray();
+            value.reserve(arrValues.size());
+            for (const auto &jsonItem : arrValues) {
+                if (!jsonItem.isString()) {
+                    return false;
+                }
+                value.append(jsonItem.toString());
+            }
+            return true;
+        } else if constexpr (std::is_same_v<T, bool>) {
+            value = jsonValue.toBool();
+            return jsonValue.isBool();
+        } else if constexpr (std::is_integral_v<T>) {
+            // Whole numbers in the range of T only: 1.5, or -1 for an unsigned parameter, fail the call
+            if (!jsonValue.isDouble()) {
+                return false;
+            }
+            const double dValue = jsonValue.toDouble();
+            const double dLowest = static_cast<double>(std::numeric_limits<T>::lowest());
+            const double dUpperBound = std::ldexp(1.0, std::numeric_limits<T>::digits); // max() + 1, exact as a double
+            if (!(std::trunc(dValue) == dValue && dValue >= dLowest && dValue < dUpperBound)) {
+                return false;
+            }
+            // toInteger() is exact past 2^53 but stops at qint64, the upper half of quint64 comes from the double
+            value = dValue < std::ldexp(1.0, 63) ? static_cast<T>(jsonValue.toInteger()) : static_cast<T>(dValue);
+            return true;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            value = static_cast<T>(jsonValue.toDouble());
+            return jsonValue.isDouble();
+        } else if constexpr (std::is_same_v<T, QVariant>) {
+            value = jsonValue.toVariant();
+            return true;
+        } else {
+            static_assert(s_bUnsupportedType<T>, "unsupported typed tool parameter type");
+            return false;
+        }
+    }
+
+private:
+    template<auto pMethod, std::size_t... I>
+    static QJsonObject invoke(typename MCPTypedMethodTraits<decltype(pMethod)>::Class *pHandler,
+                              const QStringList &lstArgumentNames,
+                              const QJsonObject &jsonArguments,
+                              std::index_sequence<I...>)
+    {
+        typename MCPTypedMethodTraits<decltype(pMethod)>::Arguments tupArguments;
+
+        // Stops at the first argument that cannot be converted
+        int nBadIndex = -1;
+        ((nBadIndex < 0 && !fromJson(jsonArguments.value(lstArgumentNames[static_cast<int>(I)]), std::get<I>(tupArguments)) ? nBadIndex = static_cast<int>(I) : 0), ...);
+        if (nBadIndex >= 0) {
+            QJsonObject jsonObject;
+            jsonObject["success"] = false;
+            jsonObject["error"] = QString("Invalid argument type: %1").arg(lstArgumentNames[nBadIndex]);
+            return jsonObject;
+        }
+
+        return std::invoke(pMethod, pHandler, std::get<I>(tupArguments)...);
+    }
+
+private:
+    template<typename T>
+    static constexpr bool s_bUnsupportedType = false;
+};
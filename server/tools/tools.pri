@@ -3,14 +3,23 @@ QMAKE_INCDIR += $$PWD
 
 HEADERS += \
     $$PWD/MCPTool.h \
+    $$PWD/MCPJsonConverter.h \
+    $$PWD/MCPSchemaValidator.h \
+    $$PWD/MCPToolExecutor.h \
+    $$PWD/MCPToolResultCache.h \
     $$PWD/IMCPToolService.h \
     $$PWD/MCPToolInputSchema.h \
     $$PWD/MCPToolOutputSchema.h \
     $$PWD/MCPToolNotificationHandler.h \
-    $$PWD/MCPToolService.h
+    $$PWD/MCPToolService.h \
+    $$PWD/MCPTypedInvoker.h
 
 SOURCES += \
     $$PWD/MCPTool.cpp \
+    $$PWD/MCPJsonConverter.cpp \
+    $$PWD/MCPSchemaValidator.cpp \
+    $$PWD/MCPToolExecutor.cpp \
+    $$PWD/MCPToolResultCache.cpp \
     $$PWD/MCPToolInputSchema.cpp \
     $$PWD/MCPToolOutputSchema.cpp \
     $$PWD/MCPToolNotificationHandler.cpp \
@@ -9,6 +9,7 @@
 #pragma once
 #include <QObject>
 #include <QSharedPointer>
+#include <QString>
 
 class MCPMessage;
 
@@ -56,6 +57,14 @@ public:
      * @return true if running, false if not running
      */
     virtual bool isRunning() = 0;
+
+    /**
+     * @brief Set an additional Unix domain socket endpoint, takes effect on start()
+     * @param strName Socket path, a leading '@' selects the Linux abstract namespace, empty disables it
+     * @return false if the transport has no local socket support
+     */
+    virtual bool setLocalSocketName(const QString& strName) { return strName.isEmpty(); }
+
     /**
      * @brief Send message
      * @param nConnectionId Connection ID
@@ -83,4 +92,11 @@ signals:
      * @param nConnectionId Connection ID
      */
     void connectionDisconnected(quint64 nConnectionId);
+
+    /**
+     * @brief Write queue overflow signal (slow consumer, the connection is dropped)
+     * @param nConnectionId Connection ID
+     * @param nQueuedBytes Bytes waiting to be sent when the overflow happened
+     */
+    void writeQueueOverflow(quint64 nConnectionId, qint64 nQueuedBytes);
 };
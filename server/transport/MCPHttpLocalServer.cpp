@@ -0,0 +1,46 @@
+/**
+ * @file MCPHttpLocalServer.cpp
+ * @brief Unix domain socket listener implementation
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include <MCPHttpLocalServer.h>
+#include <MCPLog.h>
+
+MCPHttpLocalServer::MCPHttpLocalServer(QObject *pParent)
+    : QLocalServer(pParent)
+{}
+
+MCPHttpLocalServer::~MCPHttpLocalServer() {}
+
+bool MCPHttpLocalServer::listenOn(const QString &strName)
+{
+    QString strSocketName = strName;
+    if (strSocketName.startsWith('@')) {
+#ifdef Q_OS_LINUX
+        // Abstract namespace: no file system entry, nothing to clean up after a crash
+        strSocketName.remove(0, 1);
+        setSocketOptions(QLocalServer::AbstractNamespaceOption);
+#else
+        MCP_TRANSPORT_LOG_WARNING() << "MCPHttpLocalServer: abstract namespace requires Linux:" << strName;
+        return false;
+#endif
+    } else {
+        // A stale socket file from a previous run would make listen() fail
+        QLocalServer::removeServer(strSocketName);
+        setSocketOptions(QLocalServer::UserAccessOption);
+    }
+
+    if (!listen(strSocketName)) {
+        MCP_TRANSPORT_LOG_WARNING() << "MCPHttpLocalServer: listen:" << strName << "error:" << errorString();
+        return false;
+    }
+    return true;
+}
+
+void MCPHttpLocalServer::incomingConnection(quintptr nSocketDescriptor)
+{
+    emit incomingDescriptor(nSocketDescriptor);
+}
@@ -0,0 +1,45 @@
+/**
+ * @file MCPHttpLocalServer.h
+ * @brief Unix domain socket listener for the HTTP transport
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <QLocalServer>
+
+/**
+ * @brief Local socket listener handing out raw descriptors
+ *
+ * Same role as QTcpServer::incomingConnection() for MCPHttpTransport: the
+ * descriptor is adopted by an MCPHttpConnection inside its worker thread,
+ * no QLocalSocket is created in the listener thread.
+ *
+ * Coding standards:
+ * - Add m_ prefix to class members
+ * - Add p prefix to pointer types
+ * - { and } should be on separate lines
+ */
+class MCPHttpLocalServer : public QLocalServer
+{
+    Q_OBJECT
+
+public:
+    explicit MCPHttpLocalServer(QObject *pParent = nullptr);
+    virtual ~MCPHttpLocalServer();
+
+public:
+    /**
+     * @brief Listen on a socket path or, with a leading '@', on a Linux abstract name
+     * @param strName Socket name from the configuration
+     * @return true on success
+     */
+    bool listenOn(const QString &strName);
+
+signals:
+    void incomingDescriptor(quintptr nSocketDescriptor);
+
+protected:
+    void incomingConnection(quintptr nSocketDescriptor) override;
+};
@@ -8,6 +8,7 @@
 
 #include <MCPClientMessage.h>
 #include <MCPHttpConnection.h>
+#include <MCPHttpLocalServer.h>
 #include <MCPHttpRequestData.h>
 #include <MCPHttpTransport.h>
 #include <MCPInvokeHelper.h>
@@ -17,6 +18,7 @@
 #include <QDateTime>
 #include <QHostAddress>
 #include <QJsonDocument>
+#include <QMutexLocker>
 #include <QNetworkInterface>
 #include <QTcpServer>
 #include <QTcpSocket>
@@ -24,6 +26,7 @@
 MCPHttpTransport::MCPHttpTransport(QObject *pParent)
     : QTcpServer(pParent)
     , m_pThreadPool(new MCPThreadPool(2, this))
+    , m_pLocalServer(nullptr)
 {
     qRegisterMetaType<QSharedPointer<MCPHttpRequestData>>("QSharedPointer<HttpRequestData>");
     qRegisterMetaType<QSharedPointer<MCPMessage>>("QSharedPointer<MCPMessage>");
@@ -44,6 +47,20 @@ bool MCPHttpTransport::start(quint16 nPort)
         MCP_TRANSPORT_LOG_WARNING() << "start port:" << nPort << "error:" << errorString();
         return false;
     }
+
+    // Co-located clients: same HTTP/MCP protocol without the TCP stack
+    if (!m_strLocalSocketName.isEmpty()) {
+        if (m_pLocalServer == nullptr) {
+            m_pLocalServer = new MCPHttpLocalServer(this);
+            QObject::connect(m_pLocalServer, &MCPHttpLocalServer::incomingDescriptor, this, &MCPHttpTransport::onLocalConnection);
+        }
+        if (!m_pLocalServer->listenOn(m_strLocalSocketName)) {
+            close();
+            return false;
+        }
+        MCP_TRANSPORT_LOG_INFO() << "MCP HTTP local socket:" << m_strLocalSocketName << "OK";
+    }
+
     MCP_TRANSPORT_LOG_INFO() << "MCP HTTP start:" << nPort << "OK";
     return true;
 }
@@ -52,9 +69,17 @@ bool MCPHttpTransport::stop()
 {
     MCP_TRANSPORT_LOG_INFO() << "MCP HTTP stop";
     close();
+    if (m_pLocalServer != nullptr) {
+        m_pLocalServer->close();
+    }
     return true;
 }
 
+void MCPHttpTransport::setLocalSocketName(const QString &strName)
+{
+    m_strLocalSocketName = strName;
+}
+
 bool MCPHttpTransport::isRunning()
 {
     return isListening();
@@ -62,31 +87,45 @@ bool MCPHttpTransport::isRunning()
 
 void MCPHttpTransport::sendMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pResponse)
 {
-    if (auto pConnection = m_dictConnections.value(nConnectionId)) {
-        MCPInvokeHelper::syncInvoke(pConnection, [pConnection, pResponse]() { //
-            pConnection->sendMessage(pResponse);
-        });
+    // Non-blocking: the connection queues the data and writes it in its own thread
+    if (auto pConnection = findConnection(nConnectionId)) {
+        pConnection->enqueueMessage(pResponse);
     }
 }
 
 void MCPHttpTransport::sendCloseMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pResponse)
 {
-    if (auto pConnection = m_dictConnections.value(nConnectionId)) {
-        MCPInvokeHelper::asynInvoke(pConnection, [pConnection, pResponse]() {
-            pConnection->sendMessage(pResponse);
-            //pConnection->disconnectFromHost();
-        });
+    if (auto pConnection = findConnection(nConnectionId)) {
+        pConnection->enqueueMessage(pResponse);
+        //pConnection->disconnectFromHost();
     }
 }
 
 void MCPHttpTransport::incomingConnection(qintptr handle)
 {
     //() << "incomingConnection: handle:" << handle;
-    MCPHttpConnection *pConnection = new MCPHttpConnection(handle, nullptr);
+    addConnection(new MCPHttpConnection(handle, nullptr));
+}
+
+void MCPHttpTransport::onLocalConnection(quintptr nSocketDescriptor)
+{
+    addConnection(new MCPHttpConnection(static_cast<qintptr>(nSocketDescriptor), MCPHttpSocketType::Local, nullptr));
+}
+
+void MCPHttpTransport::addConnection(MCPHttpConnection *pConnection)
+{
     QObject::connect(pConnection, &MCPHttpConnection::messageReceived, this, &MCPHttpTransport::messageReceived);
     QObject::connect(pConnection, &MCPHttpConnection::disconnected, this, &MCPHttpTransport::onDisconnected);
-    m_dictConnections[pConnection->getConnectionId()] = pConnection;
+    QObject::connect(pConnection, &MCPHttpConnection::writeQueueOverflow, this, &MCPHttpTransport::onWriteQueueOverflow);
     m_pThreadPool->addWorker(pConnection);
+    QMutexLocker locker(&m_mutexConnections);
+    m_dictConnections[pConnection->getConnectionId()] = QSharedPointer<MCPHttpConnection>(pConnection, &QObject::deleteLater);
+}
+
+QSharedPointer<MCPHttpConnection> MCPHttpTransport::findConnection(quint64 nConnectionId)
+{
+    QMutexLocker locker(&m_mutexConnections);
+    return m_dictConnections.value(nConnectionId);
 }
 
 void MCPHttpTransport::onDisconnected()
@@ -94,11 +133,27 @@ void MCPHttpTransport::onDisconnected()
     if (auto pConnection = qobject_cast<MCPHttpConnection *>(sender())) {
         quint64 nConnectionId = pConnection->getConnectionId();
         MCP_TRANSPORT_LOG_INFO() << "onDisconnected: nConnectionId:" << nConnectionId;
-        m_dictConnections.remove(nConnectionId);
         m_pThreadPool->removeWorker(pConnection);
-        pConnection->deleteLater();
+        {
+            // Deleted once no sender holds it any more
+            QMutexLocker locker(&m_mutexConnections);
+            m_dictConnections.remove(nConnectionId);
+        }
 
         // Send connection disconnected signal
         emit connectionDisconnected(nConnectionId);
     }
 }
+
+void MCPHttpTransport::onWriteQueueOverflow(quint64 nConnectionId, qint64 nQueuedBytes)
+{
+    // Slow consumer: drop the connection instead of buffering without limit,
+    // SSE clients reconnect and the dispatcher never waits on a socket
+    if (auto pConnection = findConnection(nConnectionId)) {
+        MCP_TRANSPORT_LOG_WARNING() << "onWriteQueueOverflow: nConnectionId:" << nConnectionId << "queued:" << nQueuedBytes;
+        MCPInvokeHelper::asynInvoke(pConnection.data(), [pConnection]() { //
+            pConnection->disconnectFromHost();
+        });
+    }
+    emit writeQueueOverflow(nConnectionId, nQueuedBytes);
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include "MCPMessage.h"
 #include <QMap>
+#include <QMutex>
+#include <QSharedPointer>
 #include <QTcpServer>
 #include <QTcpSocket>
 
@@ -21,6 +23,7 @@
 class MCPMessage;
 class MCPThreadPool;
 class MCPHttpConnection;
+class MCPHttpLocalServer;
 
 class MCPHttpTransport : public QTcpServer
 {
@@ -34,22 +37,37 @@ public:
     bool start(quint16 nPort);
     bool stop();
     bool isRunning();
+    /**
+     * @brief Additional Unix domain socket endpoint, takes effect on start()
+     * @param strName Socket path, a leading '@' selects the Linux abstract namespace, empty disables it
+     */
+    void setLocalSocketName(const QString &strName);
 signals:
     void messageReceived(quint64 nConnectionId, const QSharedPointer<MCPMessage> &pMessage);
     void connectionDisconnected(quint64 nConnectionId);
+    void writeQueueOverflow(quint64 nConnectionId, qint64 nQueuedBytes);
 
 public slots:
     void sendMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pMessage);
     void sendCloseMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pMessage);
 private slots:
     void onDisconnected();
+    void onWriteQueueOverflow(quint64 nConnectionId, qint64 nQueuedBytes);
+    void onLocalConnection(quintptr nSocketDescriptor);
 
 private:
     void incomingConnection(qintptr handle);
+    void addConnection(MCPHttpConnection *pConnection);
+    QSharedPointer<MCPHttpConnection> findConnection(quint64 nConnectionId);
 
 private:
-    QMap<quint64, MCPHttpConnection *> m_dictConnections;
+    // Read by senders on other threads: a looked-up connection stays alive until the last
+    // reference is dropped, then it is deleted in its own thread (deleteLater)
+    QMutex m_mutexConnections;
+    QMap<quint64, QSharedPointer<MCPHttpConnection>> m_dictConnections;
 
 private:
     MCPThreadPool *m_pThreadPool;
+    MCPHttpLocalServer *m_pLocalServer;
+    QString m_strLocalSocketName;
 };
\ No newline at end of file
@@ -15,6 +15,7 @@ MCPHttpTransportAdapter::MCPHttpTransportAdapter(QObject *pParent)
 {
     QObject::connect(m_pHttpTransport, &MCPHttpTransport::messageReceived, this, &IMCPTransport::messageReceived);
     QObject::connect(m_pHttpTransport, &MCPHttpTransport::connectionDisconnected, this, &IMCPTransport::connectionDisconnected);
+    QObject::connect(m_pHttpTransport, &MCPHttpTransport::writeQueueOverflow, this, &IMCPTransport::writeQueueOverflow);
 }
 
 MCPHttpTransportAdapter::~MCPHttpTransportAdapter()
@@ -37,6 +38,12 @@ bool MCPHttpTransportAdapter::isRunning()
     return m_pHttpTransport->isRunning();
 }
 
+bool MCPHttpTransportAdapter::setLocalSocketName(const QString &strName)
+{
+    m_pHttpTransport->setLocalSocketName(strName);
+    return true;
+}
+
 void MCPHttpTransportAdapter::sendMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pMessage)
 {
     m_pHttpTransport->sendMessage(nConnectionId, pMessage);
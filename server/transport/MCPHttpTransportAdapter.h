@@ -42,6 +42,7 @@ public:
     virtual bool start(quint16 nPort = 8888) override;
     virtual bool stop() override;
     virtual bool isRunning() override;
+    virtual bool setLocalSocketName(const QString& strName) override;
     virtual void sendMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pMessage) override;
     virtual void sendCloseMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pMessage) override;
     
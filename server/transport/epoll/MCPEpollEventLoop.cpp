@@ -0,0 +1,465 @@
+/**
+ * @file MCPEpollEventLoop.cpp
+ * @brief MCP epoll event loop thread implementation
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include <MCPEpollEventLoop.h>
+#include <MCPHttpConnection.h>
+#include <MCPHttpMessageParser.h>
+#include <MCPHttpRequestData.h>
+#include <MCPHttpRequestParser.h>
+#include <MCPHttpResponseBuilder.h>
+#include <MCPLog.h>
+#include <MCPMessage.h>
+#include <MCPMetrics.h>
+#include <MCPTrace.h>
+#include <QMutexLocker>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// epoll_event.data.u64 tokens; connection IDs always have a sequence >= 1
+// in the upper bits and can never collide with these.
+static constexpr quint64 EPOLL_LISTEN_TOKEN = 0;
+static constexpr quint64 EPOLL_WAKEUP_TOKEN = 1;
+static constexpr int EPOLL_MAX_EVENTS = 256;
+static constexpr int EPOLL_READ_CHUNK = 64 * 1024;
+static constexpr int EPOLL_MAX_IOVEC = 64;
+
+MCPEpollEventLoop::MCPEpollEventLoop(int nIndex, QObject *pParent)
+    : QThread(pParent)
+    , m_nIndex(nIndex)
+    , m_nEpollFd(-1)
+    , m_nListenFd(-1)
+    , m_nWakeFd(-1)
+    , m_nNextSequence(1)
+    , m_bRunning(false)
+{
+    setObjectName(QString("MCPEpoll-IO-%1").arg(nIndex));
+}
+
+MCPEpollEventLoop::~MCPEpollEventLoop()
+{
+    shutdown();
+}
+
+bool MCPEpollEventLoop::open(quint16 nPort)
+{
+    m_nEpollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (m_nEpollFd < 0) {
+        MCP_TRANSPORT_LOG_WARNING() << "MCPEpollEventLoop: epoll_create1 failed:" << strerror(errno);
+        return false;
+    }
+
+    m_nWakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_nWakeFd < 0) {
+        MCP_TRANSPORT_LOG_WARNING() << "MCPEpollEventLoop: eventfd failed:" << strerror(errno);
+        return false;
+    }
+
+    m_nListenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_nListenFd < 0) {
+        MCP_TRANSPORT_LOG_WARNING() << "MCPEpollEventLoop: socket failed:" << strerror(errno);
+        return false;
+    }
+
+    int nOne = 1;
+    ::setsockopt(m_nListenFd, SOL_SOCKET, SO_REUSEADDR, &nOne, sizeof(nOne));
+    if (::setsockopt(m_nListenFd, SOL_SOCKET, SO_REUSEPORT, &nOne, sizeof(nOne)) < 0) {
+        MCP_TRANSPORT_LOG_WARNING() << "MCPEpollEventLoop: SO_REUSEPORT failed:" << strerror(errno);
+        return false;
+    }
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(nPort);
+    if (::bind(m_nListenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        MCP_TRANSPORT_LOG_WARNING() << "MCPEpollEventLoop: bind port:" << nPort << "error:" << strerror(errno);
+        return false;
+    }
+    if (::listen(m_nListenFd, SOMAXCONN) < 0) {
+        MCP_TRANSPORT_LOG_WARNING() << "MCPEpollEventLoop: listen failed:" << strerror(errno);
+        return false;
+    }
+
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.u64 = EPOLL_LISTEN_TOKEN;
+    if (::epoll_ctl(m_nEpollFd, EPOLL_CTL_ADD, m_nListenFd, &ev) < 0) {
+        MCP_TRANSPORT_LOG_WARNING() << "MCPEpollEventLoop: epoll_ctl listen failed:" << strerror(errno);
+        return false;
+    }
+
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.u64 = EPOLL_WAKEUP_TOKEN;
+    if (::epoll_ctl(m_nEpollFd, EPOLL_CTL_ADD, m_nWakeFd, &ev) < 0) {
+        MCP_TRANSPORT_LOG_WARNING() << "MCPEpollEventLoop: epoll_ctl eventfd failed:" << strerror(errno);
+        return false;
+    }
+
+    m_bRunning.storeRelease(true);
+    return true;
+}
+
+void MCPEpollEventLoop::shutdown()
+{
+    m_bRunning.storeRelease(false);
+    if (isRunning()) {
+        wakeup();
+        wait();
+    }
+
+    if (m_nListenFd >= 0) {
+        ::close(m_nListenFd);
+        m_nListenFd = -1;
+    }
+    if (m_nWakeFd >= 0) {
+        ::close(m_nWakeFd);
+        m_nWakeFd = -1;
+    }
+    if (m_nEpollFd >= 0) {
+        ::close(m_nEpollFd);
+        m_nEpollFd = -1;
+    }
+}
+
+void MCPEpollEventLoop::postWrite(quint64 nConnectionId, const QByteArrayList &lstParts, quint64 nTraceId)
+{
+    {
+        QMutexLocker locker(&m_mutexPending);
+        m_lstPendingWrites.append(PendingWrite{nConnectionId, lstParts, nTraceId});
+    }
+    wakeup();
+}
+
+void MCPEpollEventLoop::wakeup()
+{
+    if (m_nWakeFd >= 0) {
+        quint64 nValue = 1;
+        ssize_t nRet = ::write(m_nWakeFd, &nValue, sizeof(nValue));
+        Q_UNUSED(nRet);
+    }
+}
+
+void MCPEpollEventLoop::run()
+{
+    epoll_event events[EPOLL_MAX_EVENTS];
+
+    // A peer reset during writev() must not kill the process
+    sigset_t sigMask;
+    sigemptyset(&sigMask);
+    sigaddset(&sigMask, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &sigMask, nullptr);
+
+    MCP_TRANSPORT_LOG_INFO() << "MCPEpollEventLoop: started:" << objectName();
+
+    while (m_bRunning.loadAcquire()) {
+        int nCount = ::epoll_wait(m_nEpollFd, events, EPOLL_MAX_EVENTS, -1);
+        if (nCount < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            MCP_TRANSPORT_LOG_WARNING() << "MCPEpollEventLoop: epoll_wait failed:" << strerror(errno);
+            break;
+        }
+
+        for (int i = 0; i < nCount; ++i) {
+            const quint64 nToken = events[i].data.u64;
+            const quint32 nEvents = events[i].events;
+
+            if (nToken == EPOLL_LISTEN_TOKEN) {
+                acceptConnections();
+                continue;
+            }
+
+            if (nToken == EPOLL_WAKEUP_TOKEN) {
+                quint64 nValue = 0;
+                while (::read(m_nWakeFd, &nValue, sizeof(nValue)) > 0) {
+                }
+                processPendingWrites();
+                continue;
+            }
+
+            MCPEpollConnection *pConnection = m_dictConnections.value(nToken, nullptr);
+            if (pConnection == nullptr) {
+                continue;
+            }
+
+            if (nEvents & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                readConnection(pConnection);
+                // readConnection() may have closed and freed the connection
+                pConnection = m_dictConnections.value(nToken, nullptr);
+                if (pConnection == nullptr) {
+                    continue;
+                }
+            }
+
+            if (nEvents & EPOLLOUT) {
+                flushConnection(pConnection);
+            }
+        }
+    }
+
+    closeAll();
+
+    MCP_TRANSPORT_LOG_INFO() << "MCPEpollEventLoop: stopped:" << objectName();
+}
+
+void MCPEpollEventLoop::acceptConnections()
+{
+    // Edge-triggered: drain the accept queue completely
+    for (;;) {
+        int nFd = ::accept4(m_nListenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (nFd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                MCP_TRANSPORT_LOG_WARNING() << "MCPEpollEventLoop: accept4 failed:" << strerror(errno);
+            }
+            return;
+        }
+
+        int nOne = 1;
+        ::setsockopt(nFd, IPPROTO_TCP, TCP_NODELAY, &nOne, sizeof(nOne));
+
+        auto pConnection = new MCPEpollConnection();
+        pConnection->nFd = nFd;
+        pConnection->nConnectionId = (m_nNextSequence++ << LOOP_INDEX_BITS) | static_cast<quint64>(m_nIndex);
+        pConnection->pParser = new MCPHttpRequestParser();
+        pConnection->nWriteOffset = 0;
+        pConnection->nQueuedBytes = 0;
+        pConnection->bWantWrite = false;
+        pConnection->bCloseAfterFlush = false;
+
+        // Parser runs synchronously inside readConnection(), no queued dispatch needed
+        const quint64 nConnectionId = pConnection->nConnectionId;
+        QObject::connect(pConnection->pParser,
+                         &MCPHttpRequestParser::httpRequestReceived,
+                         [this, nConnectionId](QByteArray /*data*/, QSharedPointer<MCPHttpRequestData> pRequestData) {
+                             const quint64 nTraceId = MCPTrace::newTraceId();
+                             MCPTraceSpan span("http.parse", nTraceId);
+                             if (auto pMessage = MCPHttpMessageParser::genClientMessageFromHttp(pRequestData)) {
+                                 pMessage->setTraceId(nTraceId);
+                                 emit messageReceived(nConnectionId, pMessage);
+                             }
+                         });
+        QObject::connect(pConnection->pParser,
+                         &MCPHttpRequestParser::httpRequestRejected,
+                         [pConnection](int nHttpStatus, QByteArray reason) {
+                             // Answered and closed once the buffer is flushed (see readConnection())
+                             QByteArray response = MCPHttpResponseBuilder::buildErrorResponse(nHttpStatus, reason);
+                             pConnection->nQueuedBytes += response.size();
+                             MCPMetrics::instance()->addOutboundQueued(response.size());
+                             pConnection->lstWriteQueue.append(response);
+                             pConnection->bCloseAfterFlush = true;
+                         });
+
+        epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        ev.data.u64 = nConnectionId;
+        if (::epoll_ctl(m_nEpollFd, EPOLL_CTL_ADD, nFd, &ev) < 0) {
+            MCP_TRANSPORT_LOG_WARNING() << "MCPEpollEventLoop: epoll_ctl add failed:" << strerror(errno);
+            delete pConnection->pParser;
+            delete pConnection;
+            ::close(nFd);
+            continue;
+        }
+
+        m_dictConnections.insert(nConnectionId, pConnection);
+        MCPMetrics::instance()->addConnections(1);
+    }
+}
+
+void MCPEpollEventLoop::readConnection(MCPEpollConnection *pConnection)
+{
+    char buffer[EPOLL_READ_CHUNK];
+
+    // Edge-triggered: read until EAGAIN or the peer closes
+    for (;;) {
+        ssize_t nRead = ::recv(pConnection->nFd, buffer, sizeof(buffer), 0);
+        if (nRead > 0) {
+            MCPMetrics::instance()->addBytesIn(nRead);
+            // Requests completed by this chunk are parsed inside appendData(), their "http.parse" spans nest in this one
+            MCPTraceSpan span("http.read", 0);
+            if (!pConnection->pParser->appendData(QByteArray(buffer, static_cast<qsizetype>(nRead)))) {
+                MCP_TRANSPORT_LOG_INFO() << "MCPEpollEventLoop: parser failed:" << pConnection->nConnectionId;
+            }
+            if (pConnection->bCloseAfterFlush) {
+                // Request rejected by the parser, stop reading and send the error
+                if (!pConnection->bWantWrite) {
+                    flushConnection(pConnection);
+                }
+                return;
+            }
+            continue;
+        }
+        if (nRead == 0) {
+            closeConnection(pConnection);
+            return;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return;
+        }
+        MCP_TRANSPORT_LOG_INFO() << "MCPEpollEventLoop: recv error:" << strerror(errno);
+        closeConnection(pConnection);
+        return;
+    }
+}
+
+bool MCPEpollEventLoop::flushConnection(MCPEpollConnection *pConnection)
+{
+    iovec arrIov[EPOLL_MAX_IOVEC];
+
+    while (!pConnection->lstWriteQueue.isEmpty()) {
+        // Gather header templates and bodies without copying them into one buffer
+        int nIovCount = 0;
+        for (qsizetype i = 0; i < pConnection->lstWriteQueue.size() && nIovCount < EPOLL_MAX_IOVEC; ++i) {
+            const QByteArray &part = pConnection->lstWriteQueue.at(i);
+            const qsizetype nSkip = (i == 0) ? pConnection->nWriteOffset : 0;
+            arrIov[nIovCount].iov_base = const_cast<char *>(part.constData() + nSkip);
+            arrIov[nIovCount].iov_len = static_cast<size_t>(part.size() - nSkip);
+            ++nIovCount;
+        }
+
+        // writev() has no MSG_NOSIGNAL, SIGPIPE is blocked in run()
+        ssize_t nWritten = ::writev(pConnection->nFd, arrIov, nIovCount);
+        if (nWritten > 0) {
+            pConnection->nQueuedBytes -= nWritten;
+            MCPMetrics::instance()->addBytesOut(nWritten);
+            MCPMetrics::instance()->addOutboundQueued(-nWritten);
+            qsizetype nRemain = static_cast<qsizetype>(nWritten);
+            while (nRemain > 0) {
+                const qsizetype nFirst = pConnection->lstWriteQueue.first().size() - pConnection->nWriteOffset;
+                if (nRemain < nFirst) {
+                    pConnection->nWriteOffset += nRemain;
+                    break;
+                }
+                nRemain -= nFirst;
+                pConnection->lstWriteQueue.removeFirst();
+                pConnection->nWriteOffset = 0;
+            }
+            continue;
+        }
+        if (nWritten < 0 && errno == EINTR) {
+            continue;
+        }
+        if (nWritten < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Kernel buffer full, wait for EPOLLOUT
+            updateInterest(pConnection, true);
+            return true;
+        }
+        MCP_TRANSPORT_LOG_INFO() << "MCPEpollEventLoop: writev error:" << strerror(errno);
+        closeConnection(pConnection);
+        return false;
+    }
+
+    pConnection->nWriteOffset = 0;
+    MCPMetrics::instance()->addOutboundQueued(-pConnection->nQueuedBytes);
+    pConnection->nQueuedBytes = 0;
+    if (pConnection->bCloseAfterFlush) {
+        closeConnection(pConnection);
+        return false;
+    }
+    updateInterest(pConnection, false);
+    return true;
+}
+
+void MCPEpollEventLoop::processPendingWrites()
+{
+    QList<PendingWrite> lstWrites;
+    {
+        QMutexLocker locker(&m_mutexPending);
+        lstWrites.swap(m_lstPendingWrites);
+    }
+
+    for (const auto &pending : lstWrites) {
+        MCPEpollConnection *pConnection = m_dictConnections.value(pending.nConnectionId, nullptr);
+        if (pConnection == nullptr) {
+            continue;
+        }
+        // Same high watermark as MCPHttpConnection, slow consumers are dropped
+        qint64 nMessageBytes = 0;
+        for (const auto &part : pending.lstParts) {
+            nMessageBytes += part.size();
+        }
+        const qint64 nQueuedBytes = pConnection->nQueuedBytes;
+        if (nQueuedBytes > 0 && nQueuedBytes + nMessageBytes > MCPHttpConnection::WRITE_QUEUE_HIGH_WATERMARK) {
+            MCP_TRANSPORT_LOG_WARNING() << "MCPEpollEventLoop: write queue overflow:" << pConnection->nConnectionId << "queued:" << nQueuedBytes;
+            emit writeQueueOverflow(pConnection->nConnectionId, nQueuedBytes);
+            closeConnection(pConnection);
+            continue;
+        }
+        for (const auto &part : pending.lstParts) {
+            if (!part.isEmpty()) {
+                pConnection->lstWriteQueue.append(part);
+            }
+        }
+        pConnection->nQueuedBytes += nMessageBytes;
+        MCPMetrics::instance()->addOutboundQueued(nMessageBytes);
+        if (!pConnection->bWantWrite) {
+            // Bytes left over for EPOLLOUT are not part of the span
+            MCPTraceSpan span("socket.write", pending.nTraceId);
+            flushConnection(pConnection);
+        }
+    }
+}
+
+void MCPEpollEventLoop::updateInterest(MCPEpollConnection *pConnection, bool bWantWrite)
+{
+    if (pConnection->bWantWrite == bWantWrite) {
+        return;
+    }
+
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET | (bWantWrite ? EPOLLOUT : 0);
+    ev.data.u64 = pConnection->nConnectionId;
+    ::epoll_ctl(m_nEpollFd, EPOLL_CTL_MOD, pConnection->nFd, &ev);
+    pConnection->bWantWrite = bWantWrite;
+}
+
+void MCPEpollEventLoop::closeConnection(MCPEpollConnection *pConnection)
+{
+    const quint64 nConnectionId = pConnection->nConnectionId;
+
+    ::epoll_ctl(m_nEpollFd, EPOLL_CTL_DEL, pConnection->nFd, nullptr);
+    ::close(pConnection->nFd);
+    m_dictConnections.remove(nConnectionId);
+    auto pMetrics = MCPMetrics::instance();
+    pMetrics->addConnections(-1);
+    pMetrics->addOutboundQueued(-pConnection->nQueuedBytes);
+    delete pConnection->pParser;
+    delete pConnection;
+
+    MCP_TRANSPORT_LOG_INFO() << "MCPEpollEventLoop: onDisconnected: nConnectionId:" << nConnectionId;
+    emit connectionDisconnected(nConnectionId);
+}
+
+void MCPEpollEventLoop::closeAll()
+{
+    const auto lstConnections = m_dictConnections.values();
+    for (auto pConnection : lstConnections) {
+        closeConnection(pConnection);
+    }
+}
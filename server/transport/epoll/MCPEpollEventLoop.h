@@ -0,0 +1,127 @@
+/**
+ * @file MCPEpollEventLoop.h
+ * @brief MCP epoll event loop thread (Linux only)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QByteArrayList>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QThread>
+
+class MCPMessage;
+class MCPHttpRequestParser;
+
+/**
+ * @brief Connection state owned by one MCPEpollEventLoop
+ *
+ * Only touched from the owning event loop thread.
+ */
+struct MCPEpollConnection
+{
+    int nFd;
+    quint64 nConnectionId;
+    MCPHttpRequestParser *pParser;
+    QByteArrayList lstWriteQueue;  // 待发送的分段（模板头 + 消息体），writev 一次提交
+    qsizetype nWriteOffset;        // lstWriteQueue.first() 已发送的字节数
+    qint64 nQueuedBytes;           // 队列中尚未发送的总字节数
+    bool bWantWrite;
+    bool bCloseAfterFlush;
+};
+
+/**
+ * @brief Edge-triggered epoll event loop
+ *
+ * Responsibilities:
+ * - Own one epoll instance, one SO_REUSEPORT listener and one eventfd
+ * - Accept, read and write sockets without QObject per connection
+ * - Feed incoming bytes into the existing llhttp based MCPHttpRequestParser
+ * - Accept outgoing data from any thread through postWrite()
+ *
+ * Connection IDs carry the loop index in the lower 8 bits, so the
+ * transport can route a reply to its loop without any lookup or lock.
+ *
+ * Coding standards:
+ * - Add m_ prefix to class members
+ * - Add p prefix to pointer types
+ * - { and } should be on separate lines
+ */
+class MCPEpollEventLoop : public QThread
+{
+    Q_OBJECT
+
+public:
+    static constexpr int LOOP_INDEX_BITS = 8;
+    static constexpr quint64 LOOP_INDEX_MASK = (1u << LOOP_INDEX_BITS) - 1;
+
+public:
+    explicit MCPEpollEventLoop(int nIndex, QObject *pParent = nullptr);
+    virtual ~MCPEpollEventLoop();
+
+public:
+    /**
+     * @brief Create epoll instance, wakeup eventfd and listening socket
+     * @param nPort Listening port (shared by all loops via SO_REUSEPORT)
+     * @return true on success
+     */
+    bool open(quint16 nPort);
+
+    /**
+     * @brief Ask the loop to exit and wait for the thread
+     */
+    void shutdown();
+
+    /**
+     * @brief Queue data for a connection owned by this loop (thread-safe)
+     * @param nConnectionId Connection ID
+     * @param lstParts Serialized HTTP data parts, sent with writev() without joining
+     * @param nTraceId MCPTrace ID of the request the data answers (0 = none)
+     */
+    void postWrite(quint64 nConnectionId, const QByteArrayList &lstParts, quint64 nTraceId = 0);
+
+signals:
+    void messageReceived(quint64 nConnectionId, const QSharedPointer<MCPMessage> &pMessage);
+    void connectionDisconnected(quint64 nConnectionId);
+    void writeQueueOverflow(quint64 nConnectionId, qint64 nQueuedBytes);
+
+protected:
+    void run() override;
+
+private:
+    void wakeup();
+    void acceptConnections();
+    void readConnection(MCPEpollConnection *pConnection);
+    bool flushConnection(MCPEpollConnection *pConnection);
+    void processPendingWrites();
+    void updateInterest(MCPEpollConnection *pConnection, bool bWantWrite);
+    void closeConnection(MCPEpollConnection *pConnection);
+    void closeAll();
+
+private:
+    struct PendingWrite
+    {
+        quint64 nConnectionId;
+        QByteArrayList lstParts;
+        quint64 nTraceId;
+    };
+
+private:
+    int m_nIndex;
+    int m_nEpollFd;
+    int m_nListenFd;
+    int m_nWakeFd;
+    quint64 m_nNextSequence;
+    QAtomicInteger<bool> m_bRunning;
+    QHash<quint64, MCPEpollConnection *> m_dictConnections;
+
+private:
+    QMutex m_mutexPending;
+    QList<PendingWrite> m_lstPendingWrites;
+};
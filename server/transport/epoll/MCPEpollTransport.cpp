@@ -0,0 +1,109 @@
+/**
+ * @file MCPEpollTransport.cpp
+ * @brief MCP epoll based HTTP transport implementation
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include <MCPClientMessage.h>
+#include <MCPEpollEventLoop.h>
+#include <MCPEpollTransport.h>
+#include <MCPLog.h>
+#include <MCPMessage.h>
+#include <MCPServerMessage.h>
+#include <MCPTrace.h>
+#include <QThread>
+
+MCPEpollTransport::MCPEpollTransport(int nThreadCount, QObject *pParent)
+    : IMCPTransport(pParent)
+    , m_nThreadCount(nThreadCount > 0 ? nThreadCount : QThread::idealThreadCount())
+{
+    // Loop index is encoded in the lower bits of the connection ID
+    m_nThreadCount = qBound(1, m_nThreadCount, static_cast<int>(MCPEpollEventLoop::LOOP_INDEX_MASK) + 1);
+
+    qRegisterMetaType<QSharedPointer<MCPMessage>>("QSharedPointer<MCPMessage>");
+    qRegisterMetaType<QSharedPointer<MCPClientMessage>>("QSharedPointer<MCPClientMessage>");
+    qRegisterMetaType<QSharedPointer<MCPServerMessage>>("QSharedPointer<MCPResponse>");
+}
+
+MCPEpollTransport::~MCPEpollTransport()
+{
+    stop();
+}
+
+bool MCPEpollTransport::start(quint16 nPort)
+{
+    if (!m_lstLoops.isEmpty()) {
+        return true; // Already started
+    }
+
+    for (int i = 0; i < m_nThreadCount; ++i) {
+        auto pLoop = new MCPEpollEventLoop(i, this);
+        // Direct connection: re-emit from the I/O thread, receivers in other threads get queued delivery
+        QObject::connect(pLoop, &MCPEpollEventLoop::messageReceived, this, &IMCPTransport::messageReceived, Qt::DirectConnection);
+        QObject::connect(pLoop, &MCPEpollEventLoop::connectionDisconnected, this, &IMCPTransport::connectionDisconnected, Qt::DirectConnection);
+        QObject::connect(pLoop, &MCPEpollEventLoop::writeQueueOverflow, this, &IMCPTransport::writeQueueOverflow, Qt::DirectConnection);
+        m_lstLoops.append(pLoop);
+
+        if (!pLoop->open(nPort)) {
+            MCP_TRANSPORT_LOG_WARNING() << "MCP EPOLL start port:" << nPort << "error";
+            stop();
+            return false;
+        }
+    }
+
+    for (auto pLoop : m_lstLoops) {
+        pLoop->start();
+    }
+
+    MCP_TRANSPORT_LOG_INFO() << "MCP EPOLL start:" << nPort << "threads:" << m_nThreadCount << "OK";
+    return true;
+}
+
+bool MCPEpollTransport::stop()
+{
+    if (m_lstLoops.isEmpty()) {
+        return true;
+    }
+
+    MCP_TRANSPORT_LOG_INFO() << "MCP EPOLL stop";
+    for (auto pLoop : m_lstLoops) {
+        pLoop->shutdown();
+    }
+    qDeleteAll(m_lstLoops);
+    m_lstLoops.clear();
+    return true;
+}
+
+bool MCPEpollTransport::isRunning()
+{
+    return !m_lstLoops.isEmpty();
+}
+
+void MCPEpollTransport::sendMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pMessage)
+{
+    if (auto pLoop = findLoop(nConnectionId)) {
+        // Serialized in the caller thread, like MCPHttpConnection::enqueueMessage()
+        QByteArrayList lstParts;
+        {
+            MCPTraceSpan span("http.serialize", pMessage->getTraceId());
+            lstParts = pMessage->toDataParts();
+        }
+        pLoop->postWrite(nConnectionId, lstParts, pMessage->getTraceId());
+    }
+}
+
+void MCPEpollTransport::sendCloseMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pMessage)
+{
+    // Same as MCPHttpTransport: the connection is kept open for keep-alive clients
+    if (auto pLoop = findLoop(nConnectionId)) {
+        pLoop->postWrite(nConnectionId, pMessage->toDataParts(), pMessage->getTraceId());
+    }
+}
+
+MCPEpollEventLoop *MCPEpollTransport::findLoop(quint64 nConnectionId) const
+{
+    const int nIndex = static_cast<int>(nConnectionId & MCPEpollEventLoop::LOOP_INDEX_MASK);
+    return m_lstLoops.value(nIndex, nullptr);
+}
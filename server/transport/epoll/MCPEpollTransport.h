@@ -0,0 +1,61 @@
+/**
+ * @file MCPEpollTransport.h
+ * @brief MCP epoll based HTTP transport (Linux only)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include "IMCPTransport.h"
+#include <QList>
+
+class MCPEpollEventLoop;
+
+/**
+ * @brief MCP epoll based HTTP transport
+ *
+ * Responsibilities:
+ * - Implement IMCPTransport without QTcpServer / QTcpSocket
+ * - Run N MCPEpollEventLoop threads, each with its own epoll instance
+ *   and SO_REUSEPORT listener, the kernel balances accepts between them
+ * - Keep the llhttp parsing and the messageReceived() contract of MCPHttpTransport
+ *
+ * Design notes:
+ * - Replies are serialized in the calling thread and handed to the owning
+ *   loop through an eventfd wakeup, the caller never blocks on socket I/O
+ * - Selected with "transport": "epoll" in the server configuration
+ *
+ * Coding standards:
+ * - Add m_ prefix to class members
+ * - Add p prefix to pointer types
+ * - { and } should be on separate lines
+ */
+class MCPEpollTransport : public IMCPTransport
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor
+     * @param nThreadCount Number of event loop threads (<= 0 uses QThread::idealThreadCount())
+     * @param pParent Parent object
+     */
+    explicit MCPEpollTransport(int nThreadCount = 0, QObject *pParent = nullptr);
+    virtual ~MCPEpollTransport();
+
+public:
+    // 实现IMCPTransport接口
+    virtual bool start(quint16 nPort = 8888) override;
+    virtual bool stop() override;
+    virtual bool isRunning() override;
+    virtual void sendMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pMessage) override;
+    virtual void sendCloseMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pMessage) override;
+
+private:
+    MCPEpollEventLoop *findLoop(quint64 nConnectionId) const;
+
+private:
+    int m_nThreadCount;
+    QList<MCPEpollEventLoop *> m_lstLoops;
+};
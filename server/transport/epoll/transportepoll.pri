@@ -0,0 +1,10 @@
+INCLUDEPATH  += $$PWD
+QMAKE_INCDIR += $$PWD
+
+SOURCES += \
+    $$PWD/MCPEpollEventLoop.cpp \
+    $$PWD/MCPEpollTransport.cpp
+
+HEADERS += \
+    $$PWD/MCPEpollEventLoop.h \
+    $$PWD/MCPEpollTransport.h
@@ -10,60 +10,192 @@
 #include <MCPHttpMessageParser.h>
 #include <MCPHttpRequestData.h>
 #include <MCPHttpRequestParser.h>
+#include <MCPHttpResponseBuilder.h>
 #include <MCPInvokeHelper.h>
 #include <MCPLog.h>
 #include <MCPMessage.h>
+#include <MCPMetrics.h>
+#include <MCPTrace.h>
 #include <QHostAddress>
+#include <QLocalSocket>
+#include <QMutexLocker>
 #include <QTcpSocket>
 #include <QThread>
 static quint64 SERVER_CONNECTION_ID = 1000;
 MCPHttpConnection::MCPHttpConnection(qintptr nSocketDescriptor, QObject *parent)
+    : MCPHttpConnection(nSocketDescriptor, MCPHttpSocketType::Tcp, parent)
+{}
+
+MCPHttpConnection::MCPHttpConnection(qintptr nSocketDescriptor, MCPHttpSocketType enSocketType, QObject *parent)
     : QObject(parent)
     , m_nId(SERVER_CONNECTION_ID++)
+    , m_pSocket(nullptr)
+    , m_pTcpSocket(nullptr)
+    , m_pLocalSocket(nullptr)
     , m_pHttpRequestParser(new MCPHttpRequestParser(this))
+    , m_nQueuedBytes(0)
+    , m_bFlushScheduled(false)
 {
-    m_pSocket = new QTcpSocket(this);
-    m_pSocket->setSocketDescriptor(nSocketDescriptor);
-    QObject::connect(m_pSocket, &QTcpSocket::readyRead, this, &MCPHttpConnection::onReadyRead);
-    QObject::connect(m_pSocket, &QTcpSocket::disconnected, this, &MCPHttpConnection::onDisconnected);
-    QObject::connect(m_pSocket, static_cast<void (QAbstractSocket::*)(QAbstractSocket::SocketError)>(&QAbstractSocket::errorOccurred), this, &MCPHttpConnection::onError);
+    MCPMetrics::instance()->addConnections(1);
+    if (enSocketType == MCPHttpSocketType::Local) {
+        m_pLocalSocket = new QLocalSocket(this);
+        m_pLocalSocket->setSocketDescriptor(static_cast<quintptr>(nSocketDescriptor));
+        m_pSocket = m_pLocalSocket;
+        m_strPeer = QString("local:%1").arg(m_nId);
+        QObject::connect(m_pLocalSocket, &QLocalSocket::disconnected, this, &MCPHttpConnection::onDisconnected);
+        QObject::connect(m_pLocalSocket, &QLocalSocket::errorOccurred, this, [this](QLocalSocket::LocalSocketError error) {
+            if (m_pLocalSocket->isOpen()) {
+                MCP_TRANSPORT_LOG_INFO() << "onError:" << error;
+                m_pLocalSocket->disconnectFromServer();
+            }
+        });
+    } else {
+        m_pTcpSocket = new QTcpSocket(this);
+        m_pTcpSocket->setSocketDescriptor(nSocketDescriptor);
+        m_pSocket = m_pTcpSocket;
+        m_strPeer = QString("%1:%2").arg(m_pTcpSocket->peerAddress().toString()).arg(m_pTcpSocket->peerPort());
+        QObject::connect(m_pTcpSocket, &QTcpSocket::disconnected, this, &MCPHttpConnection::onDisconnected);
+        QObject::connect(m_pTcpSocket, static_cast<void (QAbstractSocket::*)(QAbstractSocket::SocketError)>(&QAbstractSocket::errorOccurred), this, &MCPHttpConnection::onError);
+    }
+    QObject::connect(m_pSocket, &QIODevice::readyRead, this, &MCPHttpConnection::onReadyRead);
+    QObject::connect(m_pSocket, &QIODevice::bytesWritten, this, &MCPHttpConnection::onBytesWritten);
     QObject::connect(m_pHttpRequestParser, &MCPHttpRequestParser::httpRequestReceived, this, &MCPHttpConnection::onHttpRequestReceived);
+    QObject::connect(m_pHttpRequestParser, &MCPHttpRequestParser::httpRequestRejected, this, &MCPHttpConnection::onHttpRequestRejected);
 
     //MCP_TRANSPORT_LOG_INFO() << "Socket Remote:" << nSocketDescriptor << ", addr:" << m_pSocket->peerAddress().toString() << ", port:" << m_pSocket->peerPort();
 }
 
-MCPHttpConnection::~MCPHttpConnection() {}
+MCPHttpConnection::~MCPHttpConnection()
+{
+    auto pMetrics = MCPMetrics::instance();
+    pMetrics->addConnections(-1);
+    pMetrics->addOutboundQueued(-m_nQueuedBytes);
+}
 
 quint64 MCPHttpConnection::getConnectionId()
 {
     return m_nId;
 }
 
+bool MCPHttpConnection::enqueueMessage(const QSharedPointer<MCPMessage> &pMessage)
+{
+    // Serialize in the caller thread, the connection thread only writes bytes
+    // Header templates and body stay separate, the body is never copied into a joined buffer
+    const quint64 nTraceId = pMessage->getTraceId();
+    QByteArrayList lstParts;
+    {
+        MCPTraceSpan span("http.serialize", nTraceId);
+        lstParts = pMessage->toDataParts();
+    }
+    qint64 nSize = 0;
+    for (const auto &part : lstParts) {
+        nSize += part.size();
+    }
+    bool bScheduleFlush = false;
+    bool bRejected = false;
+    qint64 nQueuedBytes = 0;
+
+    {
+        QMutexLocker locker(&m_mutexWriteQueue);
+        // A single oversized reply is still accepted on an idle connection
+        if (m_nQueuedBytes > 0 && m_nQueuedBytes + nSize > WRITE_QUEUE_HIGH_WATERMARK) {
+            bRejected = true;
+            nQueuedBytes = m_nQueuedBytes;
+        } else {
+            m_lstWriteQueue.append(QueuedMessage{lstParts, nTraceId});
+            m_nQueuedBytes += nSize;
+            MCPMetrics::instance()->addOutboundQueued(nSize);
+            bScheduleFlush = !m_bFlushScheduled;
+            m_bFlushScheduled = true;
+        }
+    }
+
+    if (bRejected) {
+        MCP_TRANSPORT_LOG_WARNING() << "HTTP-RESP: write queue overflow:" << m_nId << "queued:" << nQueuedBytes << "dropped:" << nSize;
+        emit writeQueueOverflow(m_nId, nQueuedBytes);
+        return false;
+    }
+
+    if (bScheduleFlush) {
+        QMetaObject::invokeMethod(this, &MCPHttpConnection::flushWriteQueue, Qt::QueuedConnection);
+    }
+    return true;
+}
+
 void MCPHttpConnection::sendMessage(QSharedPointer<MCPMessage> pMessage)
 {
-    auto data = pMessage->toData();
+    enqueueMessage(pMessage);
+}
+
+void MCPHttpConnection::flushWriteQueue()
+{
+    QList<QueuedMessage> lstMessages;
+    {
+        QMutexLocker locker(&m_mutexWriteQueue);
+        lstMessages.swap(m_lstWriteQueue);
+        m_bFlushScheduled = false;
+    }
 
+    for (const auto &message : lstMessages) {
+        // Time to hand the bytes to the socket's buffer, the kernel write follows in the event loop
+        MCPTraceSpan span("socket.write", message.nTraceId);
+        const auto &lstParts = message.lstParts;
 #if 1
-    MCP_TRANSPORT_LOG_INFO() << "HTTP-RESP:" << m_pSocket->peerAddress().toString() << ":" << m_pSocket->peerPort() << "size:" << data.size();
-    if (data.indexOf("\n{") > -1) {
-        QByteArray payload = data.mid(data.indexOf("{"));
-        QJsonDocument doc = QJsonDocument::fromJson(payload);
-        MCP_TRANSPORT_LOG_DEBUG().noquote() << "HTTP-RESP:" << doc.toJson();
-    }
+        qsizetype nSize = 0;
+        for (const auto &part : lstParts) {
+            nSize += part.size();
+        }
+        MCP_TRANSPORT_LOG_INFO() << "HTTP-RESP:" << m_strPeer << "size:" << nSize;
+        if (mcpTransport().isDebugEnabled()) {
+            QByteArray data = lstParts.join();
+            if (data.indexOf("\n{") > -1) {
+                QByteArray payload = data.mid(data.indexOf("{"));
+                QJsonDocument doc = QJsonDocument::fromJson(payload);
+                MCP_TRANSPORT_LOG_DEBUG().noquote() << "HTTP-RESP:" << doc.toJson();
+            }
+        }
 #endif
-    m_pSocket->write(data);
+        // QTcpSocket / QLocalSocket have no writev, each part goes straight into its write buffer
+        for (const auto &part : lstParts) {
+            m_pSocket->write(part);
+        }
+    }
+}
+
+void MCPHttpConnection::onBytesWritten(qint64 nBytes)
+{
+    auto pMetrics = MCPMetrics::instance();
+    pMetrics->addBytesOut(nBytes);
+
+    QMutexLocker locker(&m_mutexWriteQueue);
+    // Bytes written around the queue (parser rejections) are not part of the queued count
+    const qint64 nQueuedBytes = qMax<qint64>(0, m_nQueuedBytes - nBytes);
+    pMetrics->addOutboundQueued(nQueuedBytes - m_nQueuedBytes);
+    m_nQueuedBytes = nQueuedBytes;
 }
 
 void MCPHttpConnection::disconnectFromHost()
 {
-    MCP_TRANSPORT_LOG_INFO() << "disconnectFromHost:" << m_pSocket->peerAddress().toString() << ":" << m_pSocket->peerPort();
-    m_pSocket->disconnectFromHost();
+    MCP_TRANSPORT_LOG_INFO() << "disconnectFromHost:" << m_strPeer;
+    closeSocket();
+}
+
+void MCPHttpConnection::closeSocket()
+{
+    if (m_pTcpSocket != nullptr) {
+        m_pTcpSocket->disconnectFromHost();
+    } else if (m_pLocalSocket != nullptr) {
+        m_pLocalSocket->disconnectFromServer();
+    }
 }
 
 void MCPHttpConnection::onReadyRead()
 {
     bool rc;
+    // Requests completed by this chunk are parsed inside appendData(), their "http.parse" spans nest in this one
+    MCPTraceSpan span("http.read", 0);
     QByteArray data = m_pSocket->readAll();
+    MCPMetrics::instance()->addBytesIn(data.size());
     if (!(rc = m_pHttpRequestParser->appendData(data))) {
         MCP_TRANSPORT_LOG_INFO() << "onReadyRead: m_pHttpRequestParser failed:" << rc;
     }
@@ -71,21 +203,32 @@ void MCPHttpConnection::onReadyRead()
 
 void MCPHttpConnection::onError(QAbstractSocket::SocketError error)
 {
-    if (m_pSocket->isOpen()) {
+    if (m_pTcpSocket->isOpen()) {
         MCP_TRANSPORT_LOG_INFO() << "onError:" << error;
-        m_pSocket->disconnectFromHost();
+        m_pTcpSocket->disconnectFromHost();
     }
 }
 
 void MCPHttpConnection::onHttpRequestReceived(QByteArray /*data*/, QSharedPointer<MCPHttpRequestData> pRequestData)
 {
+    const quint64 nTraceId = MCPTrace::newTraceId();
+    MCPTraceSpan span("http.parse", nTraceId);
     if (auto pMessage = MCPHttpMessageParser::genClientMessageFromHttp(pRequestData)) {
+        pMessage->setTraceId(nTraceId);
         emit messageReceived(m_nId, pMessage);
     }
 }
 
+void MCPHttpConnection::onHttpRequestRejected(int nHttpStatus, QByteArray reason)
+{
+    // Request exceeded parser limits: answer and drop the connection
+    MCP_TRANSPORT_LOG_WARNING() << "onHttpRequestRejected:" << m_nId << nHttpStatus << reason;
+    m_pSocket->write(MCPHttpResponseBuilder::buildErrorResponse(nHttpStatus, reason));
+    closeSocket();
+}
+
 void MCPHttpConnection::onDisconnected()
 {
-    MCP_TRANSPORT_LOG_INFO() << "onDisconnected:" << m_pSocket->peerAddress().toString() << ":" << m_pSocket->peerPort();
+    MCP_TRANSPORT_LOG_INFO() << "onDisconnected:" << m_strPeer;
     emit disconnected();
 }
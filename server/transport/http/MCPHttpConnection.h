@@ -4,17 +4,43 @@
 #include <MCPServerMessage.h>
 #include <QAbstractSocket>
 #include <QByteArray>
+#include <QList>
+#include <QMutex>
 #include <QObject>
 #include <QSharedPointer>
+#include <QString>
 
+class QIODevice;
+class QLocalSocket;
 class QTcpSocket;
 class MCPHttpRequestParser;
 
+/**
+ * @brief Socket kind behind an MCPHttpConnection
+ */
+enum class MCPHttpSocketType
+{
+    Tcp,   // QTcpSocket, network clients
+    Local, // QLocalSocket, Unix domain socket for co-located clients
+};
+
+/**
+ * @brief HTTP connection running in an MCPThreadPool thread
+ *
+ * Outgoing data goes through a bounded write queue: enqueueMessage() may be
+ * called from any thread, never blocks and rejects data once the unsent
+ * bytes pass the high watermark. The transport then drops the connection.
+ */
 class MCPHttpConnection : public QObject
 {
     Q_OBJECT
+public:
+    // Write queue watermark (bytes not yet handed to the OS)
+    static constexpr qint64 WRITE_QUEUE_HIGH_WATERMARK = 8 * 1024 * 1024;
+
 public:
     explicit MCPHttpConnection(qintptr nSocketDescriptor, QObject *parent = nullptr);
+    MCPHttpConnection(qintptr nSocketDescriptor, MCPHttpSocketType enSocketType, QObject *parent = nullptr);
     ~MCPHttpConnection();
 
 signals:
@@ -23,10 +49,20 @@ signals:
 
     void disconnected();
 
+    // Unsent bytes passed the high watermark, the rejected message was dropped
+    void writeQueueOverflow(quint64 nConnectionId, qint64 nQueuedBytes);
+
 public:
     //
     quint64 getConnectionId();
     //
+    /**
+     * @brief Serialize and queue a message for sending (thread-safe, non-blocking)
+     * @param pMessage Message object
+     * @return false if the write queue is above its high watermark and the message was dropped
+     */
+    bool enqueueMessage(const QSharedPointer<MCPMessage> &pMessage);
+    //
 public slots:
     // Send data
     void sendMessage(QSharedPointer<MCPMessage> pResponse);
@@ -37,13 +73,38 @@ private slots:
     // Handle error
     void onError(QAbstractSocket::SocketError error);
     void onDisconnected();
+    // Handle bytes handed to the OS
+    void onBytesWritten(qint64 nBytes);
+    // Move queued data into the socket (connection thread)
+    void flushWriteQueue();
 private slots:
     void onHttpRequestReceived(QByteArray data, QSharedPointer<MCPHttpRequestData> pRequestData);
+    void onHttpRequestRejected(int nHttpStatus, QByteArray reason);
+
+private:
+    // disconnectFromHost() / disconnectFromServer() depending on the socket kind
+    void closeSocket();
 
 private:
     quint64 m_nId;
-    QTcpSocket *m_pSocket;
+    QIODevice *m_pSocket;         // Common byte stream of m_pTcpSocket / m_pLocalSocket
+    QTcpSocket *m_pTcpSocket;     // null for local connections
+    QLocalSocket *m_pLocalSocket; // null for TCP connections
+    QString m_strPeer;            // Peer description for logging, resolved once
 
 private:
     MCPHttpRequestParser *m_pHttpRequestParser;
+
+private:
+    struct QueuedMessage
+    {
+        QByteArrayList lstParts;
+        quint64 nTraceId; // MCPTrace ID of the request the message answers
+    };
+
+private:
+    QMutex m_mutexWriteQueue;
+    QList<QueuedMessage> m_lstWriteQueue;
+    qint64 m_nQueuedBytes;
+    bool m_bFlushScheduled;
 };
\ No newline at end of file
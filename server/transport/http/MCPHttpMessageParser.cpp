@@ -65,50 +65,51 @@ QSharedPointer<MCPClientMessage> MCPHttpMessageParser::genClientMessageFromHttp(
     */
     //GET POST DELETE
     auto strHttpMethod = pHttpRequestData->getMethod();
-    auto strConnection = pHttpRequestData->getHeader("connection"); //keep-alive
+    // Header views and the Accept mask are precomputed by MCPHttpRequestParser, no allocation here
+    //keep-alive
+    auto viewConnection = pHttpRequestData->getHeaderView(MCPHttpHeaderId::Connection);
+    bool bKeepAlive = qstrnicmp(viewConnection.data(), viewConnection.size(), "keep-alive") == 0;
     //application/json,text/event-stream
-    auto strAcceptHeader = pHttpRequestData->getHeader("Accept");
-    auto setAcceptTypes = strAcceptHeader.split(",").toList(); //Set();
-    // Clean spaces
-    QList<QString> cleanedAcceptTypes;
-    foreach (const QString &type, setAcceptTypes) {
-        cleanedAcceptTypes.append(type.trimmed());
-    }
-    setAcceptTypes = cleanedAcceptTypes;
-    //application/json,text/event-stream
-    auto strContentType = pHttpRequestData->getHeader("content-type");
-
-    //sse?Mcp-Session-Id=123 NOT 2025-06-18
-    auto strQuerySessionId = pHttpRequestData->getQueryParameter("Mcp-Session-Id");
-    auto strMcpSessionId = pHttpRequestData->getHeader("Mcp-Session-Id");
-    auto strProtocolVersion = pHttpRequestData->getHeader("MCP-Protocol-Version");
+    quint8 nAcceptMask = pHttpRequestData->getAcceptMask();
 
     //1、First, remove the HTTP that sneakily comes in - here we fix it and don't support setting
     auto strPath = pHttpRequestData->getPath();
+    //Prometheus scrape, answered by MCPServerHandler without a session
+    if (strPath == "/metrics") {
+        if (strHttpMethod != "GET") {
+            return QSharedPointer<MCPClientMessage>();
+        }
+        return QSharedPointer<MCPClientMessage>::create(MCPMessageType::Metrics);
+    }
+    //Chrome trace-event JSON of the recorded spans (see MCPTrace), same handling as /metrics
+    if (strPath == "/trace") {
+        if (strHttpMethod != "GET") {
+            return QSharedPointer<MCPClientMessage>();
+        }
+        return QSharedPointer<MCPClientMessage>::create(MCPMessageType::Trace);
+    }
     if (strPath != "/sse" && strPath != "/mcp") {
         return QSharedPointer<MCPClientMessage>();
     }
 
     // Validate Accept header (for POST requests, must include application/json and text/event-stream)
     if (strHttpMethod == "POST") {
-        static QList<QString> setRequiredTypes = {"application/json", "text/event-stream"};
-        if (!setAcceptTypes.contains(setRequiredTypes.at(0))    //2015-06-18
-            && !setAcceptTypes.contains(setRequiredTypes.at(1)) //
-            && !setAcceptTypes.contains("*/*")) {
+        if (!(nAcceptMask & (MCPHttpAccept::Json | MCPHttpAccept::EventStream | MCPHttpAccept::Any))) {
             // Accept header does not meet MCP specification requirements
             return QSharedPointer<MCPClientMessage>();
         }
     }
 
+    //sse?Mcp-Session-Id=123 NOT 2025-06-18
+    auto strQuerySessionId = pHttpRequestData->getQueryParameter("Mcp-Session-Id");
+    auto viewMcpSessionId = pHttpRequestData->getHeaderView(MCPHttpHeaderId::McpSessionId);
+
     //2、Then remove unsupported protocols
     /* Stream resumption - 2025-03-26
     https://modelcontextprotocol.io/specification/2025-03-26/basic/transports#resumability-and-redelivery
-    Designing Last-Event-ID = SessionId + EventId-123, parsing SessionId and EventId from this is not supported at all - too complicated and messy with no real use
+    Event ID = SessionId:EventId (see MCPSseEventBuffer), the SSE reconnect GET is matched to its session by Last-Event-ID alone
     */
-    auto strLastEventId = pHttpRequestData->getHeader("Last-Event-ID"); //Last-Event-ID
-    if (strHttpMethod == "GET" && !strLastEventId.isEmpty()) {
-        return QSharedPointer<MCPClientMessage>();
-    }
+    auto viewLastEventId = pHttpRequestData->getHeaderView(MCPHttpHeaderId::LastEventId); //Last-Event-ID
     /* Client close - 2025-03-26
     https://modelcontextprotocol.io/specification/2025-03-26/basic/transports#streamable-http
     Don't quite understand the meaning, close it if it's closed, feels like it has no real use
@@ -119,25 +120,38 @@ QSharedPointer<MCPClientMessage> MCPHttpMessageParser::genClientMessageFromHttp(
 
     auto pClientMessage = QSharedPointer<MCPClientMessage>::create(MCPMessageType::None);
 
-    pClientMessage->m_strMcpSessionId = strQuerySessionId.isEmpty() ? strMcpSessionId : strQuerySessionId;
+    pClientMessage->m_strMcpSessionId = strQuerySessionId.isEmpty() ? QString::fromLatin1(viewMcpSessionId) : strQuerySessionId;
     //
     //
     //To be compatible with [2024-11-15], first check if it's an SSE connection coming in - only SSE connections will do this
     //https://modelcontextprotocol.io/specification/2024-11-05/basic/transports
-    if (strHttpMethod == "GET" && strQuerySessionId.isEmpty()                         // no sse sessionid
-        && strMcpSessionId.isEmpty()                                                  //no mcp sessionid
-        && strLastEventId.isEmpty()                                                   // not reconnecting
-        && setAcceptTypes.size() == 1 && setAcceptTypes.contains("text/event-stream") //only sse
-        && strConnection == "keep-alive")                                             //sse keep-alive
+    if (strHttpMethod == "GET" && strQuerySessionId.isEmpty() // no sse sessionid
+        && viewMcpSessionId.isEmpty()                         //no mcp sessionid
+        && nAcceptMask == MCPHttpAccept::EventStream          //only sse
+        && bKeepAlive)                                        //sse keep-alive
     {
         //This connect simulates an RPC call
-        pClientMessage->m_jsonRpc.insert("method", "connect");
+        pClientMessage->setJsonRpc(QJsonObject{{"method", "connect"}});
+        //Reconnecting: MCPSessionService resumes the session and the missed events are replayed
+        pClientMessage->m_strLastEventId = QString::fromLatin1(viewLastEventId);
         pClientMessage->appendType(MCPMessageType::SseTransport | MCPMessageType::Connect);
         return pClientMessage;
     }
+    //Standalone SSE stream of an initialized streamable session - 2025-03-26
+    //https://modelcontextprotocol.io/specification/2025-03-26/basic/transports#listening-for-messages-from-the-server
+    //The server pushes notifications on it as they happen instead of piggybacking them on the next POST response
+    if (strHttpMethod == "GET" && strQuerySessionId.isEmpty() // not a legacy sse endpoint
+        && !viewMcpSessionId.isEmpty()                        //mcp sessionid from initialize
+        && (nAcceptMask & MCPHttpAccept::EventStream))        //sse
+    {
+        pClientMessage->setJsonRpc(QJsonObject{{"method", "connect"}});
+        pClientMessage->m_strLastEventId = QString::fromLatin1(viewLastEventId);
+        pClientMessage->appendType(MCPMessageType::StreamableTransport | MCPMessageType::Connect);
+        return pClientMessage;
+    }
     //Batch operations abandon support - 2025-06-18 has clearly abandoned
     //https://modelcontextprotocol.io/specification/2025-03-26/basic/transports#streamable-http
-    if (strHttpMethod == "POST" && strContentType == "application/json") {
+    if (strHttpMethod == "POST" && pHttpRequestData->isContentTypeJson()) {
         auto jsonDoc = QJsonDocument::fromJson(pHttpRequestData->getBody());
         auto jsonRpc = jsonDoc.object();
 
@@ -155,7 +169,7 @@ QSharedPointer<MCPClientMessage> MCPHttpMessageParser::genClientMessageFromHttp(
         auto bResponse = jsonRpc.contains("id") && ((jsonRpc.contains("result") + jsonRpc.contains("error")) == 1);
         auto bNotification = !jsonRpc.contains("id");
         if (bRequest || bResponse || bNotification) {
-            pClientMessage->m_jsonRpc = jsonRpc;
+            pClientMessage->setJsonRpc(jsonRpc);
             //
             bRequest && pClientMessage->appendType(MCPMessageType::Request);
             bResponse && pClientMessage->appendType(MCPMessageType::Response);
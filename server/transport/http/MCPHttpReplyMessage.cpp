@@ -17,6 +17,7 @@ MCPHttpReplyMessage::MCPHttpReplyMessage(const QSharedPointer<MCPServerMessage>
 {
     if (pServerMessage != nullptr) {
         m_pContext = pServerMessage->getContext();
+        m_nTraceId = pServerMessage->getTraceId();
     }
 }
 
@@ -30,17 +31,50 @@ QSharedPointer<MCPHttpReplyMessage> MCPHttpReplyMessage::CreateStreamableAcceptN
     return QSharedPointer<MCPHttpReplyMessage>::create(QSharedPointer<MCPServerMessage>(), MCPMessageType::StreamableTransport | MCPMessageType::ResponseNotification);
 }
 
+QSharedPointer<MCPHttpReplyMessage> MCPHttpReplyMessage::CreateSseEventFrames(const QByteArrayList &lstFrames)
+{
+    auto pReplyMessage = QSharedPointer<MCPHttpReplyMessage>::create(QSharedPointer<MCPServerMessage>(), MCPMessageType::SseTransport | MCPMessageType::RequestNotification);
+    pReplyMessage->m_lstSseFrames = lstFrames;
+    return pReplyMessage;
+}
+
+QSharedPointer<MCPHttpReplyMessage> MCPHttpReplyMessage::CreateMetricsResponse(const QByteArray &byteBody)
+{
+    auto pReplyMessage = QSharedPointer<MCPHttpReplyMessage>::create(QSharedPointer<MCPServerMessage>(), MCPMessageType::Metrics);
+    pReplyMessage->m_lstAdminParts = MCPHttpResponseBuilder::buildMetricsResponseParts(byteBody);
+    return pReplyMessage;
+}
+
+QSharedPointer<MCPHttpReplyMessage> MCPHttpReplyMessage::CreateTraceResponse(const QByteArray &byteBody)
+{
+    auto pReplyMessage = QSharedPointer<MCPHttpReplyMessage>::create(QSharedPointer<MCPServerMessage>(), MCPMessageType::Trace);
+    pReplyMessage->m_lstAdminParts = MCPHttpResponseBuilder::buildTraceResponseParts(byteBody);
+    return pReplyMessage;
+}
+
 QByteArray MCPHttpReplyMessage::toData()
 {
+    return toDataParts().join();
+}
+
+QByteArrayList MCPHttpReplyMessage::toDataParts()
+{
+    if (m_flags & (MCPMessageType::Metrics | MCPMessageType::Trace)) {
+        return m_lstAdminParts;
+    }
+
     if (m_flags & MCPMessageType::Connect) {
-        return toSseConnectResponseData();
+        if (m_flags & MCPMessageType::StreamableTransport) {
+            return QByteArrayList{toStreamableStreamData()};
+        }
+        return QByteArrayList{toSseConnectResponseData()};
     }
 
     if (m_flags & MCPMessageType::SseTransport) {
         if (m_flags & MCPMessageType::Response) {
             return toSseChannelData();
         } else if (m_flags & MCPMessageType::ResponseNotification) {
-            return toAcceptData();
+            return QByteArrayList{toAcceptData()};
         } else if (m_flags & MCPMessageType::RequestNotification) {
             return toSseChannelData();
         }
@@ -50,13 +84,13 @@ QByteArray MCPHttpReplyMessage::toData()
         if (m_flags & MCPMessageType::Response) {
             return toStreamableConnectData();
         } else if (m_flags & MCPMessageType::ResponseNotification) {
-            return toAcceptData();
+            return QByteArrayList{toAcceptData()};
         } else if (m_flags & MCPMessageType::RequestNotification) {
             return toStreamableNotificationData();
         }
     }
 
-    return toAcceptData();
+    return QByteArrayList{toAcceptData()};
 }
 
 QByteArray MCPHttpReplyMessage::toSseConnectResponseData()
@@ -74,13 +108,10 @@ QByteArray MCPHttpReplyMessage::toSseConnectResponseData()
     return MCPHttpResponseBuilder::buildSseConnectResponse(strSessionUri);
 }
 
-QByteArray MCPHttpReplyMessage::toSseChannelData()
+QByteArrayList MCPHttpReplyMessage::toSseChannelData()
 {
-    if (m_pServerMessage == nullptr) {
-        return QByteArray();
-    }
-
-    return MCPHttpResponseBuilder::buildSseMessageResponse(m_pServerMessage->toData());
+    // 帧在MCPServer线程中序列化一次，发送和重放共用同一份数据
+    return m_lstSseFrames;
 }
 
 QByteArray MCPHttpReplyMessage::toSseRequestData()
@@ -93,19 +124,28 @@ QByteArray MCPHttpReplyMessage::toSseNotificationData()
     return toAcceptData();
 }
 
-QByteArray MCPHttpReplyMessage::toStreamableConnectData()
+QByteArray MCPHttpReplyMessage::toStreamableStreamData()
 {
     if (m_pServerMessage == nullptr || m_pServerMessage->getContext() == nullptr) {
         return QByteArray();
     }
 
+    return MCPHttpResponseBuilder::buildStreamableSseStreamResponse(m_pServerMessage->getContext()->getSession());
+}
+
+QByteArrayList MCPHttpReplyMessage::toStreamableConnectData()
+{
+    if (m_pServerMessage == nullptr || m_pServerMessage->getContext() == nullptr) {
+        return QByteArrayList();
+    }
+
     auto pSession = m_pServerMessage->getContext()->getSession();
     if (pSession == nullptr) {
-        return QByteArray();
+        return QByteArrayList();
     }
 
     auto rpcResponseData = m_pServerMessage->toData();
-    return MCPHttpResponseBuilder::buildStreamableResponse(rpcResponseData, pSession);
+    return MCPHttpResponseBuilder::buildStreamableResponseParts(rpcResponseData, pSession);
 }
 
 QByteArray MCPHttpReplyMessage::toStreamableRequestData()
@@ -113,24 +153,24 @@ QByteArray MCPHttpReplyMessage::toStreamableRequestData()
     return QByteArray();
 }
 
-QByteArray MCPHttpReplyMessage::toStreamableNotificationData()
+QByteArrayList MCPHttpReplyMessage::toStreamableNotificationData()
 {
     if (m_pServerMessage == nullptr) {
-        return QByteArray();
+        return QByteArrayList();
     }
 
     auto pContext = m_pServerMessage->getContext();
     if (pContext == nullptr) {
-        return QByteArray();
+        return QByteArrayList();
     }
 
     auto pSession = pContext->getSession();
     if (pSession == nullptr) {
-        return QByteArray();
+        return QByteArrayList();
     }
 
     auto rpcResponseData = m_pServerMessage->toData();
-    return MCPHttpResponseBuilder::buildStreamableResponse(rpcResponseData, pSession);
+    return MCPHttpResponseBuilder::buildStreamableResponseParts(rpcResponseData, pSession);
 }
 
 QByteArray MCPHttpReplyMessage::toAcceptData()
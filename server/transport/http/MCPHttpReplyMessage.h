@@ -20,24 +20,34 @@ public:
 public:
     static QSharedPointer<MCPHttpReplyMessage> CreateSseAcceptNotification();
     static QSharedPointer<MCPHttpReplyMessage> CreateStreamableAcceptNotification();
+    // 已序列化的SSE帧（带事件ID，由MCPMessageSender构建并存入会话的重放缓冲区）
+    static QSharedPointer<MCPHttpReplyMessage> CreateSseEventFrames(const QByteArrayList &lstFrames);
+    // GET /metrics 的应答（Prometheus文本格式）
+    static QSharedPointer<MCPHttpReplyMessage> CreateMetricsResponse(const QByteArray &byteBody);
+    // GET /trace 的应答（Chrome trace-event JSON）
+    static QSharedPointer<MCPHttpReplyMessage> CreateTraceResponse(const QByteArray &byteBody);
 
 public:
     virtual QByteArray toData() override;
+    virtual QByteArrayList toDataParts() override;
 
 private:
     QByteArray toSseConnectResponseData();
     QByteArray toSseRequestData();
     QByteArray toSseNotificationData();
     //
-    QByteArray toStreamableConnectData();
+    QByteArrayList toStreamableConnectData();
+    QByteArray toStreamableStreamData();
     QByteArray toStreamableRequestData();
-    QByteArray toStreamableNotificationData();
+    QByteArrayList toStreamableNotificationData();
 
 private:
-    QByteArray toSseChannelData();
+    QByteArrayList toSseChannelData();
     QByteArray toAcceptData();
 
 protected:
     MCPMessageType::Flags m_flags;
     QSharedPointer<MCPServerMessage> m_pServerMessage;
+    QByteArrayList m_lstSseFrames;
+    QByteArrayList m_lstAdminParts; // GET /metrics、GET /trace 的完整应答
 };
@@ -11,6 +11,82 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
+#include <QByteArrayAlgorithms>
+
+namespace {
+
+struct KnownHeader
+{
+    const char *szName;
+    MCPHttpHeaderId enId;
+};
+
+// MCP关心的请求头，名称比较不区分大小写
+const KnownHeader KNOWN_HEADERS[] = {
+    {"accept", MCPHttpHeaderId::Accept},
+    {"content-type", MCPHttpHeaderId::ContentType},
+    {"mcp-session-id", MCPHttpHeaderId::McpSessionId},
+    {"mcp-protocol-version", MCPHttpHeaderId::McpProtocolVersion},
+    {"last-event-id", MCPHttpHeaderId::LastEventId},
+    {"connection", MCPHttpHeaderId::Connection},
+};
+
+bool equalsIgnoreCase(QByteArrayView view, const char *szText)
+{
+    return qstrnicmp(view.data(), view.size(), szText) == 0;
+}
+
+QByteArrayView trimmed(QByteArrayView view)
+{
+    while (!view.isEmpty() && (view.front() == ' ' || view.front() == '\t')) {
+        view = view.sliced(1);
+    }
+    while (!view.isEmpty() && (view.back() == ' ' || view.back() == '\t')) {
+        view.chop(1);
+    }
+    return view;
+}
+
+// 去掉参数部分（";q=0.9"、";charset=utf-8"）
+QByteArrayView mediaType(QByteArrayView view)
+{
+    qsizetype nPos = view.indexOf(';');
+    return trimmed(nPos < 0 ? view : view.first(nPos));
+}
+
+quint8 parseAccept(QByteArrayView value)
+{
+    quint8 nMask = MCPHttpAccept::None;
+    while (!value.isEmpty()) {
+        qsizetype nComma = value.indexOf(',');
+        QByteArrayView item = mediaType(nComma < 0 ? value : value.first(nComma));
+        value = nComma < 0 ? QByteArrayView() : value.sliced(nComma + 1);
+        if (item.isEmpty()) {
+            continue;
+        }
+        if (equalsIgnoreCase(item, "application/json") || equalsIgnoreCase(item, "application/*")) {
+            nMask |= MCPHttpAccept::Json;
+        } else if (equalsIgnoreCase(item, "text/event-stream") || equalsIgnoreCase(item, "text/*")) {
+            nMask |= MCPHttpAccept::EventStream;
+        } else if (equalsIgnoreCase(item, "*/*")) {
+            nMask |= MCPHttpAccept::Any;
+        } else {
+            nMask |= MCPHttpAccept::Other;
+        }
+    }
+    return nMask;
+}
+
+} // namespace
+
+MCPHttpRequestData::MCPHttpRequestData()
+    : m_nAcceptMask(MCPHttpAccept::None)
+    , m_bContentTypeJson(false)
+{
+    for (auto &nIndex : m_arrKnownHeaders) {
+        nIndex = -1;
+    }
+}
 
 QString MCPHttpRequestData::getMethod() const
 {
@@ -34,7 +110,9 @@ QString MCPHttpRequestData::getHttpVersion() const
 
 QString MCPHttpRequestData::getHeader(const QString& key) const
 {
-    return m_dictHeaders.value(key.toLower(), QString());
+    QByteArray byteKey = key.toLatin1();
+    QByteArrayView value = getHeaderView(QByteArrayView(byteKey));
+    return value.isNull() ? QString() : QString::fromUtf8(value);
 }
 
 QString MCPHttpRequestData::getQueryParameter(const QString& key) const
@@ -47,6 +125,82 @@ QByteArray MCPHttpRequestData::getBody() const
     return m_byteBody;
 }
 
+QByteArrayView MCPHttpRequestData::getHeaderView(MCPHttpHeaderId enId) const
+{
+    if (enId == MCPHttpHeaderId::Unknown || enId == MCPHttpHeaderId::Count) {
+        return QByteArrayView();
+    }
+    qint16 nIndex = m_arrKnownHeaders[static_cast<int>(enId)];
+    if (nIndex < 0) {
+        return QByteArrayView();
+    }
+    const HeaderView &header = m_arrHeaders.at(nIndex);
+    return viewAt(header.nValueOffset, header.nValueLength);
+}
+
+QByteArrayView MCPHttpRequestData::getHeaderView(QByteArrayView name) const
+{
+    for (const HeaderView &header : m_arrHeaders) {
+        QByteArrayView headerName = viewAt(header.nNameOffset, header.nNameLength);
+        if (qstrnicmp(headerName.data(), headerName.size(), name.data(), name.size()) == 0) {
+            return viewAt(header.nValueOffset, header.nValueLength);
+        }
+    }
+    return QByteArrayView();
+}
+
+quint8 MCPHttpRequestData::getAcceptMask() const
+{
+    return m_nAcceptMask;
+}
+
+bool MCPHttpRequestData::isContentTypeJson() const
+{
+    return m_bContentTypeJson;
+}
+
+QByteArrayView MCPHttpRequestData::viewAt(qsizetype nOffset, qsizetype nLength) const
+{
+    // 空值也返回非空视图，便于区分"头存在但为空"和"头不存在"
+    return QByteArrayView(m_byteRawData.constData() + nOffset, nLength);
+}
+
+void MCPHttpRequestData::indexHeaders(const char *pBase)
+{
+    // 在请求头完成时调用，此时原始数据仍在解析器的接收缓冲区(pBase)中
+    for (qsizetype i = 0; i < m_arrHeaders.size(); ++i) {
+        HeaderView &header = m_arrHeaders[i];
+
+        // 去掉值两端的空白
+        QByteArrayView value(pBase + header.nValueOffset, header.nValueLength);
+        QByteArrayView trimmedValue = trimmed(value);
+        header.nValueOffset += trimmedValue.data() - value.data();
+        header.nValueLength = trimmedValue.size();
+
+        QByteArrayView name(pBase + header.nNameOffset, header.nNameLength);
+        for (const KnownHeader &known : KNOWN_HEADERS) {
+            if (equalsIgnoreCase(name, known.szName)) {
+                header.enId = known.enId;
+                qint16 &nIndex = m_arrKnownHeaders[static_cast<int>(known.enId)];
+                if (nIndex < 0) {
+                    nIndex = static_cast<qint16>(i);
+                }
+                break;
+            }
+        }
+    }
+
+    auto knownValue = [this, pBase](MCPHttpHeaderId enId) {
+        qint16 nIndex = m_arrKnownHeaders[static_cast<int>(enId)];
+        if (nIndex < 0) {
+            return QByteArrayView();
+        }
+        return QByteArrayView(pBase + m_arrHeaders.at(nIndex).nValueOffset, m_arrHeaders.at(nIndex).nValueLength);
+    };
+    m_nAcceptMask = parseAccept(knownValue(MCPHttpHeaderId::Accept));
+    m_bContentTypeJson = equalsIgnoreCase(mediaType(knownValue(MCPHttpHeaderId::ContentType)), "application/json");
+}
+
 QByteArray MCPHttpRequestData::rebuildRawRequestData() const
 {
     QString result;
@@ -71,9 +225,10 @@ QByteArray MCPHttpRequestData::rebuildRawRequestData() const
     result += m_strMethod + " " + requestPath + " " + m_strHttpVersion + "\r\n";
 
     // 添加所有请求头
-    for (auto it = m_dictHeaders.begin(); it != m_dictHeaders.end(); ++it)
+    for (const HeaderView &header : m_arrHeaders)
     {
-        result += it.key() + ": " + it.value() + "\r\n";
+        result += QString::fromUtf8(viewAt(header.nNameOffset, header.nNameLength)) + ": "
+                  + QString::fromUtf8(viewAt(header.nValueOffset, header.nValueLength)) + "\r\n";
     }
 
     // 添加空行分隔头和体
@@ -86,4 +241,4 @@ QByteArray MCPHttpRequestData::rebuildRawRequestData() const
     }
 
     return result.toUtf8();
-}
\ No newline at end of file
+}
@@ -1,11 +1,44 @@
-﻿#pragma once
+#pragma once
 #include <QObject>
 #include <QString>
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QMap>
-#include <QSharedPointer> 
+#include <QSharedPointer>
+#include <QVarLengthArray>
+
+/**
+ * @brief 预先定义的MCP相关请求头ID
+ */
+enum class MCPHttpHeaderId : qint8 {
+    Unknown = -1,
+    Accept = 0,
+    ContentType,
+    McpSessionId,
+    McpProtocolVersion,
+    LastEventId,
+    Connection,
+    Count
+};
+
+/**
+ * @brief Accept头解析结果（位掩码）
+ */
+namespace MCPHttpAccept {
+enum Flag : quint8 {
+    None = 0,
+    Json = 1 << 0,        // application/json, application/*
+    EventStream = 1 << 1, // text/event-stream, text/*
+    Any = 1 << 2,         // */*
+    Other = 1 << 3        // 其他类型
+};
+}
+
 class MCPHttpRequestData
 {
+public:
+    MCPHttpRequestData();
+
 public:
     QString getMethod() const;
     QString getUrl() const;
@@ -15,16 +48,43 @@ public:
     QString getQueryParameter(const QString& key) const;
     QByteArray getBody() const;
     QByteArray rebuildRawRequestData() const;
+
+public:
+    // 无分配访问：视图指向请求的原始数据
+    QByteArrayView getHeaderView(MCPHttpHeaderId enId) const;
+    QByteArrayView getHeaderView(QByteArrayView name) const;
+    quint8 getAcceptMask() const;
+    bool isContentTypeJson() const;
+
+private:
+    // 请求头解析完成后调用：识别预定义头并计算Accept掩码
+    void indexHeaders(const char* pBase);
+    QByteArrayView viewAt(qsizetype nOffset, qsizetype nLength) const;
+
+protected:
+    struct HeaderView
+    {
+        qsizetype nNameOffset;
+        qsizetype nNameLength;
+        qsizetype nValueOffset;
+        qsizetype nValueLength;
+        MCPHttpHeaderId enId;
+    };
+
 protected:
     // 重置请求
     QString m_strMethod;
     QString m_strUrl;
     QString m_strPath;
     QString m_strHttpVersion;
-    QStringList m_lstHeaderNames;
-    QMap<QString, QString> m_dictHeaders;
     QMap<QString, QString> m_dictQueryParams;
     QByteArray m_byteBody;
+    // 请求的原始数据，请求头以偏移量方式引用
+    QByteArray m_byteRawData;
+    QVarLengthArray<HeaderView, 16> m_arrHeaders;
+    qint16 m_arrKnownHeaders[static_cast<int>(MCPHttpHeaderId::Count)];
+    quint8 m_nAcceptMask;
+    bool m_bContentTypeJson;
 private:
     friend class MCPHttpRequestParser;
 };
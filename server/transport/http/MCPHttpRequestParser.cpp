@@ -9,40 +9,143 @@
 #include <MCPHttpRequestParser.h>
 #include <MCPLog.h>
 #include <llhttp.h>
+#include <QAtomicInteger>
 #include <QJsonDocument>
 #include <QSharedPointer>
 #include <QUrl>
 
+static QAtomicInteger<qint64> s_nDefaultMaxHeaderSize(MCPHttpRequestParser::DEFAULT_MAX_HEADER_SIZE);
+static QAtomicInteger<qint64> s_nDefaultMaxBodySize(MCPHttpRequestParser::DEFAULT_MAX_BODY_SIZE);
+
 MCPHttpRequestParser::MCPHttpRequestParser(QObject *parent)
     : QObject(parent)
+    , m_nHeaderSize(0)
+    , m_nMaxHeaderSize(s_nDefaultMaxHeaderSize.loadRelaxed())
+    , m_nMaxBodySize(s_nDefaultMaxBodySize.loadRelaxed())
+    , m_bRejected(false)
+    , m_enLastHeaderSpan(HeaderSpan::None)
+    , m_nRejectStatus(0)
 {
     m_pParser = new llhttp_t();
     m_pSettings = new llhttp_settings_t();
     resetParser();
 }
 
-MCPHttpRequestParser::~MCPHttpRequestParser() {}
+MCPHttpRequestParser::~MCPHttpRequestParser()
+{
+    delete m_pParser;
+    delete m_pSettings;
+}
+
+void MCPHttpRequestParser::setLimits(qint64 nMaxHeaderSize, qint64 nMaxBodySize)
+{
+    m_nMaxHeaderSize = nMaxHeaderSize;
+    m_nMaxBodySize = nMaxBodySize;
+}
+
+void MCPHttpRequestParser::setDefaultLimits(qint64 nMaxHeaderSize, qint64 nMaxBodySize)
+{
+    s_nDefaultMaxHeaderSize.storeRelaxed(nMaxHeaderSize > 0 ? nMaxHeaderSize : DEFAULT_MAX_HEADER_SIZE);
+    s_nDefaultMaxBodySize.storeRelaxed(nMaxBodySize > 0 ? nMaxBodySize : DEFAULT_MAX_BODY_SIZE);
+}
 
 bool MCPHttpRequestParser::appendData(const QByteArray &data)
 {
-    m_byteRawData.append(data);
+    if (m_bRejected) {
+        return false;
+    }
     if (data.size() == 0) {
         return true;
     }
 
-    // 执行解析
-    auto xError = llhttp_execute(m_pParser, data.constData(), data.size());
-    if (xError == HPE_OK) {
-        return true;
+    // 在接收缓冲区上解析，回调中的指针可换算为相对于消息起始的偏移量
+    qsizetype nParsePos = m_byteRawData.size();
+    m_byteRawData.append(data);
+
+    bool bResult = true;
+    while (nParsePos < m_byteRawData.size()) {
+        // 执行解析
+        const char *pBase = m_byteRawData.constData();
+        auto xError = llhttp_execute(m_pParser, pBase + nParsePos, m_byteRawData.size() - nParsePos);
+        if (xError == HPE_OK) {
+            return bResult;
+        }
+
+        qsizetype nPos = llhttp_get_error_pos(m_pParser) - pBase;
+
+        // onMessageComplete暂停解析：nPos是下一个消息的起始位置
+        if (xError == HPE_PAUSED) {
+            llhttp_resume(m_pParser);
+            completeMessage(nPos);
+            nParsePos = 0;
+            continue;
+        }
+
+        // 超出限制：不再解析该连接的数据
+        if (m_bRejected) {
+            MCP_TRANSPORT_LOG_WARNING() << "llhttp rejected:" << m_byteRejectReason;
+            m_byteRawData = QByteArray();
+            emit httpRequestRejected(m_nRejectStatus, m_byteRejectReason);
+            return false;
+        }
+
+        MCP_TRANSPORT_LOG_WARNING() << "llhttp error:" << llhttp_errno_name(xError) << " " << llhttp_get_error_reason(m_pParser);
+        //解析错误，重置并从错误位置继续
+        resetParser();
+        bResult = false;
+        if (nPos <= nParsePos || nPos >= m_byteRawData.size()) {
+            m_byteRawData.resize(0);
+            recycleBuffer();
+            return false;
+        }
+        m_byteRawData.remove(0, nPos);
+        nParsePos = 0;
     }
-    MCP_TRANSPORT_LOG_WARNING() << "llhttp error:" << llhttp_errno_name(xError) << " " << llhttp_get_error_reason(m_pParser);
-    QByteArray newData = QByteArray(llhttp_get_error_pos(m_pParser));
-    //解析错误，重置
-    resetParser();
-    if (newData.size() == 0) {
-        return false;
+    return bResult;
+}
+
+void MCPHttpRequestParser::completeMessage(qsizetype nMessageSize)
+{
+    auto pRequestData = m_pRequestData;
+
+    // 消息数据交给请求对象，请求头视图引用其中的偏移量
+    if (nMessageSize == m_byteRawData.size()) {
+        pRequestData->m_byteRawData.swap(m_byteRawData);
+    } else {
+        // 流水线请求：剩余数据属于下一个消息
+        pRequestData->m_byteRawData = m_byteRawData.left(nMessageSize);
+        m_byteRawData.remove(0, nMessageSize);
     }
-    return appendData(newData);
+    recycleBuffer();
+
+#if 0
+    MCP_TRANSPORT_LOG_INFO() << "HTTP-RECV:" << pRequestData->getMethod() //
+                             << "url:" << pRequestData->getUrl()          //
+                             << "size:" << pRequestData->m_byteRawData.size();
+    if (pRequestData->m_byteRawData.indexOf("\n{") > -1) {
+        QByteArray payload = pRequestData->m_byteRawData.mid(pRequestData->m_byteRawData.indexOf("{"));
+        QJsonDocument doc = QJsonDocument::fromJson(payload);
+        MCP_TRANSPORT_LOG_DEBUG().noquote() << "HTTP-RECV:" << doc.toJson();
+    }
+#endif
+    emit httpRequestReceived(pRequestData->m_byteRawData, pRequestData);
+}
+
+void MCPHttpRequestParser::recycleBuffer()
+{
+    // 复用小缓冲区，释放大请求留下的内存
+    if (m_byteRawData.capacity() > RETAINED_BUFFER_CAPACITY) {
+        m_byteRawData.squeeze();
+    }
+}
+
+int MCPHttpRequestParser::reject(int nHttpStatus, const char *szReason)
+{
+    m_bRejected = true;
+    m_nRejectStatus = nHttpStatus;
+    m_byteRejectReason = QByteArray(szReason);
+    llhttp_set_error_reason(m_pParser, szReason);
+    return -1;
 }
 
 // 静态回调函数实现
@@ -50,12 +153,17 @@ int MCPHttpRequestParser::onMessageBegin(llhttp_t *parser)
 {
     MCPHttpRequestParser *pInstance = static_cast<MCPHttpRequestParser *>(parser->data);
     pInstance->m_pRequestData = QSharedPointer<MCPHttpRequestData>::create();
+    pInstance->m_nHeaderSize = 0;
+    pInstance->m_enLastHeaderSpan = HeaderSpan::None;
     return 0;
 }
 
 int MCPHttpRequestParser::onUrl(llhttp_t *parser, const char *data, size_t length)
 {
     MCPHttpRequestParser *pInstance = static_cast<MCPHttpRequestParser *>(parser->data);
+    if ((pInstance->m_nHeaderSize += length) > pInstance->m_nMaxHeaderSize) {
+        return pInstance->reject(414, "URI Too Long");
+    }
     QString urlPart = QString::fromUtf8(data, length);
     pInstance->m_pRequestData->m_strUrl.append(urlPart);
     return 0;
@@ -64,14 +172,37 @@ int MCPHttpRequestParser::onUrl(llhttp_t *parser, const char *data, size_t lengt
 int MCPHttpRequestParser::onHeaderField(llhttp_t *parser, const char *data, size_t length)
 {
     MCPHttpRequestParser *pInstance = static_cast<MCPHttpRequestParser *>(parser->data);
-    pInstance->m_pRequestData->m_lstHeaderNames << QString::fromUtf8(data, length);
+    if ((pInstance->m_nHeaderSize += length) > pInstance->m_nMaxHeaderSize) {
+        return pInstance->reject(431, "Request Header Fields Too Large");
+    }
+    // 只记录偏移量；跨数据块的名称在缓冲区中是连续的，直接延长
+    auto &arrHeaders = pInstance->m_pRequestData->m_arrHeaders;
+    if (pInstance->m_enLastHeaderSpan == HeaderSpan::Field) {
+        arrHeaders.back().nNameLength += length;
+    } else {
+        arrHeaders.append({data - pInstance->m_byteRawData.constData(), static_cast<qsizetype>(length), 0, 0, MCPHttpHeaderId::Unknown});
+    }
+    pInstance->m_enLastHeaderSpan = HeaderSpan::Field;
     return 0;
 }
 
 int MCPHttpRequestParser::onHeaderValue(llhttp_t *parser, const char *data, size_t length)
 {
     MCPHttpRequestParser *pInstance = static_cast<MCPHttpRequestParser *>(parser->data);
-    pInstance->m_pRequestData->m_dictHeaders[pInstance->m_pRequestData->m_lstHeaderNames.back().toLower()].append(QString::fromUtf8(data, length));
+    if ((pInstance->m_nHeaderSize += length) > pInstance->m_nMaxHeaderSize) {
+        return pInstance->reject(431, "Request Header Fields Too Large");
+    }
+    auto &arrHeaders = pInstance->m_pRequestData->m_arrHeaders;
+    if (arrHeaders.isEmpty()) {
+        return 0;
+    }
+    if (pInstance->m_enLastHeaderSpan == HeaderSpan::Value) {
+        arrHeaders.back().nValueLength += length;
+    } else {
+        arrHeaders.back().nValueOffset = data - pInstance->m_byteRawData.constData();
+        arrHeaders.back().nValueLength = length;
+    }
+    pInstance->m_enLastHeaderSpan = HeaderSpan::Value;
     return 0;
 }
 
@@ -79,6 +210,15 @@ int MCPHttpRequestParser::onHeadersComplete(llhttp_t *parser)
 {
     MCPHttpRequestParser *pInstance = static_cast<MCPHttpRequestParser *>(parser->data);
     auto pRequestData = pInstance->m_pRequestData;
+    // 根据Content-Length检查并预分配请求体
+    if (parser->flags & F_CONTENT_LENGTH) {
+        if (parser->content_length > static_cast<quint64>(pInstance->m_nMaxBodySize)) {
+            return pInstance->reject(413, "Payload Too Large");
+        }
+        pRequestData->m_byteBody.reserve(static_cast<qsizetype>(parser->content_length));
+    }
+    // 识别预定义请求头，计算Accept掩码
+    pRequestData->indexHeaders(pInstance->m_byteRawData.constData());
     // 解析HTTP方法
     pRequestData->m_strMethod = QString::fromUtf8(llhttp_method_name(static_cast<llhttp_method_t>(parser->method)));
     // 解析HTTP版本
@@ -107,25 +247,19 @@ int MCPHttpRequestParser::onHeadersComplete(llhttp_t *parser)
 int MCPHttpRequestParser::onBody(llhttp_t *parser, const char *data, size_t length)
 {
     MCPHttpRequestParser *pInstance = static_cast<MCPHttpRequestParser *>(parser->data);
+    // 分块传输没有Content-Length，累计检查
+    if (pInstance->m_pRequestData->m_byteBody.size() + static_cast<qint64>(length) > pInstance->m_nMaxBodySize) {
+        return pInstance->reject(413, "Payload Too Large");
+    }
     pInstance->m_pRequestData->m_byteBody.append(data, length);
     return 0;
 }
 
 int MCPHttpRequestParser::onMessageComplete(llhttp_t *parser)
 {
-    MCPHttpRequestParser *pInstance = static_cast<MCPHttpRequestParser *>(parser->data);
-#if 0
-    MCP_TRANSPORT_LOG_INFO() << "HTTP-RECV:" << pInstance->m_pRequestData->getMethod() //
-                             << "url:" << pInstance->m_pRequestData->getUrl()          //
-                             << "size:" << pInstance->m_byteRawData.size();
-    if (pInstance->m_byteRawData.indexOf("\n{") > -1) {
-        QByteArray payload = pInstance->m_byteRawData.mid(pInstance->m_byteRawData.indexOf("{"));
-        QJsonDocument doc = QJsonDocument::fromJson(payload);
-        MCP_TRANSPORT_LOG_DEBUG().noquote() << "HTTP-RECV:" << doc.toJson();
-    }
-#endif
-    emit pInstance->httpRequestReceived(pInstance->m_byteRawData, pInstance->m_pRequestData);
-    return 0;
+    Q_UNUSED(parser);
+    // 暂停解析，由appendData()根据暂停位置截取消息边界后发出信号
+    return HPE_PAUSED;
 }
 
 bool MCPHttpRequestParser::resetParser()
@@ -144,7 +278,8 @@ bool MCPHttpRequestParser::resetParser()
     //
     llhttp_init(m_pParser, HTTP_REQUEST, m_pSettings);
     m_pParser->data = this;
-    m_byteRawData = QByteArray();
+    m_nHeaderSize = 0;
+    m_enLastHeaderSpan = HeaderSpan::None;
     m_pRequestData = QSharedPointer<MCPHttpRequestData>::create();
     return true;
 }
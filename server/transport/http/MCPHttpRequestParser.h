@@ -18,14 +18,26 @@ class MCPHttpRequestParser : public QObject
 {
     Q_OBJECT
 
+public:
+    // 默认限制：请求头 64KB，请求体 16MB
+    static constexpr qint64 DEFAULT_MAX_HEADER_SIZE = 64 * 1024;
+    static constexpr qint64 DEFAULT_MAX_BODY_SIZE = 16 * 1024 * 1024;
+    // 空闲时保留的接收缓冲区容量，超过则释放
+    static constexpr qint64 RETAINED_BUFFER_CAPACITY = 64 * 1024;
+
     // 解析状态枚举
 public:
     explicit MCPHttpRequestParser(QObject* parent = nullptr);
     ~MCPHttpRequestParser();
 signals:
     void httpRequestReceived(QByteArray data, QSharedPointer<MCPHttpRequestData> pRequestData);
+    // 请求超出限制（431/413），连接应回复错误并关闭
+    void httpRequestRejected(int nHttpStatus, QByteArray reason);
 public:
     bool appendData(const QByteArray& data);
+    void setLimits(qint64 nMaxHeaderSize, qint64 nMaxBodySize);
+    // 新建解析器使用的全局默认限制（由服务器配置设置）
+    static void setDefaultLimits(qint64 nMaxHeaderSize, qint64 nMaxBodySize);
 private:
     // HTTP解析器回调函数
     static int onMessageBegin(llhttp_t* parser);
@@ -37,9 +49,22 @@ private:
     static int onMessageComplete(llhttp_t* parser);
 private:
     bool resetParser();
+    void completeMessage(qsizetype nMessageSize);
+    void recycleBuffer();
+    int reject(int nHttpStatus, const char* szReason);
 private:
+    // 接收缓冲区：从当前消息起始位置开始，消息完成后交给请求对象
     QByteArray m_byteRawData;
     QSharedPointer<MCPHttpRequestData> m_pRequestData;
+    qint64 m_nHeaderSize;
+    qint64 m_nMaxHeaderSize;
+    qint64 m_nMaxBodySize;
+    bool m_bRejected;
+    // 上一次请求头回调类型，用于拼接跨数据块的名称/值
+    enum class HeaderSpan { None, Field, Value };
+    HeaderSpan m_enLastHeaderSpan;
+    int m_nRejectStatus;
+    QByteArray m_byteRejectReason;
 private:
 
     llhttp_t* m_pParser;
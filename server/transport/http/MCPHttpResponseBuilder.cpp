@@ -10,11 +10,54 @@
 #include <MCPSession.h>
 #include <QSharedPointer>
 
+// 预先序列化的固定响应片段（只初始化一次，之后以隐式共享方式引用）
+static const QByteArray &corsHeadersTemplate()
+{
+    static const QByteArray arrCors("Access-Control-Allow-Origin: *\r\n"
+                                    "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                                    "Access-Control-Allow-Headers: Content-Type, Authorization, X-Requested-With\r\n"
+                                    "Access-Control-Expose-Headers: Content-Length, Content-Range\r\n");
+    return arrCors;
+}
+
+static const QByteArray &streamableStatusTemplate()
+{
+    static const QByteArray arrTemplate("HTTP/1.1 200 OK\r\n"
+                                        "Content-Type: application/json\r\n"
+                                        "Content-Length: ");
+    return arrTemplate;
+}
+
+static const QByteArray &streamableTailTemplate()
+{
+    static const QByteArray arrTemplate = QByteArray("Connection: keep-alive\r\n") + corsHeadersTemplate() + "\r\n";
+    return arrTemplate;
+}
+
+static const QByteArray &sseEventIdPrefixTemplate()
+{
+    static const QByteArray arrTemplate("id: ");
+    return arrTemplate;
+}
+
+static const QByteArray &sseMessagePrefixTemplate()
+{
+    static const QByteArray arrTemplate("\n"
+                                        "event: message\n"
+                                        "data: ");
+    return arrTemplate;
+}
+
+static const QByteArray &sseFrameEndTemplate()
+{
+    static const QByteArray arrTemplate("\n\n");
+    return arrTemplate;
+}
+
 QByteArray MCPHttpResponseBuilder::buildSseConnectResponse(const QString &strSessionUri)
 {
     QByteArray arrResponse;
     arrResponse.append(buildSseHeaders());
-    arrResponse.append("\r\n");
 
     arrResponse.append("event: endpoint");
     arrResponse.append("\n");
@@ -24,86 +67,143 @@ QByteArray MCPHttpResponseBuilder::buildSseConnectResponse(const QString &strSes
     return arrResponse;
 }
 
-QByteArray MCPHttpResponseBuilder::buildSseMessageResponse(const QByteArray &strMessageData)
+QByteArray MCPHttpResponseBuilder::buildStreamableSseStreamResponse(const QSharedPointer<MCPSession> &pSession)
 {
     QByteArray arrResponse;
-    arrResponse.append(buildSseHeaders());
-    arrResponse.append("\r\n");
-
-    arrResponse.append("event: message");
-    arrResponse.append("\n");
-    arrResponse.append("data: ");
-    arrResponse.append(strMessageData);
-    arrResponse.append("\n\n");
+    arrResponse.append("HTTP/1.1 200 OK\r\n"
+                       "Content-Type: text/event-stream\r\n"
+                       "Cache-Control: no-cache\r\n");
+
+    // 没有endpoint事件，客户端继续POST到同一个端点
+    if (pSession != nullptr) {
+        arrResponse.append("Mcp-Session-Id: ");
+        arrResponse.append(pSession->getSessionId().toLatin1());
+        arrResponse.append("\r\n");
+        if (!pSession->getProtocolVersion().isEmpty()) {
+            arrResponse.append("MCP-Protocol-Version: ");
+            arrResponse.append(pSession->getProtocolVersion().toLatin1());
+            arrResponse.append("\r\n");
+        }
+    }
 
+    arrResponse.append(streamableTailTemplate());
     return arrResponse;
 }
 
+QByteArray MCPHttpResponseBuilder::buildSseMessageResponse(const QByteArray &byteEventId, const QByteArray &strMessageData)
+{
+    return buildSseMessageResponseParts(byteEventId, strMessageData).join();
+}
+
+QByteArrayList MCPHttpResponseBuilder::buildSseMessageResponseParts(const QByteArray &byteEventId, const QByteArray &strMessageData)
+{
+    // 响应头已随endpoint事件发送，这里只有SSE帧
+    return QByteArrayList{sseEventIdPrefixTemplate(), byteEventId, sseMessagePrefixTemplate(), strMessageData, sseFrameEndTemplate()};
+}
+
 QByteArray MCPHttpResponseBuilder::buildStreamableResponse(const QByteArray &strMessageData, const QSharedPointer<MCPSession> &pSession)
+{
+    return buildStreamableResponseParts(strMessageData, pSession).join();
+}
+
+QByteArrayList MCPHttpResponseBuilder::buildStreamableResponseParts(const QByteArray &strMessageData, const QSharedPointer<MCPSession> &pSession)
 {
     QString strSessionId = pSession ? pSession->getSessionId() : QString();
     QString strProtocolVersion = pSession ? pSession->getProtocolVersion() : QString();
 
-    QByteArray arrResponse;
-    arrResponse.append(buildStreamableHeaders(strMessageData.size(), strSessionId, strProtocolVersion));
-    arrResponse.append("\r\n");
-    arrResponse.append(strMessageData);
+    return QByteArrayList{streamableStatusTemplate(),
+                          buildStreamableHeaders(strMessageData.size(), strSessionId, strProtocolVersion),
+                          streamableTailTemplate(),
+                          strMessageData};
+}
 
+QByteArray MCPHttpResponseBuilder::buildAcceptResponse()
+{
+    static const QByteArray arrResponse = QByteArray("HTTP/1.1 202 Accepted\r\n"
+                                                     "Content-Length: 0\r\n"
+                                                     "Connection: keep-alive\r\n")
+                                          + buildCorsHeaders() + "\r\n";
     return arrResponse;
 }
 
-QByteArray MCPHttpResponseBuilder::buildAcceptResponse()
+QByteArray MCPHttpResponseBuilder::buildErrorResponse(int nStatusCode, const QByteArray &byteReason)
 {
     QByteArray arrResponse;
-    arrResponse.append(QString("HTTP/1.1 %1 %2\r\n").arg(202).arg("Accepted").toUtf8());
+    arrResponse.append("HTTP/1.1 ");
+    arrResponse.append(QByteArray::number(nStatusCode));
+    arrResponse.append(' ');
+    arrResponse.append(byteReason);
+    arrResponse.append("\r\n");
     arrResponse.append("Content-Length: 0\r\n");
-    arrResponse.append("Connection: keep-alive\r\n");
+    arrResponse.append("Connection: close\r\n");
     arrResponse.append(buildCorsHeaders());
     arrResponse.append("\r\n");
 
     return arrResponse;
 }
 
-QByteArray MCPHttpResponseBuilder::buildSseHeaders()
+QByteArrayList MCPHttpResponseBuilder::buildMetricsResponseParts(const QByteArray &byteBody)
+{
+    QByteArray arrHeaders;
+    arrHeaders.reserve(128);
+    arrHeaders.append("HTTP/1.1 200 OK\r\n"
+                      "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                      "Cache-Control: no-cache\r\n"
+                      "Connection: keep-alive\r\n"
+                      "Content-Length: ");
+    arrHeaders.append(QByteArray::number(byteBody.size()));
+    arrHeaders.append("\r\n\r\n");
+    return QByteArrayList{arrHeaders, byteBody};
+}
+
+QByteArrayList MCPHttpResponseBuilder::buildTraceResponseParts(const QByteArray &byteBody)
 {
     QByteArray arrHeaders;
-    arrHeaders.append("HTTP/1.1 200 OK\r\n");
-    arrHeaders.append("Content-Type: text/event-stream\r\n");
-    arrHeaders.append("Cache-Control: no-cache\r\n");
-    arrHeaders.append("Connection: keep-alive\r\n");
-    arrHeaders.append(buildCorsHeaders());
+    arrHeaders.reserve(128);
+    arrHeaders.append("HTTP/1.1 200 OK\r\n"
+                      "Content-Type: application/json\r\n"
+                      "Cache-Control: no-cache\r\n"
+                      "Connection: keep-alive\r\n"
+                      "Content-Length: ");
+    arrHeaders.append(QByteArray::number(byteBody.size()));
+    arrHeaders.append("\r\n\r\n");
+    return QByteArrayList{arrHeaders, byteBody};
+}
 
+const QByteArray &MCPHttpResponseBuilder::buildSseHeaders()
+{
+    static const QByteArray arrHeaders = QByteArray("HTTP/1.1 200 OK\r\n"
+                                                    "Content-Type: text/event-stream\r\n"
+                                                    "Cache-Control: no-cache\r\n"
+                                                    "Connection: keep-alive\r\n")
+                                         + buildCorsHeaders() + "\r\n";
     return arrHeaders;
 }
 
-QByteArray MCPHttpResponseBuilder::buildStreamableHeaders(int nContentLength, const QString &strSessionId, const QString &strProtocolVersion)
+QByteArray MCPHttpResponseBuilder::buildStreamableHeaders(qsizetype nContentLength, const QString &strSessionId, const QString &strProtocolVersion)
 {
+    // 只包含可变字段，状态行和CORS来自模板
     QByteArray arrHeaders;
-    arrHeaders.append("HTTP/1.1 200 OK\r\n");
-    arrHeaders.append("Content-Type: application/json\r\n");
-    arrHeaders.append(QString("Content-Length: %1\r\n").arg(nContentLength).toUtf8());
+    arrHeaders.reserve(128);
+    arrHeaders.append(QByteArray::number(nContentLength));
+    arrHeaders.append("\r\n");
 
     if (!strSessionId.isEmpty()) {
-        arrHeaders.append(QString("Mcp-Session-Id: %1\r\n").arg(strSessionId).toUtf8());
+        arrHeaders.append("Mcp-Session-Id: ");
+        arrHeaders.append(strSessionId.toLatin1());
+        arrHeaders.append("\r\n");
     }
 
     if (!strProtocolVersion.isEmpty()) {
-        arrHeaders.append(QString("MCP-Protocol-Version: %1\r\n").arg(strProtocolVersion).toUtf8());
+        arrHeaders.append("MCP-Protocol-Version: ");
+        arrHeaders.append(strProtocolVersion.toLatin1());
+        arrHeaders.append("\r\n");
     }
 
-    arrHeaders.append("Connection: keep-alive\r\n");
-    arrHeaders.append(buildCorsHeaders());
-
     return arrHeaders;
 }
 
-QByteArray MCPHttpResponseBuilder::buildCorsHeaders()
+const QByteArray &MCPHttpResponseBuilder::buildCorsHeaders()
 {
-    QByteArray arrCors;
-    arrCors.append("Access-Control-Allow-Origin: *\r\n");
-    arrCors.append("Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n");
-    arrCors.append("Access-Control-Allow-Headers: Content-Type, Authorization, X-Requested-With\r\n");
-    arrCors.append("Access-Control-Expose-Headers: Content-Length, Content-Range\r\n");
-
-    return arrCors;
+    return corsHeadersTemplate();
 }
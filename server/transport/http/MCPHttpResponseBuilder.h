@@ -8,6 +8,7 @@
 
 #pragma once
 #include <QByteArray>
+#include <QByteArrayList>
 #include <QString>
 #include <QSharedPointer>
 
@@ -21,6 +22,10 @@ class MCPSession;
  * - 减少HTTP响应构建代码的重复
  * - 提供清晰的接口构建不同类型的HTTP响应
  * 
+ * 性能说明：
+ * - 固定的响应头（状态行、CORS等）只序列化一次，作为共享的QByteArray模板
+ * - build*Parts() 返回 [模板, 可变字段, 模板, 消息体] 分段，消息体不被复制
+ *
  * 编码规范：
  * - 静态方法用于构建响应
  * - { 和 } 要单独一行
@@ -36,11 +41,27 @@ public:
     static QByteArray buildSseConnectResponse(const QString& strSessionUri);
 
     /**
-     * @brief 构建SSE消息响应
+     * @brief 构建Streamable会话的GET SSE流响应头（之后的通知以SSE帧写在这个流上）
+     * @param pSession 会话对象（用于获取SessionId和ProtocolVersion）
+     * @return HTTP响应头
+     */
+    static QByteArray buildStreamableSseStreamResponse(const QSharedPointer<MCPSession>& pSession);
+
+    /**
+     * @brief 构建SSE消息帧（写在已建立的SSE流上，不含HTTP响应头）
+     * @param byteEventId 事件ID（客户端重连时作为 Last-Event-ID 带回）
      * @param strMessageData 消息数据（JSON格式）
-     * @return HTTP响应数据
+     * @return SSE帧数据
      */
-    static QByteArray buildSseMessageResponse(const QByteArray& strMessageData);
+    static QByteArray buildSseMessageResponse(const QByteArray& byteEventId, const QByteArray& strMessageData);
+
+    /**
+     * @brief 构建SSE消息帧（分段，消息体不复制）
+     * @param byteEventId 事件ID
+     * @param strMessageData 消息数据（JSON格式）
+     * @return SSE帧分段
+     */
+    static QByteArrayList buildSseMessageResponseParts(const QByteArray& byteEventId, const QByteArray& strMessageData);
 
     /**
      * @brief 构建Streamable连接/响应
@@ -50,32 +71,61 @@ public:
      */
     static QByteArray buildStreamableResponse(const QByteArray& strMessageData, const QSharedPointer<MCPSession>& pSession);
 
+    /**
+     * @brief 构建Streamable响应（分段，消息体不复制）
+     * @param strMessageData 消息数据（JSON格式）
+     * @param pSession 会话对象（用于获取SessionId和ProtocolVersion）
+     * @return HTTP响应分段
+     */
+    static QByteArrayList buildStreamableResponseParts(const QByteArray& strMessageData, const QSharedPointer<MCPSession>& pSession);
+
     /**
      * @brief 构建接受通知响应（202 Accepted）
      * @return HTTP响应数据
      */
     static QByteArray buildAcceptResponse();
 
+    /**
+     * @brief 构建错误响应（连接随后关闭）
+     * @param nStatusCode HTTP状态码
+     * @param byteReason 状态描述
+     * @return HTTP响应数据
+     */
+    static QByteArray buildErrorResponse(int nStatusCode, const QByteArray& byteReason);
+
+    /**
+     * @brief 构建 GET /metrics 响应（Prometheus文本格式，保持连接）
+     * @param byteBody 指标文本
+     * @return 响应头和消息体两段，消息体不复制
+     */
+    static QByteArrayList buildMetricsResponseParts(const QByteArray& byteBody);
+
+    /**
+     * @brief 构建 GET /trace 响应（Chrome trace-event JSON，保持连接）
+     * @param byteBody 跟踪数据
+     * @return 响应头和消息体两段，消息体不复制
+     */
+    static QByteArrayList buildTraceResponseParts(const QByteArray& byteBody);
+
 private:
     /**
-     * @brief 构建SSE响应头
+     * @brief SSE响应头模板（含CORS和空行）
      * @return SSE响应头
      */
-    static QByteArray buildSseHeaders();
+    static const QByteArray& buildSseHeaders();
 
     /**
-     * @brief 构建Streamable响应头
+     * @brief 构建Streamable响应头中的可变字段
      * @param nContentLength 内容长度
      * @param strSessionId 会话ID
      * @param strProtocolVersion 协议版本
-     * @return Streamable响应头
+     * @return Content-Length值及可选的Mcp-Session-Id、MCP-Protocol-Version行
      */
-    static QByteArray buildStreamableHeaders(int nContentLength, const QString& strSessionId, const QString& strProtocolVersion);
+    static QByteArray buildStreamableHeaders(qsizetype nContentLength, const QString& strSessionId, const QString& strProtocolVersion);
 
     /**
-     * @brief 构建通用CORS头
+     * @brief 通用CORS头模板
      * @return CORS头字符串
      */
-    static QByteArray buildCorsHeaders();
+    static const QByteArray& buildCorsHeaders();
 };
-
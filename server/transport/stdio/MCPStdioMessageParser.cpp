@@ -0,0 +1,55 @@
+/**
+ * @file MCPStdioMessageParser.cpp
+ * @brief MCP stdio message parser implementation
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include <MCPClientInitializeMessage.h>
+#include <MCPStdioMessageParser.h>
+#include <QJsonDocument>
+#include <QJsonParseError>
+
+QSharedPointer<MCPClientMessage> MCPStdioMessageParser::genClientMessageFromLine(const QByteArray &byteLine, bool *pParseError)
+{
+    // stdio: one JSON-RPC object per line, no batch (same as Streamable HTTP 2025-06-18)
+    QJsonParseError jsonError;
+    auto jsonDoc = QJsonDocument::fromJson(byteLine, &jsonError);
+    if (pParseError != nullptr) {
+        *pParseError = jsonError.error != QJsonParseError::NoError;
+    }
+    if (jsonError.error != QJsonParseError::NoError || !jsonDoc.isObject()) {
+        return QSharedPointer<MCPClientMessage>();
+    }
+
+    auto jsonRpc = jsonDoc.object();
+    QJsonValue jsonrpcValue = jsonRpc.value("jsonrpc");
+    if (!jsonrpcValue.isString() || jsonrpcValue.toString() != "2.0") {
+        return QSharedPointer<MCPClientMessage>();
+    }
+
+    auto bRequest = jsonRpc.contains("id") && jsonRpc.contains("method");
+    auto bResponse = jsonRpc.contains("id") && ((jsonRpc.contains("result") + jsonRpc.contains("error")) == 1);
+    auto bNotification = !jsonRpc.contains("id");
+    if (!bRequest && !bResponse && !bNotification) {
+        return QSharedPointer<MCPClientMessage>();
+    }
+
+    // stdio 只有一个隐式会话，不携带 Mcp-Session-Id
+    auto pClientMessage = QSharedPointer<MCPClientMessage>::create(MCPMessageType::StdioTransport);
+    pClientMessage->setJsonRpc(jsonRpc);
+    bRequest && pClientMessage->appendType(MCPMessageType::Request);
+    bResponse && pClientMessage->appendType(MCPMessageType::Response);
+    bNotification && pClientMessage->appendType(MCPMessageType::Notification);
+
+    auto strMethodName = pClientMessage->getMethodName();
+    if (strMethodName == "ping") {
+        pClientMessage->appendType(MCPMessageType::Ping);
+    }
+    if (strMethodName == "initialize") {
+        pClientMessage->appendType(MCPMessageType::Initialize);
+        return QSharedPointer<MCPClientInitializeMessage>::create(*pClientMessage);
+    }
+    return pClientMessage;
+}
@@ -0,0 +1,37 @@
+/**
+ * @file MCPStdioMessageParser.h
+ * @brief MCP stdio (newline-delimited JSON-RPC) message parser
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <QByteArray>
+#include <QSharedPointer>
+#include "MCPClientMessage.h"
+
+/**
+ * @brief MCP stdio message parser
+ *
+ * Responsibilities:
+ * - Turn one NDJSON line into an MCPClientMessage tagged with StdioTransport
+ * - Apply the same JSON-RPC validation as MCPHttpMessageParser
+ *
+ * Coding conventions:
+ * - Class members add m_ prefix
+ * - Pointer types add p prefix
+ * - { and } should be on separate lines
+ */
+class MCPStdioMessageParser
+{
+public:
+    /**
+     * @brief Parse one JSON-RPC line (without the trailing newline)
+     * @param byteLine JSON text
+     * @param pParseError Optional, set to true when the line is not JSON at all (parse error) and to
+     *        false when it is JSON but not a JSON-RPC 2.0 message (invalid request)
+     * @return Client message, null if the line is not a valid JSON-RPC 2.0 object
+     */
+    static QSharedPointer<MCPClientMessage> genClientMessageFromLine(const QByteArray &byteLine, bool *pParseError = nullptr);
+};
@@ -0,0 +1,166 @@
+/**
+ * @file MCPStdioReader.cpp
+ * @brief MCP stdin reader thread implementation
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include <MCPLog.h>
+#include <MCPMessage.h>
+#include <MCPStdioMessageParser.h>
+#include <MCPStdioReader.h>
+
+#include <errno.h>
+#include <string.h>
+#ifdef Q_OS_WIN
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+// Poll timeout so shutdown() is noticed while stdin stays idle
+static constexpr int STDIO_POLL_TIMEOUT_MS = 200;
+
+MCPStdioReader::MCPStdioReader(qint64 nMaxLineSize, QObject *pParent)
+    : QThread(pParent)
+    , m_nMaxLineSize(nMaxLineSize)
+    , m_bRunning(true) // not in run(): a shutdown() before the thread is scheduled must win
+    , m_nScanOffset(0)
+    , m_bDiscardLine(false)
+{
+    setObjectName("MCPStdio-Reader");
+}
+
+MCPStdioReader::~MCPStdioReader()
+{
+    shutdown();
+}
+
+void MCPStdioReader::shutdown()
+{
+    m_bRunning.storeRelease(false);
+    if (isRunning()) {
+#ifdef Q_OS_WIN
+        // _read() on a console/pipe cannot be interrupted
+        if (!wait(STDIO_POLL_TIMEOUT_MS)) {
+            terminate();
+            wait();
+        }
+#else
+        wait();
+#endif
+    }
+}
+
+void MCPStdioReader::run()
+{
+    char buffer[STDIO_READ_CHUNK];
+
+    MCP_TRANSPORT_LOG_INFO() << "MCPStdioReader: started";
+
+#ifdef Q_OS_WIN
+    _setmode(_fileno(stdin), _O_BINARY);
+#endif
+
+    while (m_bRunning.loadAcquire()) {
+#ifndef Q_OS_WIN
+        pollfd pfd;
+        pfd.fd = STDIN_FILENO;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int nReady = ::poll(&pfd, 1, STDIO_POLL_TIMEOUT_MS);
+        if (nReady < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            MCP_TRANSPORT_LOG_WARNING() << "MCPStdioReader: poll failed:" << strerror(errno);
+            break;
+        }
+        if (nReady == 0) {
+            continue;
+        }
+        ssize_t nRead = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+#else
+        int nRead = _read(_fileno(stdin), buffer, sizeof(buffer));
+#endif
+        if (nRead > 0) {
+            m_byteBuffer.append(buffer, static_cast<qsizetype>(nRead));
+            processBuffer();
+            continue;
+        }
+        if (nRead == 0) {
+            // Client closed stdin, the stdio session is over
+            MCP_TRANSPORT_LOG_INFO() << "MCPStdioReader: stdin closed";
+            emit inputClosed();
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        MCP_TRANSPORT_LOG_WARNING() << "MCPStdioReader: read failed:" << strerror(errno);
+        emit inputClosed();
+        break;
+    }
+
+    m_bRunning.storeRelease(false);
+    MCP_TRANSPORT_LOG_INFO() << "MCPStdioReader: stopped";
+}
+
+void MCPStdioReader::processBuffer()
+{
+    qsizetype nConsumed = 0;
+    if (m_bDiscardLine) {
+        // Skip the rest of an oversized line that was already rejected
+        qsizetype nEnd = m_byteBuffer.indexOf('\n');
+        if (nEnd < 0) {
+            m_byteBuffer.clear();
+            m_nScanOffset = 0;
+            return;
+        }
+        nConsumed = nEnd + 1;
+        m_bDiscardLine = false;
+    }
+
+    for (;;) {
+        // Bytes before m_nScanOffset were already searched in a previous chunk
+        qsizetype nEnd = m_byteBuffer.indexOf('\n', qMax(nConsumed, m_nScanOffset));
+        if (nEnd < 0) {
+            break;
+        }
+
+        QByteArrayView viewLine(m_byteBuffer.constData() + nConsumed, nEnd - nConsumed);
+        nConsumed = nEnd + 1;
+        if (viewLine.endsWith('\r')) {
+            viewLine.chop(1);
+        }
+        if (viewLine.trimmed().isEmpty()) {
+            continue;
+        }
+
+        bool bParseError = false;
+        if (auto pMessage = MCPStdioMessageParser::genClientMessageFromLine(viewLine.toByteArray(), &bParseError)) {
+            emit messageReceived(pMessage);
+        } else if (bParseError) {
+            emit lineRejected(true, "Invalid JSON");
+        } else {
+            emit lineRejected(false, "Invalid JSON-RPC message");
+        }
+    }
+
+    // Compact once per chunk instead of once per line
+    if (nConsumed > 0) {
+        m_byteBuffer.remove(0, nConsumed);
+    }
+    m_nScanOffset = m_byteBuffer.size();
+
+    if (m_byteBuffer.size() > m_nMaxLineSize) {
+        MCP_TRANSPORT_LOG_WARNING() << "MCPStdioReader: line too long:" << m_byteBuffer.size();
+        m_byteBuffer.clear();
+        m_nScanOffset = 0;
+        m_bDiscardLine = true;
+        emit lineRejected(true, "Message too large");
+    }
+}
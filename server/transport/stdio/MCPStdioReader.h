@@ -0,0 +1,70 @@
+/**
+ * @file MCPStdioReader.h
+ * @brief MCP stdin reader thread
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QThread>
+
+class MCPMessage;
+
+/**
+ * @brief Dedicated stdin reader
+ *
+ * Responsibilities:
+ * - Read stdin in large chunks and split it into NDJSON lines
+ * - Parse each line into an MCPClientMessage in this thread
+ * - Report lines that are not valid JSON-RPC so the transport can answer with a parse error or invalid request
+ *
+ * Coding standards:
+ * - Add m_ prefix to class members
+ * - Add p prefix to pointer types
+ * - { and } should be on separate lines
+ */
+class MCPStdioReader : public QThread
+{
+    Q_OBJECT
+
+public:
+    static constexpr int STDIO_READ_CHUNK = 64 * 1024;
+
+public:
+    /**
+     * @brief Constructor
+     * @param nMaxLineSize Maximum size of one JSON-RPC line
+     * @param pParent Parent object
+     */
+    explicit MCPStdioReader(qint64 nMaxLineSize, QObject *pParent = nullptr);
+    virtual ~MCPStdioReader();
+
+public:
+    /**
+     * @brief Ask the reader to exit and wait for the thread
+     */
+    void shutdown();
+
+signals:
+    void messageReceived(const QSharedPointer<MCPMessage> &pMessage);
+    // bParseError: the line is not JSON (or too large to parse), otherwise it is JSON but not JSON-RPC 2.0
+    void lineRejected(bool bParseError, QByteArray reason);
+    void inputClosed();
+
+protected:
+    void run() override;
+
+private:
+    void processBuffer();
+
+private:
+    qint64 m_nMaxLineSize;
+    QAtomicInteger<bool> m_bRunning;
+    QByteArray m_byteBuffer;
+    qsizetype m_nScanOffset;
+    bool m_bDiscardLine;
+};
@@ -0,0 +1,148 @@
+/**
+ * @file MCPStdioTransport.cpp
+ * @brief MCP stdio transport implementation
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include <MCPClientMessage.h>
+#include <MCPError.h>
+#include <MCPHttpRequestParser.h>
+#include <MCPLog.h>
+#include <MCPMessage.h>
+#include <MCPServerMessage.h>
+#include <MCPStdioReader.h>
+#include <MCPStdioTransport.h>
+#include <QJsonDocument>
+#include <QMutexLocker>
+
+#include <errno.h>
+#include <string.h>
+#ifdef Q_OS_WIN
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+MCPStdioTransport::MCPStdioTransport(qint64 nMaxLineSize, QObject *pParent)
+    : IMCPTransport(pParent)
+    , m_nMaxLineSize(nMaxLineSize > 0 ? nMaxLineSize : MCPHttpRequestParser::DEFAULT_MAX_BODY_SIZE)
+    , m_pReader(nullptr)
+{
+    qRegisterMetaType<QSharedPointer<MCPMessage>>("QSharedPointer<MCPMessage>");
+    qRegisterMetaType<QSharedPointer<MCPClientMessage>>("QSharedPointer<MCPClientMessage>");
+    qRegisterMetaType<QSharedPointer<MCPServerMessage>>("QSharedPointer<MCPResponse>");
+}
+
+MCPStdioTransport::~MCPStdioTransport()
+{
+    stop();
+}
+
+bool MCPStdioTransport::start(quint16 /*nPort*/)
+{
+    if (m_pReader != nullptr) {
+        return true; // Already started
+    }
+
+    // stdout 只能输出协议数据（加载 stdio 配置时已切到 stderr，这里兜底）
+    MCPLog::instance()->setConsoleToStderr(true);
+
+#ifdef Q_OS_WIN
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    m_pReader = new MCPStdioReader(m_nMaxLineSize, this);
+    // Direct connection: re-emit from the reader thread, receivers in other threads get queued delivery
+    QObject::connect(m_pReader, &MCPStdioReader::messageReceived, this, &MCPStdioTransport::onReaderMessageReceived, Qt::DirectConnection);
+    QObject::connect(m_pReader, &MCPStdioReader::lineRejected, this, &MCPStdioTransport::onLineRejected, Qt::DirectConnection);
+    QObject::connect(m_pReader, &MCPStdioReader::inputClosed, this, &MCPStdioTransport::onInputClosed, Qt::DirectConnection);
+    m_pReader->start();
+
+    MCP_TRANSPORT_LOG_INFO() << "MCP STDIO start OK";
+    return true;
+}
+
+bool MCPStdioTransport::stop()
+{
+    if (m_pReader == nullptr) {
+        return true;
+    }
+
+    MCP_TRANSPORT_LOG_INFO() << "MCP STDIO stop";
+    m_pReader->shutdown();
+    delete m_pReader;
+    m_pReader = nullptr;
+    return true;
+}
+
+bool MCPStdioTransport::isRunning()
+{
+    return m_pReader != nullptr;
+}
+
+void MCPStdioTransport::sendMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pMessage)
+{
+    if (nConnectionId != STDIO_CONNECTION_ID || pMessage == nullptr) {
+        return;
+    }
+    writeLine(pMessage->toDataParts());
+}
+
+void MCPStdioTransport::sendCloseMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pMessage)
+{
+    // stdio has a single long-lived stream, there is nothing to close
+    sendMessage(nConnectionId, pMessage);
+}
+
+void MCPStdioTransport::onReaderMessageReceived(const QSharedPointer<MCPMessage> &pMessage)
+{
+    emit messageReceived(STDIO_CONNECTION_ID, pMessage);
+}
+
+void MCPStdioTransport::onLineRejected(bool bParseError, QByteArray reason)
+{
+    // JSON-RPC: unparsable input is a parse error, JSON that is not a JSON-RPC 2.0 message an invalid request, both with a null id
+    auto strReason = QString::fromUtf8(reason);
+    auto jsonError = (bParseError ? MCPError::parseError(strReason) : MCPError::invalidRequest(strReason)).toJsonResponse();
+    writeLine(QByteArrayList{QJsonDocument(jsonError).toJson(QJsonDocument::Compact)});
+}
+
+void MCPStdioTransport::onInputClosed()
+{
+    emit connectionDisconnected(STDIO_CONNECTION_ID);
+}
+
+void MCPStdioTransport::writeLine(const QByteArrayList &lstParts)
+{
+    // Compact JSON never contains a raw newline, so '\n' is a safe frame delimiter
+    QMutexLocker locker(&m_mutexWrite);
+    auto writeAll = [](const char *pData, qsizetype nSize) -> bool {
+        while (nSize > 0) {
+#ifdef Q_OS_WIN
+            int nWritten = _write(_fileno(stdout), pData, static_cast<unsigned int>(nSize));
+#else
+            ssize_t nWritten = ::write(STDOUT_FILENO, pData, static_cast<size_t>(nSize));
+#endif
+            if (nWritten < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                MCP_TRANSPORT_LOG_WARNING() << "MCPStdioTransport: write failed:" << strerror(errno);
+                return false;
+            }
+            pData += nWritten;
+            nSize -= nWritten;
+        }
+        return true;
+    };
+
+    for (const auto &part : lstParts) {
+        if (!writeAll(part.constData(), part.size())) {
+            return;
+        }
+    }
+    writeAll("\n", 1);
+}
@@ -0,0 +1,71 @@
+/**
+ * @file MCPStdioTransport.h
+ * @brief MCP stdio transport (newline-delimited JSON-RPC over stdin/stdout)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#pragma once
+#include "IMCPTransport.h"
+#include <QByteArrayList>
+#include <QMutex>
+
+class MCPStdioReader;
+
+/**
+ * @brief MCP stdio transport
+ *
+ * Responsibilities:
+ * - Implement IMCPTransport over stdin/stdout for local clients (IDE, CLI)
+ * - One JSON-RPC message per line in both directions, no HTTP framing
+ * - A dedicated MCPStdioReader thread does the blocking reads and the parsing
+ *
+ * Design notes:
+ * - There is exactly one client, it always uses STDIO_CONNECTION_ID
+ * - Writes are serialized with a mutex and may come from any thread
+ * - Console logging is moved to stderr while running, stdout carries only protocol data
+ * - Selected with "transport": "stdio" in the server configuration
+ *
+ * Coding standards:
+ * - Add m_ prefix to class members
+ * - Add p prefix to pointer types
+ * - { and } should be on separate lines
+ */
+class MCPStdioTransport : public IMCPTransport
+{
+    Q_OBJECT
+
+public:
+    static constexpr quint64 STDIO_CONNECTION_ID = 1;
+
+public:
+    /**
+     * @brief Constructor
+     * @param nMaxLineSize Maximum size of one incoming JSON-RPC line (<= 0 uses the HTTP body limit default)
+     * @param pParent Parent object
+     */
+    explicit MCPStdioTransport(qint64 nMaxLineSize, QObject *pParent = nullptr);
+    virtual ~MCPStdioTransport();
+
+public:
+    // 实现IMCPTransport接口（nPort 对 stdio 无意义）
+    virtual bool start(quint16 nPort = 8888) override;
+    virtual bool stop() override;
+    virtual bool isRunning() override;
+    virtual void sendMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pMessage) override;
+    virtual void sendCloseMessage(quint64 nConnectionId, QSharedPointer<MCPMessage> pMessage) override;
+
+private slots:
+    void onReaderMessageReceived(const QSharedPointer<MCPMessage> &pMessage);
+    void onLineRejected(bool bParseError, QByteArray reason);
+    void onInputClosed();
+
+private:
+    void writeLine(const QByteArrayList &lstParts);
+
+private:
+    qint64 m_nMaxLineSize;
+    MCPStdioReader *m_pReader;
+    QMutex m_mutexWrite;
+};
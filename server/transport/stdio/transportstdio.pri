@@ -0,0 +1,12 @@
+INCLUDEPATH  += $$PWD
+QMAKE_INCDIR += $$PWD
+
+SOURCES += \
+    $$PWD/MCPStdioMessageParser.cpp \
+    $$PWD/MCPStdioReader.cpp \
+    $$PWD/MCPStdioTransport.cpp
+
+HEADERS += \
+    $$PWD/MCPStdioMessageParser.h \
+    $$PWD/MCPStdioReader.h \
+    $$PWD/MCPStdioTransport.h
@@ -6,9 +6,11 @@ SUBDIRS += \
 
 HEADERS += \
     $$PWD/IMCPTransport.h \
+    $$PWD/MCPHttpLocalServer.h \
     $$PWD/MCPHttpTransport.h \
     $$PWD/MCPHttpTransportAdapter.h
 
 SOURCES += \
+    $$PWD/MCPHttpLocalServer.cpp \
     $$PWD/MCPHttpTransport.cpp \
     $$PWD/MCPHttpTransportAdapter.cpp
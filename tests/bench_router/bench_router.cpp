@@ -0,0 +1,88 @@
+/**
+ * @file bench_router.cpp
+ * @brief Microbenchmark of MCPRouter dispatch (ns/dispatch for ping and tools/list)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include <MCPContext.h>
+#include <MCPLog.h>
+#include <MCPMiddlewares.h>
+#include <MCPRouter.h>
+#include <MCPServerMessage.h>
+#include <MCPSession.h>
+#include <MCPStdioMessageParser.h>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QTextStream>
+
+namespace {
+
+constexpr int WARMUP_ITERATIONS = 100000;
+constexpr int ITERATIONS = 2000000;
+
+// Runs fn ITERATIONS times after a warm-up, returns ns per call
+template<typename Fn>
+double measure(Fn fn)
+{
+    for (int i = 0; i < WARMUP_ITERATIONS; ++i) {
+        fn();
+    }
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        fn();
+    }
+    return static_cast<double>(timer.nsecsElapsed()) / ITERATIONS;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    // Dispatch logs at debug level, the benchmark measures the routing, not the console
+    MCPLog::instance()->setLogLevel(LogLevel::Warning);
+
+    // Same middleware chain as MCPRequestDispatcher, minus admission (needs the tool executor)
+    MCPRouter router;
+    router.use(QSharedPointer<MCPLoggingMiddleware>::create());
+    router.use(QSharedPointer<MCPPerformanceMiddleware>::create(500));
+    router.use(QSharedPointer<MCPSessionValidationMiddleware>::create());
+
+    QJsonArray arrTools;
+    for (int i = 0; i < 16; ++i) {
+        arrTools.append(QJsonObject{{"name", QString("tool_%1").arg(i)}, {"description", "benchmark tool"}});
+    }
+    router.registerRoute("ping", [](const QSharedPointer<MCPContext> &pContext) { return QSharedPointer<MCPServerMessage>::create(pContext, QJsonObject()); });
+    router.registerRoute("tools/list", [arrTools](const QSharedPointer<MCPContext> &pContext) {
+        return QSharedPointer<MCPServerMessage>::create(pContext, QJsonObject{{"tools", arrTools}});
+    });
+
+    auto pSession = QSharedPointer<MCPSession>::create();
+    pSession->setStatus(EnumSessionStatus::enInitialized);
+
+    // Parsed after the routes are registered, as in the server: the parser resolves the method ID
+    auto pPing = MCPStdioMessageParser::genClientMessageFromLine(R"({"jsonrpc":"2.0","id":1,"method":"ping"})");
+    auto pToolsList = MCPStdioMessageParser::genClientMessageFromLine(R"({"jsonrpc":"2.0","id":2,"method":"tools/list"})");
+    if (pPing == nullptr || pToolsList == nullptr || pPing->getMethodNameId() < 0 || pToolsList->getMethodNameId() < 0) {
+        QTextStream(stderr) << "bench_router: method IDs were not resolved at parse time\n";
+        return 1;
+    }
+    auto pPingContext = QSharedPointer<MCPContext>::create(0, pSession, pPing);
+    auto pToolsListContext = QSharedPointer<MCPContext>::create(0, pSession, pToolsList);
+    const QString strPing = pPing->getMethodName();
+    const QString strToolsList = pToolsList->getMethodName();
+
+    QTextStream out(stdout);
+    out.setRealNumberNotation(QTextStream::FixedNotation);
+    out.setRealNumberPrecision(1);
+    out << "iterations: " << ITERATIONS << "\n";
+    out << "ping        by id:   " << measure([&]() { router.dispatch(pPingContext); }) << " ns/dispatch\n";
+    out << "ping        by name: " << measure([&]() { router.dispatch(strPing, pPingContext); }) << " ns/dispatch\n";
+    out << "tools/list  by id:   " << measure([&]() { router.dispatch(pToolsListContext); }) << " ns/dispatch\n";
+    out << "tools/list  by name: " << measure([&]() { router.dispatch(strToolsList, pToolsListContext); }) << " ns/dispatch\n";
+    return 0;
+}
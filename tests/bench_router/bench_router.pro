@@ -0,0 +1,8 @@
+# ns/dispatch of MCPRouter for ping and tools/list, by parse-time method ID and by method name
+TARGET = bench_router
+TEMPLATE = app
+
+include(../tests.pri)
+
+SOURCES += \
+    bench_router.cpp
@@ -0,0 +1,11 @@
+# Keep-alive soak of MCPHttpRequestParser: 1M requests on one parser, RSS must stay flat
+TARGET = tst_soak_http_parser
+TEMPLATE = app
+
+QT += testlib
+CONFIG += testcase
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_soak_http_parser.cpp
@@ -0,0 +1,213 @@
+/**
+ * @file tst_soak_http_parser.cpp
+ * @brief Keep-alive soak test of MCPHttpRequestParser (bounded, reused buffers and request limits)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include <MCPHttpRequestData.h>
+#include <MCPHttpRequestParser.h>
+#include <MCPLog.h>
+#include <QByteArray>
+#include <QFile>
+#include <QtTest>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr int SOAK_REQUESTS = 1000000;
+constexpr int WARMUP_REQUESTS = 100000;
+// Allocator noise only, a leak of a few bytes per request is several MiB over the soak
+constexpr qint64 MAX_RSS_GROWTH = 4 * 1024 * 1024;
+
+QByteArray makeRequest(const QByteArray &byteBody)
+{
+    return QByteArray("POST /mcp HTTP/1.1\r\n"
+                      "Host: localhost:6605\r\n"
+                      "Content-Type: application/json\r\n"
+                      "Accept: application/json, text/event-stream\r\n"
+                      "Connection: keep-alive\r\n"
+                      "Mcp-Session-Id: 6f1c2d3e-4a5b-6c7d-8e9f-0a1b2c3d4e5f\r\n"
+                      "Content-Length: ")
+           + QByteArray::number(byteBody.size()) + "\r\n\r\n" + byteBody;
+}
+
+// Resident set size in bytes, -1 where /proc is not available
+qint64 residentBytes()
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/statm");
+    if (file.open(QIODevice::ReadOnly)) {
+        const auto lstFields = file.readAll().split(' ');
+        if (lstFields.size() > 1) {
+            return lstFields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+    return -1;
+}
+
+} // namespace
+
+class TstSoakHttpParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void keepAliveSoak();
+    void largeBodyThenSmallRequests();
+    void headerLimit();
+    void bodyLimit();
+
+private:
+    // Feeds one round of requests the way a socket may deliver them, returns the requests fed
+    int feedRound(MCPHttpRequestParser &parser, const QByteArray &byteRequest, int nRound);
+};
+
+void TstSoakHttpParser::initTestCase()
+{
+    MCPLog::instance()->setLogLevel(LogLevel::Warning);
+}
+
+int TstSoakHttpParser::feedRound(MCPHttpRequestParser &parser, const QByteArray &byteRequest, int nRound)
+{
+    switch (nRound % 4) {
+    case 0:
+        // One read per request
+        parser.appendData(byteRequest);
+        return 1;
+    case 1:
+        // Split inside the request line/headers
+        parser.appendData(byteRequest.left(37));
+        parser.appendData(byteRequest.mid(37));
+        return 1;
+    case 2:
+        // Split inside the body
+        parser.appendData(byteRequest.left(byteRequest.size() - 7));
+        parser.appendData(byteRequest.right(7));
+        return 1;
+    default:
+        // Pipelined: two requests and the start of a third in one read, the rest in the next
+        parser.appendData(byteRequest + byteRequest + byteRequest.left(50));
+        parser.appendData(byteRequest.mid(50));
+        return 3;
+    }
+}
+
+void TstSoakHttpParser::keepAliveSoak()
+{
+    const QByteArray byteBody = R"({"jsonrpc":"2.0","id":1,"method":"tools/call","params":{"name":"calculator","arguments":{"a":1,"b":2}}})";
+    const QByteArray byteRequest = makeRequest(byteBody);
+
+    MCPHttpRequestParser parser;
+    int nReceived = 0;
+    int nBad = 0;
+    QObject::connect(&parser, &MCPHttpRequestParser::httpRequestReceived, [&](QByteArray data, QSharedPointer<MCPHttpRequestData> pRequestData) {
+        ++nReceived;
+        if (data.size() != byteRequest.size() || pRequestData->getMethod() != "POST" || pRequestData->getBody() != byteBody
+            || pRequestData->getHeader("mcp-session-id").isEmpty()) {
+            ++nBad;
+        }
+    });
+    int nRejected = 0;
+    QObject::connect(&parser, &MCPHttpRequestParser::httpRequestRejected, [&](int, QByteArray) { //
+        ++nRejected;
+    });
+
+    int nSent = 0;
+    int nRound = 0;
+    while (nSent < WARMUP_REQUESTS) {
+        nSent += feedRound(parser, byteRequest, nRound++);
+    }
+    const qint64 nRssBefore = residentBytes();
+
+    while (nSent < WARMUP_REQUESTS + SOAK_REQUESTS) {
+        nSent += feedRound(parser, byteRequest, nRound++);
+    }
+    const qint64 nRssAfter = residentBytes();
+
+    QCOMPARE(nRejected, 0);
+    QCOMPARE(nReceived, nSent);
+    QCOMPARE(nBad, 0);
+    if (nRssBefore < 0) {
+        QSKIP("RSS is only measured on Linux");
+    }
+    qInfo() << "requests:" << nSent << "RSS before:" << nRssBefore << "after:" << nRssAfter;
+    QVERIFY2(nRssAfter - nRssBefore <= MAX_RSS_GROWTH, qPrintable(QString("RSS grew by %1 bytes").arg(nRssAfter - nRssBefore)));
+}
+
+void TstSoakHttpParser::largeBodyThenSmallRequests()
+{
+    // A large request must not pin its buffer for the rest of the connection
+    const QByteArray byteLargeBody = QByteArray(R"({"jsonrpc":"2.0","id":1,"method":"ping","params":{"pad":")") + QByteArray(4 * 1024 * 1024, 'x') + "\"}}";
+    const QByteArray byteSmallBody = R"({"jsonrpc":"2.0","id":2,"method":"ping"})";
+
+    MCPHttpRequestParser parser;
+    QList<qsizetype> lstBodySizes;
+    QObject::connect(&parser, &MCPHttpRequestParser::httpRequestReceived, [&](QByteArray, QSharedPointer<MCPHttpRequestData> pRequestData) { //
+        lstBodySizes.append(pRequestData->getBody().size());
+    });
+
+    const QByteArray byteLargeRequest = makeRequest(byteLargeBody);
+    // Delivered in socket-sized reads
+    for (qsizetype nPos = 0; nPos < byteLargeRequest.size(); nPos += 64 * 1024) {
+        QVERIFY(parser.appendData(byteLargeRequest.mid(nPos, 64 * 1024)));
+    }
+    const qint64 nRssAfterLarge = residentBytes();
+    for (int i = 0; i < 10000; ++i) {
+        QVERIFY(parser.appendData(makeRequest(byteSmallBody)));
+    }
+
+    QCOMPARE(lstBodySizes.size(), 10001);
+    QCOMPARE(lstBodySizes.first(), byteLargeBody.size());
+    QCOMPARE(lstBodySizes.last(), byteSmallBody.size());
+    if (nRssAfterLarge >= 0) {
+        QVERIFY(residentBytes() - nRssAfterLarge <= MAX_RSS_GROWTH);
+    }
+}
+
+void TstSoakHttpParser::headerLimit()
+{
+    MCPHttpRequestParser parser;
+    parser.setLimits(1024, MCPHttpRequestParser::DEFAULT_MAX_BODY_SIZE);
+    int nStatus = 0;
+    QObject::connect(&parser, &MCPHttpRequestParser::httpRequestRejected, [&](int nHttpStatus, QByteArray) { //
+        nStatus = nHttpStatus;
+    });
+
+    QByteArray byteRequest = "POST /mcp HTTP/1.1\r\nHost: localhost\r\nX-Padding: " + QByteArray(4096, 'a') + "\r\nContent-Length: 2\r\n\r\n{}";
+    QVERIFY(!parser.appendData(byteRequest));
+    QCOMPARE(nStatus, 431);
+    // The connection is answered and closed, nothing more is parsed
+    QVERIFY(!parser.appendData(makeRequest("{}")));
+}
+
+void TstSoakHttpParser::bodyLimit()
+{
+    MCPHttpRequestParser parser;
+    parser.setLimits(MCPHttpRequestParser::DEFAULT_MAX_HEADER_SIZE, 1024);
+    int nStatus = 0;
+    int nReceived = 0;
+    QObject::connect(&parser, &MCPHttpRequestParser::httpRequestRejected, [&](int nHttpStatus, QByteArray) { //
+        nStatus = nHttpStatus;
+    });
+    QObject::connect(&parser, &MCPHttpRequestParser::httpRequestReceived, [&](QByteArray, QSharedPointer<MCPHttpRequestData>) { //
+        ++nReceived;
+    });
+
+    QVERIFY(parser.appendData(makeRequest(QByteArray(1024, 'b'))));
+    QCOMPARE(nReceived, 1);
+
+    // Rejected from Content-Length, before the body arrives
+    QVERIFY(!parser.appendData(makeRequest(QByteArray(1025, 'b')).left(300)));
+    QCOMPARE(nStatus, 413);
+    QCOMPARE(nReceived, 1);
+}
+
+QTEST_GUILESS_MAIN(TstSoakHttpParser)
+#include "tst_soak_http_parser.moc"
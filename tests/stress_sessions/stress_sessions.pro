@@ -0,0 +1,11 @@
+# MCPSessionService with 100k sessions: lookups, LRU eviction and open streams
+TARGET = tst_stress_sessions
+TEMPLATE = app
+
+QT += testlib
+CONFIG += testcase
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_stress_sessions.cpp
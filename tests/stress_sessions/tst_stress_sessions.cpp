@@ -0,0 +1,166 @@
+/**
+ * @file tst_stress_sessions.cpp
+ * @brief Stress test of MCPSessionService with 100k sessions (indexes, LRU eviction, open streams)
+ * @author zhangheng
+ * @date 2025-01-09
+ * @copyright Copyright (c) 2025 zhangheng. All rights reserved.
+ */
+
+#include <MCPClientMessage.h>
+#include <MCPLog.h>
+#include <MCPSession.h>
+#include <MCPSessionService.h>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QtTest>
+
+namespace {
+
+constexpr int SESSIONS = 100000;
+
+QSharedPointer<MCPClientMessage> streamableInitialize()
+{
+    return QSharedPointer<MCPClientMessage>::create(MCPMessageType::StreamableTransport | MCPMessageType::Initialize | MCPMessageType::Request);
+}
+
+QSharedPointer<MCPClientMessage> sseConnect()
+{
+    return QSharedPointer<MCPClientMessage>::create(MCPMessageType::SseTransport | MCPMessageType::Connect);
+}
+
+} // namespace
+
+class TstStressSessions : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void createAndLookup();
+    void lruEvictionAtCapacity();
+    void openStreamsAreNotEvicted();
+    void connectionCloseKeepsStreamableSessions();
+
+private:
+    // Creates nCount streamable sessions on connections nFirstConnectionId.., returns their IDs in creation order
+    static QStringList createStreamable(MCPSessionService &service, quint64 nFirstConnectionId, int nCount);
+};
+
+void TstStressSessions::initTestCase()
+{
+    // One INFO line per removed session would dominate the run
+    MCPLog::instance()->setLogLevel(LogLevel::Warning);
+}
+
+QStringList TstStressSessions::createStreamable(MCPSessionService &service, quint64 nFirstConnectionId, int nCount)
+{
+    QStringList lstSessionIds;
+    lstSessionIds.reserve(nCount);
+    for (int i = 0; i < nCount; ++i) {
+        auto pSession = service.getSession(nFirstConnectionId + i, streamableInitialize());
+        if (pSession == nullptr) {
+            return QStringList();
+        }
+        lstSessionIds.append(pSession->getSessionId());
+    }
+    return lstSessionIds;
+}
+
+void TstStressSessions::createAndLookup()
+{
+    MCPSessionService service;
+    service.setLimits(MCPSessionService::DEFAULT_SESSION_TIMEOUT, SESSIONS);
+
+    QElapsedTimer timer;
+    timer.start();
+    const auto lstSessionIds = createStreamable(service, 1, SESSIONS);
+    const qint64 nCreateMs = timer.restart();
+    QCOMPARE(lstSessionIds.size(), SESSIONS);
+    QCOMPARE(service.getSessionCount(), SESSIONS);
+
+    // Both indexes resolve every session
+    for (int i = 0; i < SESSIONS; ++i) {
+        auto pById = service.getSessionBySessionId(lstSessionIds.at(i));
+        auto pByConnection = service.getSessionByConnectionId(static_cast<quint64>(i) + 1);
+        QVERIFY(pById != nullptr);
+        QVERIFY(pById == pByConnection);
+    }
+    qInfo() << "sessions:" << SESSIONS << "create:" << nCreateMs << "ms lookup:" << timer.elapsed() << "ms";
+}
+
+void TstStressSessions::lruEvictionAtCapacity()
+{
+    MCPSessionService service;
+    service.setLimits(MCPSessionService::DEFAULT_SESSION_TIMEOUT, SESSIONS);
+    const auto lstSessionIds = createStreamable(service, 1, SESSIONS);
+    QCOMPARE(lstSessionIds.size(), SESSIONS);
+
+    // The oldest 1000 make room for the newest, the count stays at the limit
+    QSignalSpy spyRemoved(&service, &MCPSessionService::sessionRemoved);
+    const auto lstNewIds = createStreamable(service, SESSIONS + 1, 1000);
+    QCOMPARE(lstNewIds.size(), 1000);
+    QCOMPARE(service.getSessionCount(), SESSIONS);
+    QCOMPARE(spyRemoved.count(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(service.getSessionBySessionId(lstSessionIds.at(i)) == nullptr);
+        QVERIFY(service.getSessionByConnectionId(static_cast<quint64>(i) + 1) == nullptr);
+        QVERIFY(service.getSessionBySessionId(lstNewIds.at(i)) != nullptr);
+    }
+    QVERIFY(service.getSessionBySessionId(lstSessionIds.at(1000)) != nullptr);
+}
+
+void TstStressSessions::openStreamsAreNotEvicted()
+{
+    MCPSessionService service;
+    service.setLimits(MCPSessionService::DEFAULT_SESSION_TIMEOUT, SESSIONS);
+
+    // Oldest sessions, but their SSE streams are connected
+    QStringList lstSseIds;
+    for (int i = 0; i < 1000; ++i) {
+        auto pSession = service.getSession(static_cast<quint64>(i) + 1, sseConnect());
+        QVERIFY(pSession != nullptr);
+        lstSseIds.append(pSession->getSessionId());
+    }
+    const auto lstStreamableIds = createStreamable(service, 1001, SESSIONS);
+    QCOMPARE(lstStreamableIds.size(), SESSIONS);
+    QCOMPARE(service.getSessionCount(), SESSIONS);
+
+    // The sessions without a stream were evicted instead
+    for (const auto &strSessionId : lstSseIds) {
+        QVERIFY(service.getSessionBySessionId(strSessionId) != nullptr);
+    }
+    QVERIFY(service.getSessionBySessionId(lstStreamableIds.first()) == nullptr);
+    QVERIFY(service.getSessionBySessionId(lstStreamableIds.last()) != nullptr);
+
+    // Detached streams (kept for Last-Event-ID replay) become evictable again
+    for (int i = 0; i < 1000; ++i) {
+        service.removeSessionBySSEConnectId(static_cast<quint64>(i) + 1);
+    }
+    QVERIFY(service.getSessionBySessionId(lstSseIds.first()) != nullptr);
+    createStreamable(service, SESSIONS + 1001, SESSIONS);
+    QCOMPARE(service.getSessionCount(), SESSIONS);
+    for (const auto &strSessionId : lstSseIds) {
+        QVERIFY(service.getSessionBySessionId(strSessionId) == nullptr);
+    }
+}
+
+void TstStressSessions::connectionCloseKeepsStreamableSessions()
+{
+    MCPSessionService service;
+    service.setLimits(MCPSessionService::DEFAULT_SESSION_TIMEOUT, SESSIONS);
+    const auto lstSessionIds = createStreamable(service, 1, SESSIONS);
+    QCOMPARE(lstSessionIds.size(), SESSIONS);
+
+    // Keep-alive connections close, the sessions continue through Mcp-Session-Id
+    for (int i = 0; i < SESSIONS; ++i) {
+        service.removeSessionBySSEConnectId(static_cast<quint64>(i) + 1);
+    }
+    QCOMPARE(service.getSessionCount(), SESSIONS);
+    for (int i = 0; i < SESSIONS; i += 997) {
+        QVERIFY(service.getSessionByConnectionId(static_cast<quint64>(i) + 1) == nullptr);
+        QVERIFY(service.getSessionBySessionId(lstSessionIds.at(i)) != nullptr);
+    }
+}
+
+QTEST_GUILESS_MAIN(TstStressSessions)
+#include "tst_stress_sessions.moc"
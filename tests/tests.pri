@@ -0,0 +1,32 @@
+# Common settings of the test targets: the server sources without the application (main.cpp)
+QT  += core
+QT  += gui
+QT  += widgets
+QT  += concurrent
+QT  += core5compat
+QT  += network
+
+CONFIG += c++20
+CONFIG += console
+CONFIG -= app_bundle
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+
+ROOT = $$PWD/..
+
+include($$ROOT/server/3rdparty/3rdparty.pri)
+include($$ROOT/server/core/core.pri)
+include($$ROOT/server/errors/errors.pri)
+include($$ROOT/server/config/config.pri)
+include($$ROOT/server/messages/messages.pri)
+include($$ROOT/server/transport/transport.pri)
+include($$ROOT/server/transport/http/transporthttp.pri)
+linux: include($$ROOT/server/transport/epoll/transportepoll.pri)
+include($$ROOT/server/transport/stdio/transportstdio.pri)
+include($$ROOT/server/session/session.pri)
+include($$ROOT/server/routing/routing.pri)
+include($$ROOT/server/middleware/middleware.pri)
+include($$ROOT/server/prompts/prompts.pri)
+include($$ROOT/server/resources/resources.pri)
+include($$ROOT/server/tools/tools.pri)
+include($$ROOT/server/server.pri)
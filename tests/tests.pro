@@ -0,0 +1,8 @@
+# Standalone test and benchmark targets, no sockets involved
+#   qmake tests.pro && make && make check
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    bench_router \
+    soak_http_parser \
+    stress_sessions